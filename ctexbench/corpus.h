@@ -0,0 +1,469 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// corpus.h - Generated corpus of DDS/KTX files, shared by ctexbench and the fuzz target
+//      Every ddsktx_format is written in every shape that the writers accept: 2D with a full mip chain,
+//      cubemap, array, cubemap array and volume, both as DDS (DX10 header, or legacy FourCC/pixel masks when the
+//      format has no DXGI code) and KTX1. BC1-BC5 files are also rewritten with legacy FourCC headers
+//      (DXT1, DXT3, DXT5, ATI1, ATI2), and sRGB/BC6H signed variants are added where the containers have them
+//      KTX2 files are written here (dds-ktx.h has no KTX2 writer) for a subset of the formats in every shape,
+//      with plain, Zstandard and zlib levels. Supercompressed levels hold filler bytes, dds-ktx does not decode them
+//      Malformed files that the parsers must reject are kept apart, as regression inputs of past fuzz findings
+//      Pixel data is pseudo-random, the corpus is the same on every run
+//      Include dds-ktx.h with DDSKTX_IMPLEMENT before this file
+//
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CORPUS_MAX_MALFORMED 8
+
+typedef enum corpus_container
+{
+    CORPUS_DDS_FOURCC = 0,  // legacy header, FourCC or pixel masks
+    CORPUS_DDS_DX10,
+    CORPUS_KTX,
+    CORPUS_KTX2,
+    _CORPUS_CONTAINER_COUNT
+} corpus_container;
+
+typedef struct corpus_file
+{
+    uint8_t*         data;
+    size_t           size;
+    ddsktx_format    format;
+    unsigned int     flags;         // DDSKTX_TEXTURE_FLAG_SRGB/SIGNED of the written texture
+    corpus_container container;
+    char             name[64];      // container/format/shape, unique
+} corpus_file;
+
+typedef struct corpus
+{
+    corpus_file*    files;
+    int             num_files;
+    int             max_files;
+    size_t          total_size;
+    corpus_file     malformed[CORPUS_MAX_MALFORMED];    // not in 'files', the parsers must reject them
+    int             num_malformed;
+} corpus;
+
+static const char* k_corpus_container_names[_CORPUS_CONTAINER_COUNT] = { "dds-fourcc", "dds-dx10", "ktx", "ktx2" };
+
+typedef struct corpus__shape
+{
+    const char* name;
+    int         width;
+    int         height;
+    int         depth;
+    int         num_layers;
+    int         num_mips;       // 0: full mip chain
+    bool        cubemap;
+} corpus__shape;
+
+static const corpus__shape k_corpus_shapes[] = {
+    { "2d",        37, 23, 1, 1, 0, false },
+    { "2d-pot",    64, 64, 1, 1, 3, false },
+    { "cube",      16, 16, 1, 1, 5, true  },
+    { "array",     20, 12, 1, 3, 2, false },
+    { "cube-array", 8,  8, 1, 2, 4, true  },
+    { "volume",     9,  7, 5, 1, 3, false }
+};
+
+typedef struct corpus__buffer
+{
+    uint8_t*    data;
+    size_t      size;
+    size_t      capacity;
+} corpus__buffer;
+
+static bool corpus__write(const ddsktx_write_buffer* buffs, int num_buffs, void* user)
+{
+    corpus__buffer* b = (corpus__buffer*)user;
+    for (int i = 0; i < num_buffs; i++) {
+        size_t size = (size_t)buffs[i].size;
+        if (b->size + size > b->capacity) {
+            size_t capacity = b->capacity ? b->capacity : 4096;
+            while (capacity < b->size + size) {
+                capacity *= 2;
+            }
+            uint8_t* data = (uint8_t*)realloc(b->data, capacity);
+            if (!data) {
+                return false;
+            }
+            b->data = data;
+            b->capacity = capacity;
+        }
+        memcpy(b->data + b->size, buffs[i].data, size);
+        b->size += size;
+    }
+    return true;
+}
+
+static bool corpus__add(corpus* c, uint8_t* data, size_t size, ddsktx_format format, unsigned int flags,
+                        corpus_container container, const char* shape)
+{
+    if (c->num_files == c->max_files) {
+        int max_files = c->max_files ? c->max_files*2 : 256;
+        corpus_file* files = (corpus_file*)realloc(c->files, sizeof(corpus_file)*max_files);
+        if (!files) {
+            return false;
+        }
+        c->files = files;
+        c->max_files = max_files;
+    }
+
+    corpus_file* f = &c->files[c->num_files++];
+    f->data = data;
+    f->size = size;
+    f->format = format;
+    f->flags = flags;
+    f->container = container;
+    snprintf(f->name, sizeof(f->name), "%s/%s%s%s/%s", k_corpus_container_names[container],
+             ddsktx_format_str(format), (flags & DDSKTX_TEXTURE_FLAG_SRGB) ? "-srgb" : "",
+             (flags & DDSKTX_TEXTURE_FLAG_SIGNED) ? "-sf16" : "", shape);
+    c->total_size += size;
+    return true;
+}
+
+// VkFormat of the KTX2 files, from the Vulkan spec (not from the tables in dds-ktx.h)
+typedef struct corpus__ktx2_format
+{
+    ddsktx_format   format;
+    uint32_t        vk_format;
+} corpus__ktx2_format;
+
+static const corpus__ktx2_format k_corpus_ktx2_formats[] = {
+    { DDSKTX_FORMAT_RGBA8,    37  },    // VK_FORMAT_R8G8B8A8_UNORM
+    { DDSKTX_FORMAT_RGB8,     23  },    // VK_FORMAT_R8G8B8_UNORM
+    { DDSKTX_FORMAT_RGBA16F,  97  },    // VK_FORMAT_R16G16B16A16_SFLOAT
+    { DDSKTX_FORMAT_BC1,      133 },    // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+    { DDSKTX_FORMAT_BC7,      145 },    // VK_FORMAT_BC7_UNORM_BLOCK
+    { DDSKTX_FORMAT_ETC2,     147 },    // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+    { DDSKTX_FORMAT_ASTC6x6,  165 }     // VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+};
+
+// header(80) + level index, then the levels from the smallest mip. Plain levels start at lcm(texel block size, 4)
+// alignment, supercompressed levels hold a quarter of the level size in filler bytes from 'pixels'.
+// There is no DFD, dds-ktx does not read it
+static bool corpus__write_ktx2(const ddsktx_texture_info* tc, uint32_t vk_format, ddsktx_supercompression scheme,
+                               const uint8_t* pixels, corpus__buffer* b)
+{
+    static const uint8_t ktx2_id[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    enum { max_mips = 16 };
+    int num_images = tc->num_layers * (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP ? DDSKTX_CUBE_FACE_COUNT : 1) *
+                     tc->depth;
+    if (tc->num_mips > max_mips) {
+        return false;
+    }
+
+    int64_t block_size = ddsktx_calc_mip_size(tc->format, 1, 1, 0, NULL);
+    int64_t align = block_size;
+    while (align % 4 != 0) {
+        align += block_size;
+    }
+
+    uint64_t levels[max_mips][3];   // byteOffset, byteLength, uncompressedByteLength
+    int64_t mip_sizes[max_mips];
+    int64_t offset = 80 + tc->num_mips*24;
+    for (int mip = tc->num_mips - 1; mip >= 0; mip--) {
+        mip_sizes[mip] = ddsktx_calc_mip_size(tc->format, tc->width, tc->height, mip, NULL);
+        int64_t image_size = scheme == DDSKTX_SUPERCOMPRESSION_NONE ? mip_sizes[mip] : (mip_sizes[mip] + 3)/4;
+        if (scheme == DDSKTX_SUPERCOMPRESSION_NONE) {
+            offset = (offset + align - 1)/align*align;
+        }
+        levels[mip][0] = (uint64_t)offset;
+        levels[mip][1] = (uint64_t)(image_size*num_images);
+        levels[mip][2] = (uint64_t)(mip_sizes[mip]*num_images);
+        offset += image_size*num_images;
+    }
+
+    uint32_t header[17] = { vk_format, 1, (uint32_t)tc->width, (uint32_t)tc->height,
+                            tc->depth > 1 ? (uint32_t)tc->depth : 0, tc->num_layers > 1 ? (uint32_t)tc->num_layers : 0,
+                            tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP ? (uint32_t)DDSKTX_CUBE_FACE_COUNT : 1,
+                            (uint32_t)tc->num_mips, (uint32_t)scheme, 0, 0, 0, 0, 0, 0, 0, 0 };
+    ddsktx_write_buffer buffs[3] = { { ktx2_id, sizeof(ktx2_id) }, { header, sizeof(header) },
+                                     { levels, tc->num_mips*24 } };
+    if (!corpus__write(buffs, 3, b)) {
+        return false;
+    }
+
+    static const uint8_t padding[16] = {0};
+    for (int mip = tc->num_mips - 1; mip >= 0; mip--) {
+        ddsktx_write_buffer pad = { padding, (int64_t)levels[mip][0] - (int64_t)b->size };
+        ddsktx_write_buffer image = { pixels, (int64_t)levels[mip][1]/num_images };
+        if (!corpus__write(&pad, 1, b)) {
+            return false;
+        }
+        for (int i = 0; i < num_images; i++) {
+            if (!corpus__write(&image, 1, b)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void corpus__add_malformed(corpus* c, corpus__buffer* b, const char* name)
+{
+    ddsktx_assert(c->num_malformed < CORPUS_MAX_MALFORMED);
+    corpus_file* f = &c->malformed[c->num_malformed++];
+    memset(f, 0x0, sizeof(corpus_file));
+    f->data = b->data;
+    f->size = b->size;
+    f->container = CORPUS_KTX2;
+    snprintf(f->name, sizeof(f->name), "malformed/%s", name);
+}
+
+// zstd 2x2 RGBA8 with two levels, level 0 at offset 0xFFFFFFFFFFFFFFF0: offset + size wrapped around the
+// file size check
+static bool corpus__ktx2_level_offset_wrap(const uint8_t* pixels, corpus__buffer* b)
+{
+    ddsktx_texture_info tc;
+    memset(&tc, 0x0, sizeof(tc));
+    tc.format = DDSKTX_FORMAT_RGBA8;
+    tc.width = tc.height = 2;
+    tc.depth = tc.num_layers = 1;
+    tc.num_mips = 2;
+    if (!corpus__write_ktx2(&tc, 37, DDSKTX_SUPERCOMPRESSION_ZSTD, pixels, b)) {
+        return false;
+    }
+    const uint64_t level0[2] = { 0xFFFFFFFFFFFFFFF0ull, 0x20 };
+    memcpy(b->data + 80, level0, sizeof(level0));
+    return true;
+}
+
+// 1x1 RGBA8 with 'num_levels' levels of 4 bytes, more than the mip chain: level sizes shifted the width past 31
+static bool corpus__ktx2_levels(int num_levels, const uint8_t* pixels, corpus__buffer* b)
+{
+    ddsktx_texture_info tc;
+    memset(&tc, 0x0, sizeof(tc));
+    tc.format = DDSKTX_FORMAT_RGBA8;
+    tc.width = tc.height = tc.depth = tc.num_layers = tc.num_mips = 1;
+    corpus__buffer header = { NULL, 0, 0 };
+    if (!corpus__write_ktx2(&tc, 37, DDSKTX_SUPERCOMPRESSION_NONE, pixels, &header)) {
+        free(header.data);
+        return false;
+    }
+    uint32_t level_count = (uint32_t)num_levels;
+    memcpy(header.data + 40, &level_count, sizeof(level_count));
+
+    ddsktx_write_buffer buff = { header.data, 80 };
+    bool ok = corpus__write(&buff, 1, b);
+    for (int mip = 0; mip < num_levels && ok; mip++) {
+        uint64_t level[3] = { (uint64_t)(80 + num_levels*24 + (num_levels - 1 - mip)*4), 4, 4 };
+        buff.data = level;
+        buff.size = sizeof(level);
+        ok = corpus__write(&buff, 1, b);
+    }
+    for (int mip = 0; mip < num_levels && ok; mip++) {
+        buff.data = pixels;
+        buff.size = 4;
+        ok = corpus__write(&buff, 1, b);
+    }
+    free(header.data);
+    return ok;
+}
+
+#define CORPUS__FOURCC(_a, _b, _c, _d) \
+    ((uint32_t)(uint8_t)(_a) | ((uint32_t)(uint8_t)(_b) << 8) | ((uint32_t)(uint8_t)(_c) << 16) | ((uint32_t)(uint8_t)(_d) << 24))
+
+// rewrites a DX10 file of BC1-BC5 with the legacy FourCC header: magic(4) + header(124) + DX10 header(20)
+static uint8_t* corpus__legacy_fourcc(const uint8_t* dds, size_t size, ddsktx_format format, size_t* legacy_size)
+{
+    uint32_t fourcc;
+    switch (format) {
+    case DDSKTX_FORMAT_BC1:     fourcc = CORPUS__FOURCC('D', 'X', 'T', '1');    break;
+    case DDSKTX_FORMAT_BC2:     fourcc = CORPUS__FOURCC('D', 'X', 'T', '3');    break;
+    case DDSKTX_FORMAT_BC3:     fourcc = CORPUS__FOURCC('D', 'X', 'T', '5');    break;
+    case DDSKTX_FORMAT_BC4:     fourcc = CORPUS__FOURCC('A', 'T', 'I', '1');    break;
+    case DDSKTX_FORMAT_BC5:     fourcc = CORPUS__FOURCC('A', 'T', 'I', '2');    break;
+    default:                    return NULL;
+    }
+
+    uint8_t* data = (uint8_t*)malloc(size - 20);
+    if (!data) {
+        return NULL;
+    }
+    memcpy(data, dds, 128);
+    memcpy(data + 84, &fourcc, sizeof(fourcc));
+    memcpy(data + 128, dds + 148, size - 148);
+    *legacy_size = size - 20;
+    return data;
+}
+
+static void corpus_release(corpus* c)
+{
+    for (int i = 0; i < c->num_files; i++) {
+        free(c->files[i].data);
+    }
+    for (int i = 0; i < c->num_malformed; i++) {
+        free(c->malformed[i].data);
+    }
+    free(c->files);
+    memset(c, 0x0, sizeof(corpus));
+}
+
+// Returns false if it runs out of memory. Combinations that the writers reject are skipped
+static bool corpus_build(corpus* c)
+{
+    memset(c, 0x0, sizeof(corpus));
+
+    // all sub-images point to the same random data, which is large enough for the first mip of every shape
+    enum { max_sub_size = 64*64*16 };
+    uint8_t* pixels = (uint8_t*)malloc(max_sub_size);
+    if (!pixels) {
+        return false;
+    }
+    uint32_t seed = 0x2545f491;
+    for (int i = 0; i < max_sub_size; i++) {
+        seed = seed*1664525u + 1013904223u;
+        pixels[i] = (uint8_t)(seed >> 24);
+    }
+
+    int num_shapes = (int)(sizeof(k_corpus_shapes)/sizeof(corpus__shape));
+    for (int format = 0; format < _DDSKTX_FORMAT_COUNT; format++) {
+        if (format == _DDSKTX_FORMAT_COMPRESSED) {
+            continue;
+        }
+
+        static const unsigned int variants[] = { 0, DDSKTX_TEXTURE_FLAG_SRGB, DDSKTX_TEXTURE_FLAG_SIGNED };
+        for (int v = 0; v < 3; v++) {
+            unsigned int variant = variants[v];
+            if (variant == DDSKTX_TEXTURE_FLAG_SIGNED && format != DDSKTX_FORMAT_BC6H) {
+                continue;
+            }
+
+            for (int s = 0; s < num_shapes; s++) {
+                const corpus__shape* shape = &k_corpus_shapes[s];
+                // variants are only written as 2D
+                if (variant && s > 0) {
+                    break;
+                }
+
+                ddsktx_texture_info tc;
+                memset(&tc, 0x0, sizeof(tc));
+                tc.format = (ddsktx_format)format;
+                tc.flags = variant | (shape->cubemap ? DDSKTX_TEXTURE_FLAG_CUBEMAP : 0);
+                tc.width = shape->width;
+                tc.height = shape->height;
+                tc.depth = shape->depth;
+                tc.num_layers = shape->num_layers;
+                tc.num_mips = shape->num_mips;
+                if (tc.num_mips == 0) {
+                    for (int dim = shape->width > shape->height ? shape->width : shape->height; dim > 0; dim >>= 1) {
+                        tc.num_mips++;
+                    }
+                }
+
+                int num_subs = ddsktx_num_subresources(&tc);
+                const void** subs = (const void**)malloc(sizeof(void*)*num_subs);
+                if (!subs) {
+                    free(pixels);
+                    return false;
+                }
+                for (int i = 0; i < num_subs; i++) {
+                    subs[i] = pixels;
+                }
+
+                for (int k = 0; k < 2; k++) {
+                    corpus__buffer b = { NULL, 0, 0 };
+                    bool ok = k == 0 ? ddsktx_write_dds(&tc, subs, corpus__write, &b, NULL) :
+                                       ddsktx_write_ktx(&tc, subs, corpus__write, &b, NULL);
+                    if (!ok) {
+                        free(b.data);
+                        continue;
+                    }
+
+                    corpus_container container = CORPUS_KTX;
+                    if (k == 0) {
+                        uint32_t fourcc;
+                        memcpy(&fourcc, b.data + 84, sizeof(fourcc));
+                        container = fourcc == CORPUS__FOURCC('D', 'X', '1', '0') ? CORPUS_DDS_DX10 : CORPUS_DDS_FOURCC;
+                    }
+                    if (!corpus__add(c, b.data, b.size, tc.format, variant, container, shape->name)) {
+                        free(b.data);
+                        free(subs);
+                        free(pixels);
+                        return false;
+                    }
+
+                    // FourCC headers have no arrays and no sRGB or signed variants
+                    if (container == CORPUS_DDS_DX10 && tc.num_layers == 1 && variant == 0) {
+                        size_t legacy_size;
+                        uint8_t* legacy = corpus__legacy_fourcc(b.data, b.size, tc.format, &legacy_size);
+                        if (legacy && !corpus__add(c, legacy, legacy_size, tc.format, 0, CORPUS_DDS_FOURCC, shape->name)) {
+                            free(legacy);
+                            free(subs);
+                            free(pixels);
+                            return false;
+                        }
+                    }
+                }
+                free(subs);
+            }
+        }
+    }
+
+    static const ddsktx_supercompression schemes[] = {
+        DDSKTX_SUPERCOMPRESSION_NONE, DDSKTX_SUPERCOMPRESSION_ZSTD, DDSKTX_SUPERCOMPRESSION_ZLIB
+    };
+    static const char* scheme_names[] = { "", "-zstd", "-zlib" };
+    int num_ktx2_formats = (int)(sizeof(k_corpus_ktx2_formats)/sizeof(corpus__ktx2_format));
+    for (int k = 0; k < num_ktx2_formats; k++) {
+        for (int s = 0; s < num_shapes; s++) {
+            const corpus__shape* shape = &k_corpus_shapes[s];
+            ddsktx_texture_info tc;
+            memset(&tc, 0x0, sizeof(tc));
+            tc.format = k_corpus_ktx2_formats[k].format;
+            tc.flags = shape->cubemap ? DDSKTX_TEXTURE_FLAG_CUBEMAP : 0;
+            tc.width = shape->width;
+            tc.height = shape->height;
+            tc.depth = shape->depth;
+            tc.num_layers = shape->num_layers;
+            tc.num_mips = shape->num_mips;
+            if (tc.num_mips == 0) {
+                for (int dim = shape->width > shape->height ? shape->width : shape->height; dim > 0; dim >>= 1) {
+                    tc.num_mips++;
+                }
+            }
+
+            for (int m = 0; m < 3; m++) {
+                corpus__buffer b = { NULL, 0, 0 };
+                char name[32];
+                snprintf(name, sizeof(name), "%s%s", shape->name, scheme_names[m]);
+                if (!corpus__write_ktx2(&tc, k_corpus_ktx2_formats[k].vk_format, schemes[m], pixels, &b) ||
+                    !corpus__add(c, b.data, b.size, tc.format, 0, CORPUS_KTX2, name))
+                {
+                    free(b.data);
+                    free(pixels);
+                    return false;
+                }
+            }
+        }
+    }
+
+    corpus__buffer b = { NULL, 0, 0 };
+    if (!corpus__ktx2_level_offset_wrap(pixels, &b)) {
+        free(b.data);
+        free(pixels);
+        return false;
+    }
+    corpus__add_malformed(c, &b, "level-offset-wrap");
+    for (int k = 0; k < 2; k++) {
+        static const int num_levels[2] = { 33, 40 };
+        static const char* names[2] = { "levels-33", "levels-40" };
+        corpus__buffer lb = { NULL, 0, 0 };
+        if (!corpus__ktx2_levels(num_levels[k], pixels, &lb)) {
+            free(lb.data);
+            free(pixels);
+            return false;
+        }
+        corpus__add_malformed(c, &lb, names[k]);
+    }
+
+    free(pixels);
+    return true;
+}
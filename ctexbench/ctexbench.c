@@ -0,0 +1,1072 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// ctexbench.c - Benchmark of the parsers and sub-image lookups over a generated corpus (see corpus.h)
+//      Times ddsktx_parse64, ddsktx_parse_strict and the enumeration of all sub-images with ddsktx_get_sub64
+//      (ddsktx_get_level_range for supercompressed KTX2 levels), with and without DDSKTX_TEXTURE_FLAG_VALIDATED,
+//      for each container. Every timing is the fastest of all passes over the corpus
+//      Bytes touched are counted once through a ddsktx_reader: header bytes that the parser reads for each file,
+//      bytes that each lookup reads besides the sub-image (KTX imageSize fields), and the sub-image data
+//      Parallel throughput: the corpus is split to contiguous ranges and parsed with ddsktx_parse_batch on
+//      1, 2, 4 ... N threads, reported as files/s, wall ns/file and speedup over one thread
+//
+//      Build:
+//          Windows: cl ctexbench.c /O2
+//          Linux:   gcc ctexbench.c -O2 -lpthread -lm -o ctexbench
+//          MacOS:   clang ctexbench.c -O2 -o ctexbench
+//
+//      Usage: ctexbench [options]
+//          -r, --repeat N      number of timed passes over the corpus (default: 50)
+//          -t, --threads N     maximum number of threads of the ddsktx_parse_batch test (default: number of
+//                              cores, 0 skips the test)
+//          -c, --check         check the corpus first: every file parses with ddsktx_parse_strict to the format
+//                              it was written with and keeps the sRGB flag, sRGB KTX files carry the right
+//                              glInternalFormat, KTX files have the right glType and glTypeSize, every
+//                              format and container is covered, supercompressed levels are inside the file,
+//                              malformed files are rejected, tile spans match the blocks of ddsktx_get_sub,
+//                              ddsktx_swizzle_sub matches per-element addresses, and ETC/ASTC transcode to BC1/BC3/BC7
+//                              (with a quality bound on valid ASTC images). Exits with an error if a check fails
+//
+
+#if defined(_WIN32) || defined(_WIN64)
+#   define _CRT_SECURE_NO_WARNINGS
+#elif !defined(_POSIX_C_SOURCE)
+#   define _POSIX_C_SOURCE 200112L
+#endif
+
+#define DDSKTX_IMPLEMENT
+#include "../dds-ktx.h"
+#include "corpus.h"
+
+#include <inttypes.h>
+#include <math.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <time.h>
+#   include <unistd.h>
+#endif
+
+#define DEFAULT_REPEAT 50
+#define MAX_THREADS 64
+#define BATCH_ROUNDS 16     // parses of the corpus in each pass of the ddsktx_parse_batch test
+
+static uint64_t now_ns(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// threads
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE bench_thread;
+
+static DWORD WINAPI thread_entry(LPVOID arg);
+
+static bool thread_start(bench_thread* thrd, void* arg)
+{
+    *thrd = CreateThread(NULL, 0, thread_entry, arg, 0, NULL);
+    return *thrd != NULL;
+}
+
+static void thread_join(bench_thread thrd)
+{
+    WaitForSingleObject(thrd, INFINITE);
+    CloseHandle(thrd);
+}
+
+static int num_cores(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t bench_thread;
+
+static void* thread_entry(void* arg);
+
+static bool thread_start(bench_thread* thrd, void* arg)
+{
+    return pthread_create(thrd, NULL, thread_entry, arg) == 0;
+}
+
+static void thread_join(bench_thread thrd)
+{
+    pthread_join(thrd, NULL);
+}
+
+static int num_cores(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// bytes touched
+typedef struct counting_reader
+{
+    const uint8_t*  data;
+    int64_t         size;
+    int64_t         bytes_read;
+} counting_reader;
+
+static int64_t counting_read(void* user, int64_t offset, void* buff, int64_t size)
+{
+    counting_reader* r = (counting_reader*)user;
+    if (offset < 0 || offset >= r->size) {
+        return 0;
+    }
+    int64_t count = size < r->size - offset ? size : r->size - offset;
+    memcpy(buff, r->data + offset, (size_t)count);
+    r->bytes_read += count;
+    return count;
+}
+
+static int64_t counting_size(void* user)
+{
+    return ((counting_reader*)user)->size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct bench_stats
+{
+    int         num_files;
+    int64_t     num_subs;
+    int64_t     header_bytes;       // read by the parser
+    int64_t     lookup_bytes;       // read by the lookups, besides the sub-images
+    int64_t     data_bytes;         // sub-image data
+    uint64_t    parse_ns;           // fastest pass
+    uint64_t    strict_ns;
+    uint64_t    sub_ns;
+    uint64_t    sub_validated_ns;
+} bench_stats;
+
+typedef struct batch_job
+{
+    int         first;
+    int         count;
+    int         num_parsed;
+} batch_job;
+
+typedef struct bench_state
+{
+    corpus              files;
+    ddsktx_texture_info* infos;           // ddsktx_parse64
+    ddsktx_texture_info* infos_validated; // ddsktx_parse_strict
+    ddsktx_blob*        blobs;            // ddsktx_parse_batch
+    ddsktx_texture_info* infos_batch;
+    ddsktx_result*      results_batch;
+    bench_stats         stats[_CORPUS_CONTAINER_COUNT + 1];     // last one is the total
+    int                 repeat;
+    int                 num_threads;
+    bool                check;
+} bench_state;
+
+static bench_state g_bench;
+static volatile uintptr_t g_sink;
+
+static int num_errors;
+
+static void check_failed(const corpus_file* f, const char* msg)
+{
+    printf("check failed: %s: %s\n", f ? f->name : "corpus", msg);
+    num_errors++;
+}
+
+// supercompressed levels have no sub-images in the file, their ranges are looked up instead
+static bool for_each_sub(const ddsktx_texture_info* tc, const corpus_file* f, uintptr_t* sink)
+{
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+        bool ok = true;
+        for (int mip = 0; mip < tc->num_mips; mip++) {
+            ddsktx_file_range range = { 0, 0 };
+            ok &= ddsktx_get_level_range(tc, f->data, f->size, mip, &range, NULL) && range.offset >= 0 &&
+                  range.size <= (int64_t)f->size - range.offset;
+            *sink += (uintptr_t)range.offset;
+        }
+        return ok;
+    }
+
+    int num_slices = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : tc->depth;
+    bool ok = true;
+    for (int layer = 0; layer < tc->num_layers; layer++) {
+        for (int slice = 0; slice < num_slices; slice++) {
+            for (int mip = 0; mip < tc->num_mips; mip++) {
+                ddsktx_sub_data sub;
+                ddsktx_get_sub64(tc, &sub, f->data, f->size, layer, slice, mip);
+                *sink += (uintptr_t)sub.buff;
+                ok &= sub.buff != NULL;
+            }
+        }
+    }
+    return ok;
+}
+
+// every sRGB-capable format, the glInternalFormat that KTX files must carry (from the GL/extension specs,
+// not from the tables in dds-ktx.h) and whether DDS has a DXGI sRGB code for it
+typedef struct srgb_format
+{
+    ddsktx_format   format;
+    uint32_t        gl_internal_format;
+    bool            dds;
+} srgb_format;
+
+static const srgb_format k_srgb_formats[] = {
+    { DDSKTX_FORMAT_BC1,      0x8C4D, true  },    // COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+    { DDSKTX_FORMAT_BC2,      0x8C4E, true  },    // COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT
+    { DDSKTX_FORMAT_BC3,      0x8C4F, true  },    // COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+    { DDSKTX_FORMAT_BC7,      0x8E8D, true  },    // COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+    { DDSKTX_FORMAT_ETC2,     0x9275, false },    // COMPRESSED_SRGB8_ETC2
+    { DDSKTX_FORMAT_ETC2A,    0x9279, false },    // COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+    { DDSKTX_FORMAT_ETC2A1,   0x9277, false },    // COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2
+    { DDSKTX_FORMAT_PTC12,    0x8A54, false },    // COMPRESSED_SRGB_PVRTC_2BPPV1_EXT
+    { DDSKTX_FORMAT_PTC14,    0x8A55, false },    // COMPRESSED_SRGB_PVRTC_4BPPV1_EXT
+    { DDSKTX_FORMAT_PTC12A,   0x8A56, false },    // COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT
+    { DDSKTX_FORMAT_PTC14A,   0x8A57, false },    // COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT
+    { DDSKTX_FORMAT_ASTC4x4,  0x93D0, false },    // COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+    { DDSKTX_FORMAT_ASTC5x5,  0x93D2, false },
+    { DDSKTX_FORMAT_ASTC6x6,  0x93D4, false },
+    { DDSKTX_FORMAT_ASTC8x5,  0x93D5, false },
+    { DDSKTX_FORMAT_ASTC8x6,  0x93D6, false },
+    { DDSKTX_FORMAT_ASTC10x5, 0x93D8, false },
+    { DDSKTX_FORMAT_RGBA8,    0x8C43, true  },    // SRGB8_ALPHA8
+    { DDSKTX_FORMAT_BGRA8,    0x8C43, true  },    // SRGB8_ALPHA8 with glFormat BGRA
+    { DDSKTX_FORMAT_RGB8,     0x8C41, false }     // SRGB8
+};
+
+static uint32_t read_u32(const uint8_t* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// sRGB files must round trip through the writers and the parsers: KTX files carry the expected
+// glInternalFormat, and there is a file in every container that can store the format as sRGB
+static void check_srgb(void)
+{
+    const corpus* c = &g_bench.files;
+    int num_srgb_formats = (int)(sizeof(k_srgb_formats)/sizeof(srgb_format));
+    for (int k = 0; k < num_srgb_formats; k++) {
+        const srgb_format* sf = &k_srgb_formats[k];
+        bool ktx_found = false, dds_found = false;
+        for (int i = 0; i < c->num_files; i++) {
+            const corpus_file* f = &c->files[i];
+            if (f->format != sf->format || !(f->flags & DDSKTX_TEXTURE_FLAG_SRGB)) {
+                continue;
+            }
+            if (f->container == CORPUS_KTX) {
+                ktx_found = true;
+                if (read_u32(f->data + 28) != sf->gl_internal_format) {
+                    check_failed(f, "wrong sRGB glInternalFormat");
+                }
+                if (sf->format == DDSKTX_FORMAT_BGRA8 && read_u32(f->data + 24) != 0x80E1) {
+                    check_failed(f, "glFormat is not BGRA");
+                }
+            } else {
+                dds_found = true;
+            }
+        }
+
+        char msg[64];
+        if (!ktx_found) {
+            snprintf(msg, sizeof(msg), "no ktx sRGB files of format %s", ddsktx_format_str(sf->format));
+            check_failed(NULL, msg);
+        }
+        if (sf->dds != dds_found) {
+            snprintf(msg, sizeof(msg), "%s dds sRGB files of format %s", sf->dds ? "no" : "unexpected",
+                     ddsktx_format_str(sf->format));
+            check_failed(NULL, msg);
+        }
+    }
+}
+
+// glType and glTypeSize of the uncompressed formats, from the GL specs. Compressed formats have glType 0
+// and glTypeSize 1
+typedef struct ktx_type
+{
+    ddsktx_format   format;
+    uint32_t        gl_type;
+    uint32_t        gl_type_size;
+} ktx_type;
+
+static const ktx_type k_ktx_types[] = {
+    { DDSKTX_FORMAT_A8,       0x1401, 1 },    // UNSIGNED_BYTE
+    { DDSKTX_FORMAT_R8,       0x1401, 1 },
+    { DDSKTX_FORMAT_RGBA8,    0x1401, 1 },
+    { DDSKTX_FORMAT_RGBA8S,   0x1400, 1 },    // BYTE
+    { DDSKTX_FORMAT_RG16,     0x1403, 2 },    // UNSIGNED_SHORT
+    { DDSKTX_FORMAT_RGB8,     0x1401, 1 },
+    { DDSKTX_FORMAT_R16,      0x1403, 2 },
+    { DDSKTX_FORMAT_R32F,     0x1406, 4 },    // FLOAT
+    { DDSKTX_FORMAT_R16F,     0x140B, 2 },    // HALF_FLOAT
+    { DDSKTX_FORMAT_RG16F,    0x140B, 2 },
+    { DDSKTX_FORMAT_RG16S,    0x1402, 2 },    // SHORT
+    { DDSKTX_FORMAT_RGBA16F,  0x140B, 2 },
+    { DDSKTX_FORMAT_RGBA16,   0x1403, 2 },
+    { DDSKTX_FORMAT_BGRA8,    0x1401, 1 },
+    { DDSKTX_FORMAT_RGB10A2,  0x8368, 4 },    // UNSIGNED_INT_2_10_10_10_REV
+    { DDSKTX_FORMAT_RG11B10F, 0x8C3B, 4 },    // UNSIGNED_INT_10F_11F_11F_REV
+    { DDSKTX_FORMAT_RG8,      0x1401, 1 },
+    { DDSKTX_FORMAT_RG8S,     0x1400, 1 }
+};
+
+// KTX writers must fill glType and glTypeSize, loaders use them to upload and to swap the endianness
+static void check_ktx_type(const corpus_file* f)
+{
+    uint32_t gl_type = 0, gl_type_size = 1;
+    int num_types = (int)(sizeof(k_ktx_types)/sizeof(ktx_type));
+    for (int k = 0; k < num_types; k++) {
+        if (k_ktx_types[k].format == f->format) {
+            gl_type = k_ktx_types[k].gl_type;
+            gl_type_size = k_ktx_types[k].gl_type_size;
+            break;
+        }
+    }
+    if (read_u32(f->data + 16) != gl_type) {
+        check_failed(f, "wrong glType");
+    }
+    if (read_u32(f->data + 20) != gl_type_size) {
+        check_failed(f, "wrong glTypeSize");
+    }
+}
+
+// PSNR of the first mip of 'tc' transcoded to 'dst_format' and decoded, against the decoded source
+static double transcode_psnr(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_format dst_format)
+{
+    int w = sub->width, h = sub->height;
+    int num_blocks_x = (w + 3)/4, num_blocks_y = (h + 3)/4;
+    int block_size = dst_format == DDSKTX_FORMAT_BC1 ? 8 : 16;
+    uint8_t* src_rgba = (uint8_t*)malloc((size_t)w*h*4);
+    uint8_t* dst_rgba = (uint8_t*)malloc((size_t)w*h*4);
+    uint8_t* blocks = (uint8_t*)malloc((size_t)num_blocks_x*num_blocks_y*block_size);
+    if (!src_rgba || !dst_rgba || !blocks) {
+        puts("Error: out of memory");
+        exit(-1);
+    }
+
+    double psnr = -1.0;
+    ddsktx_texture_info dst_tc;
+    memset(&dst_tc, 0x0, sizeof(dst_tc));
+    dst_tc.format = dst_format;
+    ddsktx_sub_data dst_sub = { blocks, w, h, (int64_t)num_blocks_x*num_blocks_y*block_size, num_blocks_x*block_size };
+    if (ddsktx_decode_blocks(tc, sub, src_rgba, w*4, 0, (int)(sub->size_bytes / sub->row_pitch_bytes)) &&
+        ddsktx_transcode_blocks(tc, sub, dst_format, blocks, dst_sub.row_pitch_bytes, 0, num_blocks_y) &&
+        ddsktx_decode_blocks(&dst_tc, &dst_sub, dst_rgba, w*4, 0, num_blocks_y))
+    {
+        double err = 0.0;
+        for (int i = 0; i < w*h*4; i++) {
+            double d = (double)src_rgba[i] - (double)dst_rgba[i];
+            err += d*d;
+        }
+        err /= (double)w*h*4;
+        psnr = err > 0.0 ? 10.0*log10(255.0*255.0/err) : 99.0;
+    }
+
+    free(blocks);
+    free(dst_rgba);
+    free(src_rgba);
+    return psnr;
+}
+
+// the first mip of every ETC/ASTC file is transcoded to BC1, BC3 and BC7. The corpus is random data, too noisy for
+// a quality bound and mostly invalid blocks for ASTC, so quality is checked with valid ASTC images: void-extent
+// blocks on a color line and ramp blocks in a checkerboard, which catches pixels gathered from the wrong places
+static void check_transcode(void)
+{
+    static const ddsktx_format dst_formats[] = { DDSKTX_FORMAT_BC1, DDSKTX_FORMAT_BC3, DDSKTX_FORMAT_BC7 };
+    const corpus* c = &g_bench.files;
+    for (int i = 0; i < c->num_files; i++) {
+        const corpus_file* f = &c->files[i];
+        const ddsktx_texture_info* tc = &g_bench.infos_validated[i];
+        if (ddsktx_transcode_format(f->format) == _DDSKTX_FORMAT_COUNT || tc->format != f->format ||
+            tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE)
+        {
+            continue;
+        }
+        ddsktx_sub_data sub;
+        ddsktx_get_sub64(tc, &sub, f->data, f->size, 0, 0, 0);
+        for (int k = 0; k < 3; k++) {
+            if (transcode_psnr(tc, &sub, dst_formats[k]) < 0.0) {
+                char msg[64];
+                snprintf(msg, sizeof(msg), "transcoding to %s failed", ddsktx_format_str(dst_formats[k]));
+                check_failed(f, msg);
+            }
+        }
+    }
+
+    static const struct { ddsktx_format format; int bw, bh; } astc_formats[] = {
+        { DDSKTX_FORMAT_ASTC4x4, 4, 4 }, { DDSKTX_FORMAT_ASTC5x5, 5, 5 }, { DDSKTX_FORMAT_ASTC6x6, 6, 6 },
+        { DDSKTX_FORMAT_ASTC8x5, 8, 5 }, { DDSKTX_FORMAT_ASTC8x6, 8, 6 }, { DDSKTX_FORMAT_ASTC10x5, 10, 5 }
+    };
+    for (int k = 0; k < 6; k++) {
+        ddsktx_texture_info tc;
+        memset(&tc, 0x0, sizeof(tc));
+        tc.format = astc_formats[k].format;
+        tc.width = 37;
+        tc.height = 23;
+        int bw = astc_formats[k].bw, bh = astc_formats[k].bh;
+        int num_blocks_x = (tc.width + bw - 1)/bw, num_blocks_y = (tc.height + bh - 1)/bh;
+        uint8_t* blocks = (uint8_t*)malloc((size_t)num_blocks_x*num_blocks_y*16);
+        if (!blocks) {
+            puts("Error: out of memory");
+            exit(-1);
+        }
+        for (int b = 0; b < num_blocks_x*num_blocks_y; b++) {
+            int x = b % num_blocks_x, y = b / num_blocks_x;
+            if ((x + y) & 1) {
+                // single partition, CEM 8 (RGB direct) from (20, 40, 200) to (230, 180, 30), 4x2 grid of 3 bit
+                // weights that ramp from left to right, valid for every 2D footprint
+                static const uint8_t ramp[16] = { 0x13, 0x00, 0x29, 0xcc, 0x51, 0x68, 0x91, 0x3d,
+                                                  0x00, 0x00, 0x00, 0x00, 0x00, 0xaf, 0xf0, 0x0a };
+                memcpy(blocks + b*16, ramp, 16);
+                continue;
+            }
+            // LDR void-extent block without extents, RGBA16 color that decodes to (t, t/2 + 64, 255 - t, 255)
+            static const uint8_t header[8] = { 0xfc, 0xfd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+            int t = (x + y)*255/(num_blocks_x + num_blocks_y - 2);
+            uint16_t color[4] = { (uint16_t)(t*257), (uint16_t)((t/2 + 64)*257), (uint16_t)((255 - t)*257), 0xffff };
+            memcpy(blocks + b*16, header, 8);
+            memcpy(blocks + b*16 + 8, color, 8);
+        }
+
+        ddsktx_sub_data sub = { blocks, tc.width, tc.height, (int64_t)num_blocks_x*num_blocks_y*16, num_blocks_x*16 };
+
+        // the first void-extent block and the ends of the first ramp, linear and sRGB endpoints both keep 8 bits
+        uint8_t rows[37*4*6];   // one block row
+        static const uint8_t expected[3][4] = { { 0, 64, 255, 255 }, { 20, 40, 200, 255 }, { 230, 180, 30, 255 } };
+        for (int srgb = 0; srgb < 2; srgb++) {
+            tc.flags = srgb ? DDSKTX_TEXTURE_FLAG_SRGB : 0;
+            if (!ddsktx_decode_blocks(&tc, &sub, rows, 37*4, 0, 1) || memcmp(rows, expected[0], 4) != 0 ||
+                memcmp(rows + bw*4, expected[1], 4) != 0 || memcmp(rows + (bw*2 - 1)*4, expected[2], 4) != 0)
+            {
+                char msg[64];
+                snprintf(msg, sizeof(msg), "wrong %s%s colors", ddsktx_format_str(tc.format), srgb ? " sRGB" : "");
+                check_failed(NULL, msg);
+            }
+        }
+        tc.flags = 0;
+
+        static const double min_psnr[3] = { 22.0, 22.0, 25.0 };     // dB, blocks gathered from wrong places are below 17
+        for (int d = 0; d < 3; d++) {
+            double psnr = transcode_psnr(&tc, &sub, dst_formats[d]);
+            if (psnr < min_psnr[d]) {
+                char msg[96];
+                snprintf(msg, sizeof(msg), "transcoding an %s image to %s: %.1f dB",
+                         ddsktx_format_str(tc.format), ddsktx_format_str(dst_formats[d]), psnr);
+                check_failed(NULL, msg);
+            }
+        }
+        free(blocks);
+    }
+}
+
+// block dimensions from the format specs, PVRTC is not stored in block rows and has no tile spans
+static bool block_dims(ddsktx_format format, int* bw, int* bh)
+{
+    *bw = *bh = ddsktx_format_compressed(format) ? 4 : 1;
+    switch (format) {
+    case DDSKTX_FORMAT_PTC12: case DDSKTX_FORMAT_PTC14: case DDSKTX_FORMAT_PTC12A:
+    case DDSKTX_FORMAT_PTC14A: case DDSKTX_FORMAT_PTC22: case DDSKTX_FORMAT_PTC24:
+        return false;
+    case DDSKTX_FORMAT_ASTC5x5:     *bw = 5;  *bh = 5;  break;
+    case DDSKTX_FORMAT_ASTC6x6:     *bw = 6;  *bh = 6;  break;
+    case DDSKTX_FORMAT_ASTC8x5:     *bw = 8;  *bh = 5;  break;
+    case DDSKTX_FORMAT_ASTC8x6:     *bw = 8;  *bh = 6;  break;
+    case DDSKTX_FORMAT_ASTC10x5:    *bw = 10; *bh = 5;  break;
+    default:                        break;
+    }
+    return true;
+}
+
+// tiles read from the file through ddsktx_get_tile_spans must be the blocks of the rectangle, gathered one by one from
+// ddsktx_get_sub. Rectangles are unaligned, and clipped to the mip or outside of it
+static void check_tile_spans(const corpus_file* f, const ddsktx_texture_info* tc, uint8_t* tile, uint8_t* expected)
+{
+    int bw, bh;
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE || !block_dims(tc->format, &bw, &bh)) {
+        return;
+    }
+    int block_size = (int)ddsktx_calc_mip_size(tc->format, 1, 1, 0, NULL);
+
+    for (int mip = 0; mip < tc->num_mips; mip++) {
+        ddsktx_sub_data sub;
+        ddsktx_get_sub64(tc, &sub, f->data, f->size, 0, 0, mip);
+        int64_t sub_offset = (const uint8_t*)sub.buff - f->data;
+        int w = sub.width, h = sub.height;
+        const ddsktx_rect rects[5] = {
+            { w/3, h/3, 5, 5 }, { -3, -2, w/2 + 4, h + 9 }, { 0, 0, w, h }, { w - 1, h - 1, 7, 3 }, { w, 0, 4, 4 }
+        };
+        for (int r = 0; r < 5; r++) {
+            int x0 = rects[r].x > 0 ? rects[r].x : 0;
+            int y0 = rects[r].y > 0 ? rects[r].y : 0;
+            int x1 = rects[r].x + rects[r].width < w ? rects[r].x + rects[r].width : w;
+            int y1 = rects[r].y + rects[r].height < h ? rects[r].y + rects[r].height : h;
+            ddsktx_rect aligned = { 0, 0, 0, 0 };
+            ddsktx_file_range spans[256];
+            int num_spans = ddsktx_get_tile_spans(tc, &sub, rects[r].x, rects[r].y, rects[r].width, rects[r].height,
+                                                  &aligned, spans, 256);
+            if (x0 >= x1 || y0 >= y1) {
+                if (num_spans != 0) {
+                    check_failed(f, "tile spans of a rectangle outside the mip");
+                }
+                continue;
+            }
+
+            int bx0 = x0/bw, by0 = y0/bh, bx1 = (x1 + bw - 1)/bw, by1 = (y1 + bh - 1)/bh;
+            if (aligned.x != bx0*bw || aligned.y != by0*bh || aligned.width != (bx1 - bx0)*bw ||
+                aligned.height != (by1 - by0)*bh || num_spans < 1 || num_spans > by1 - by0 ||
+                ddsktx_get_tile_spans(tc, &sub, rects[r].x, rects[r].y, rects[r].width, rects[r].height,
+                                      NULL, NULL, 0) != num_spans)
+            {
+                check_failed(f, "wrong tile rectangle or span count");
+                continue;
+            }
+
+            size_t size = 0;
+            for (int by = by0; by < by1; by++) {
+                for (int bx = bx0; bx < bx1; bx++) {
+                    const uint8_t* block = (const uint8_t*)sub.buff + (int64_t)by*sub.row_pitch_bytes + bx*block_size;
+                    memcpy(expected + size, block, (size_t)block_size);
+                    size += block_size;
+                }
+            }
+            size_t tile_size = 0;
+            bool ok = true;
+            for (int i = 0; i < num_spans && ok; i++) {
+                ok = spans[i].offset >= 0 && spans[i].offset + spans[i].size <= sub.size_bytes &&
+                     tile_size + (size_t)spans[i].size <= size;
+                if (ok) {
+                    memcpy(tile + tile_size, f->data + sub_offset + spans[i].offset, (size_t)spans[i].size);
+                    tile_size += (size_t)spans[i].size;
+                }
+            }
+            if (!ok || tile_size != size || memcmp(tile, expected, size) != 0) {
+                check_failed(f, "tile spans do not match the sub-image");
+            }
+        }
+    }
+}
+
+// address bits of D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE 2D tiles, from bit 0 ('0': byte inside the element,
+// X/Y: next bit of the element x/y), for elements of 1, 2, 4, 8 and 16 bytes, from the D3D12 spec
+static const char* k_standard_swizzle[5] = {
+    "XXXXYYYYXYXYXYXY", "0XXXYYYXYXYXYXYX", "00XXYYXYXYXYXYXY", "000XYYXXYXYXYXYX", "0000YXYXXYXYXYXY"
+};
+
+static uint64_t deposit(uint64_t value, uint64_t mask)
+{
+    uint64_t r = 0;
+    for (int bit = 0; bit < 64; bit++) {
+        if (mask & (1ull << bit)) {
+            r |= (value & 1) << bit;
+            value >>= 1;
+        }
+    }
+    return r;
+}
+
+static int ceil_log2(int n)
+{
+    int r = 0;
+    while ((1 << r) < n) {
+        r++;
+    }
+    return r;
+}
+
+// every element is written to its address, computed on its own: tile offset + deposit(x) + deposit(y). The rest of
+// the layout must be zero. Both layouts, every element size, and images that are smaller or larger than one tile
+static void check_swizzle(void)
+{
+    static const ddsktx_format formats[5] = {
+        DDSKTX_FORMAT_R8, DDSKTX_FORMAT_RG8, DDSKTX_FORMAT_RGBA8, DDSKTX_FORMAT_BC1, DDSKTX_FORMAT_BC7
+    };
+    static const int sizes[4][2] = { { 37, 23 }, { 300, 140 }, { 1, 1 }, { 520, 9 } };
+    for (int k = 0; k < 5; k++) {
+        for (int i = 0; i < 4; i++) {
+            ddsktx_texture_info tc;
+            memset(&tc, 0x0, sizeof(tc));
+            tc.format = formats[k];
+            tc.width = sizes[i][0];
+            tc.height = sizes[i][1];
+            int row_bytes;
+            int64_t size_bytes = ddsktx_calc_mip_size(tc.format, tc.width, tc.height, 0, &row_bytes);
+            int elem_size = 1 << k;
+            int blocks_x = row_bytes / elem_size, blocks_y = (int)(size_bytes / row_bytes);
+            uint8_t* src = (uint8_t*)malloc((size_t)size_bytes);
+            if (!src) {
+                puts("Error: out of memory");
+                exit(-1);
+            }
+            uint32_t seed = 0x6d2b79f5u + (uint32_t)(k*4 + i);
+            for (int64_t b = 0; b < size_bytes; b++) {
+                seed = seed*1664525u + 1013904223u;
+                src[b] = (uint8_t)(seed >> 24);
+            }
+            ddsktx_sub_data sub = { src, tc.width, tc.height, size_bytes, row_bytes };
+
+            for (int mode = 0; mode < _DDSKTX_SWIZZLE_COUNT; mode++) {
+                uint64_t x_mask = 0, y_mask = 0;
+                int tile_w, tile_h;
+                int64_t tile_size;
+                if (mode == DDSKTX_SWIZZLE_MORTON) {
+                    int bits_x = ceil_log2(blocks_x), bits_y = ceil_log2(blocks_y);
+                    int bit = k;
+                    for (int b = 0; b < bits_x || b < bits_y; b++) {
+                        x_mask |= b < bits_x ? 1ull << bit++ : 0;
+                        y_mask |= b < bits_y ? 1ull << bit++ : 0;
+                    }
+                    tile_w = 1 << bits_x;
+                    tile_h = 1 << bits_y;
+                    tile_size = 1ll << bit;
+                } else {
+                    int bits_x = 0, bits_y = 0;
+                    for (int bit = 0; bit < 16; bit++) {
+                        if (k_standard_swizzle[k][bit] == 'X') {
+                            x_mask |= 1ull << bit;
+                            bits_x++;
+                        } else if (k_standard_swizzle[k][bit] == 'Y') {
+                            y_mask |= 1ull << bit;
+                            bits_y++;
+                        }
+                    }
+                    tile_w = 1 << bits_x;
+                    tile_h = 1 << bits_y;
+                    tile_size = 1 << 16;
+                }
+                int tiles_x = (blocks_x + tile_w - 1)/tile_w, tiles_y = (blocks_y + tile_h - 1)/tile_h;
+                int64_t layout_size = tile_size*tiles_x*tiles_y;
+
+                uint8_t* expected = (uint8_t*)calloc(1, (size_t)layout_size);
+                uint8_t* dst = (uint8_t*)malloc((size_t)layout_size);
+                if (!expected || !dst) {
+                    puts("Error: out of memory");
+                    exit(-1);
+                }
+                for (int y = 0; y < blocks_y; y++) {
+                    for (int x = 0; x < blocks_x; x++) {
+                        int64_t tile = (int64_t)(y/tile_h)*tiles_x + x/tile_w;
+                        uint64_t addr = (uint64_t)(tile*tile_size) + deposit((uint64_t)(x % tile_w), x_mask) + 
+                                        deposit((uint64_t)(y % tile_h), y_mask);
+                        memcpy(expected + addr, src + (int64_t)y*row_bytes + x*elem_size, (size_t)elem_size);
+                    }
+                }
+                memset(dst, 0xa5, (size_t)layout_size);
+
+                ddsktx_swizzle swizzle = (ddsktx_swizzle)mode;
+                if (ddsktx_swizzled_size(&tc, &sub, swizzle) != layout_size ||
+                    ddsktx_swizzle_sub(&tc, &sub, swizzle, dst, layout_size - 1) ||
+                    !ddsktx_swizzle_sub(&tc, &sub, swizzle, dst, layout_size) ||
+                    memcmp(dst, expected, (size_t)layout_size) != 0)
+                {
+                    char msg[96];
+                    snprintf(msg, sizeof(msg), "wrong %s swizzle of %s %dx%d", mode == DDSKTX_SWIZZLE_MORTON ? "morton" : 
+                             "64KB standard", ddsktx_format_str(tc.format), tc.width, tc.height);
+                    check_failed(NULL, msg);
+                }
+                free(dst);
+                free(expected);
+            }
+            free(src);
+        }
+    }
+
+    // RGB8 elements are not a power of two
+    ddsktx_texture_info tc;
+    memset(&tc, 0x0, sizeof(tc));
+    tc.format = DDSKTX_FORMAT_RGB8;
+    uint8_t pixels[12];
+    ddsktx_sub_data sub = { pixels, 2, 2, sizeof(pixels), 6 };
+    if (ddsktx_swizzled_size(&tc, &sub, DDSKTX_SWIZZLE_MORTON) != -1) {
+        check_failed(NULL, "RGB8 can be swizzled");
+    }
+}
+
+// parses every file once, checks the results and counts the bytes that are touched
+static void check_corpus(void)
+{
+    const corpus* c = &g_bench.files;
+    int format_files[_DDSKTX_FORMAT_COUNT] = {0};
+    int64_t max_sub_size = 0;
+    for (int i = 0; i < c->num_files; i++) {
+        max_sub_size = c->files[i].size > (size_t)max_sub_size ? (int64_t)c->files[i].size : max_sub_size;
+    }
+    uint8_t* sub_buff = (uint8_t*)malloc((size_t)max_sub_size);
+    uint8_t* tile_buff = (uint8_t*)malloc((size_t)max_sub_size*2);
+    if (!sub_buff || !tile_buff) {
+        puts("Error: out of memory");
+        exit(-1);
+    }
+
+    for (int i = 0; i < c->num_files; i++) {
+        const corpus_file* f = &c->files[i];
+        bench_stats* stats = &g_bench.stats[f->container];
+        ddsktx_texture_info* tc = &g_bench.infos_validated[i];
+        ddsktx_error err;
+
+        if (!ddsktx_parse64(&g_bench.infos[i], f->data, f->size, &err) ||
+            !ddsktx_parse_strict(tc, f->data, f->size, &err))
+        {
+            check_failed(f, err.msg);
+            continue;
+        }
+        if (tc->format != f->format) {
+            check_failed(f, "parsed to a different format");
+        }
+        if ((tc->flags & DDSKTX_TEXTURE_FLAG_SRGB) != (f->flags & DDSKTX_TEXTURE_FLAG_SRGB)) {
+            check_failed(f, "sRGB flag is lost");
+        }
+        format_files[f->format]++;
+        if (f->container == CORPUS_KTX) {
+            check_ktx_type(f);
+        }
+
+        counting_reader cr = { f->data, (int64_t)f->size, 0 };
+        ddsktx_reader reader = { counting_read, counting_size, &cr };
+        ddsktx_texture_info rtc;
+        if (!ddsktx_parse_reader(&rtc, &reader, NULL)) {
+            check_failed(f, "ddsktx_parse_reader failed");
+            continue;
+        }
+        stats->header_bytes += cr.bytes_read;
+
+        int num_slices = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : tc->depth;
+        if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+            stats->num_subs += tc->num_mips;
+            num_slices = 0;     // levels are checked by for_each_sub
+        }
+        for (int layer = 0; layer < tc->num_layers; layer++) {
+            for (int slice = 0; slice < num_slices; slice++) {
+                for (int mip = 0; mip < tc->num_mips; mip++) {
+                    ddsktx_sub_data sub;
+                    cr.bytes_read = 0;
+                    if (!ddsktx_read_sub(&rtc, &reader, sub_buff, max_sub_size, &sub, layer, slice, mip)) {
+                        check_failed(f, "ddsktx_read_sub failed");
+                        continue;
+                    }
+                    stats->lookup_bytes += cr.bytes_read - sub.size_bytes;
+                    stats->data_bytes += sub.size_bytes;
+                    stats->num_subs++;
+                }
+            }
+        }
+        stats->num_files++;
+
+        uintptr_t sink = 0;
+        if (!for_each_sub(tc, f, &sink) || !for_each_sub(&g_bench.infos[i], f, &sink)) {
+            check_failed(f, "ddsktx_get_sub64 or ddsktx_get_level_range failed");
+        }
+        check_tile_spans(f, tc, tile_buff, tile_buff + max_sub_size);
+    }
+    free(tile_buff);
+    free(sub_buff);
+
+    for (int format = 0; format < _DDSKTX_FORMAT_COUNT; format++) {
+        if (format != _DDSKTX_FORMAT_COMPRESSED && format_files[format] == 0) {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "no files of format %s", ddsktx_format_str((ddsktx_format)format));
+            check_failed(NULL, msg);
+        }
+    }
+    for (int k = 0; k < _CORPUS_CONTAINER_COUNT; k++) {
+        if (g_bench.stats[k].num_files == 0) {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "no %s files", k_corpus_container_names[k]);
+            check_failed(NULL, msg);
+        }
+    }
+    for (int i = 0; i < c->num_malformed; i++) {
+        ddsktx_texture_info mtc;
+        if (ddsktx_parse64(&mtc, c->malformed[i].data, c->malformed[i].size, NULL)) {
+            check_failed(&c->malformed[i], "malformed file is not rejected");
+        }
+    }
+    check_srgb();
+    check_swizzle();
+    check_transcode();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// timings
+typedef enum bench_op
+{
+    BENCH_PARSE = 0,
+    BENCH_PARSE_STRICT,
+    BENCH_GET_SUB,
+    BENCH_GET_SUB_VALIDATED
+} bench_op;
+
+static uint64_t time_pass(bench_op op, int container)
+{
+    const corpus* c = &g_bench.files;
+    uintptr_t sink = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < c->num_files; i++) {
+        const corpus_file* f = &c->files[i];
+        if ((int)f->container != container) {
+            continue;
+        }
+
+        ddsktx_texture_info tc;
+        switch (op) {
+        case BENCH_PARSE:
+            sink += ddsktx_parse64(&tc, f->data, f->size, NULL);
+            break;
+        case BENCH_PARSE_STRICT:
+            sink += ddsktx_parse_strict(&tc, f->data, f->size, NULL);
+            break;
+        case BENCH_GET_SUB:
+            for_each_sub(&g_bench.infos[i], f, &sink);
+            break;
+        case BENCH_GET_SUB_VALIDATED:
+            for_each_sub(&g_bench.infos_validated[i], f, &sink);
+            break;
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+    g_sink += sink;
+    return elapsed;
+}
+
+static uint64_t time_op(bench_op op, int container)
+{
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < g_bench.repeat; r++) {
+        uint64_t t = time_pass(op, container);
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// parallel throughput
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI thread_entry(LPVOID arg)
+#else
+static void* thread_entry(void* arg)
+#endif
+{
+    batch_job* job = (batch_job*)arg;
+    for (int r = 0; r < BATCH_ROUNDS; r++) {
+        job->num_parsed = ddsktx_parse_batch(g_bench.blobs + job->first, job->count,
+                                             g_bench.infos_batch + job->first, g_bench.results_batch + job->first);
+    }
+    return 0;
+}
+
+// the calling thread takes the first range, thread start-up is part of the timing
+static uint64_t time_batch_pass(batch_job* jobs, int num_threads)
+{
+    int num_files = g_bench.files.num_files;
+    for (int i = 0; i < num_threads; i++) {
+        jobs[i].first = (int)((int64_t)num_files*i/num_threads);
+        jobs[i].count = (int)((int64_t)num_files*(i + 1)/num_threads) - jobs[i].first;
+        jobs[i].num_parsed = 0;
+    }
+
+    bench_thread threads[MAX_THREADS];
+    bool started[MAX_THREADS];
+    uint64_t start = now_ns();
+    for (int i = 1; i < num_threads; i++) {
+        started[i] = thread_start(&threads[i], &jobs[i]);
+    }
+    thread_entry(&jobs[0]);
+    for (int i = 1; i < num_threads; i++) {
+        if (started[i]) {
+            thread_join(threads[i]);
+        } else {
+            thread_entry(&jobs[i]);
+        }
+    }
+    return now_ns() - start;
+}
+
+// fastest pass, and checks that every file is parsed to the same result as ddsktx_parse64
+static uint64_t time_batch(int num_threads)
+{
+    batch_job jobs[MAX_THREADS];
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < g_bench.repeat; r++) {
+        uint64_t t = time_batch_pass(jobs, num_threads);
+        best = t < best ? t : best;
+    }
+
+    int num_parsed = 0;
+    for (int i = 0; i < num_threads; i++) {
+        num_parsed += jobs[i].num_parsed;
+    }
+    const corpus* c = &g_bench.files;
+    for (int i = 0; i < c->num_files; i++) {
+        const ddsktx_texture_info* a = &g_bench.infos_batch[i];
+        const ddsktx_texture_info* b = &g_bench.infos[i];
+        if (g_bench.results_batch[i] == DDSKTX_OK &&
+            (a->data_offset != b->data_offset || a->size_bytes != b->size_bytes || a->format != b->format ||
+             a->flags != b->flags || a->width != b->width || a->height != b->height || a->depth != b->depth ||
+             a->num_layers != b->num_layers || a->num_mips != b->num_mips))
+        {
+            check_failed(&c->files[i], "ddsktx_parse_batch result is different from ddsktx_parse64");
+        }
+    }
+    if (num_parsed != c->num_files) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "ddsktx_parse_batch failed on %d files", c->num_files - num_parsed);
+        check_failed(NULL, msg);
+    }
+    return best;
+}
+
+static void print_batch(void)
+{
+    const corpus* c = &g_bench.files;
+    g_bench.blobs = (ddsktx_blob*)malloc(sizeof(ddsktx_blob)*c->num_files);
+    g_bench.infos_batch = (ddsktx_texture_info*)calloc(c->num_files, sizeof(ddsktx_texture_info));
+    g_bench.results_batch = (ddsktx_result*)calloc(c->num_files, sizeof(ddsktx_result));
+    if (!g_bench.blobs || !g_bench.infos_batch || !g_bench.results_batch) {
+        puts("Error: out of memory");
+        exit(-1);
+    }
+    for (int i = 0; i < c->num_files; i++) {
+        g_bench.blobs[i].data = c->files[i].data;
+        g_bench.blobs[i].size = c->files[i].size;
+    }
+
+    printf("\nddsktx_parse_batch: %d files, %d rounds per pass\n", c->num_files, BATCH_ROUNDS);
+    puts("threads  Mfiles/s    ns/file    speedup");
+    double num_files = (double)c->num_files * BATCH_ROUNDS;
+    uint64_t single_ns = 0;
+    for (int n = 1; n <= g_bench.num_threads; n = (n < g_bench.num_threads && n*2 > g_bench.num_threads) ?
+                                                    g_bench.num_threads : n*2) {
+        uint64_t ns = time_batch(n);
+        single_ns = n == 1 ? ns : single_ns;
+        printf("%7d %9.2f %10.1f %10.2f\n", n, num_files*1000.0/(double)ns, (double)ns/num_files,
+               (double)single_ns/(double)ns);
+    }
+
+    free(g_bench.blobs);
+    free(g_bench.infos_batch);
+    free(g_bench.results_batch);
+}
+
+static void print_row(const char* name, const bench_stats* s)
+{
+    if (s->num_files == 0) {
+        return;
+    }
+    double files = (double)s->num_files;
+    double subs = (double)(s->num_subs > 0 ? s->num_subs : 1);
+    printf("%-12s %6d %7" PRId64 " %10.1f %10.1f %10.1f %10.1f %9.1f %9.2f %9.2f\n", name, s->num_files, s->num_subs,
+           (double)s->parse_ns/files, (double)s->strict_ns/files,
+           (double)s->sub_ns/subs, (double)s->sub_validated_ns/subs,
+           (double)s->header_bytes/files, (double)s->lookup_bytes/subs, (double)s->data_bytes/(1024.0*1024.0));
+}
+
+static void print_usage(void)
+{
+    puts("Usage: ctexbench [options]\n"
+         "  -r, --repeat N      number of timed passes over the corpus (default: 50)\n"
+         "  -t, --threads N     maximum number of threads of the ddsktx_parse_batch test\n"
+         "                      (default: number of cores, 0 skips the test)\n"
+         "  -c, --check         check the corpus first, exit with an error if a check fails");
+}
+
+static bool is_arg(const char* arg, const char* short_name, const char* long_name)
+{
+    return strcmp(arg, short_name) == 0 || strcmp(arg, long_name) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    g_bench.repeat = DEFAULT_REPEAT;
+    g_bench.num_threads = num_cores();
+    for (int i = 1; i < argc; i++) {
+        if (is_arg(argv[i], "-r", "--repeat") && i + 1 < argc) {
+            g_bench.repeat = atoi(argv[++i]);
+            if (g_bench.repeat < 1) {
+                g_bench.repeat = 1;
+            }
+        } else if (is_arg(argv[i], "-t", "--threads") && i + 1 < argc) {
+            g_bench.num_threads = atoi(argv[++i]);
+        } else if (is_arg(argv[i], "-c", "--check")) {
+            g_bench.check = true;
+        } else {
+            print_usage();
+            return -1;
+        }
+    }
+
+    corpus* c = &g_bench.files;
+    if (!corpus_build(c)) {
+        puts("Error: out of memory");
+        return -1;
+    }
+    g_bench.infos = (ddsktx_texture_info*)calloc(c->num_files, sizeof(ddsktx_texture_info));
+    g_bench.infos_validated = (ddsktx_texture_info*)calloc(c->num_files, sizeof(ddsktx_texture_info));
+    if (!g_bench.infos || !g_bench.infos_validated) {
+        puts("Error: out of memory");
+        return -1;
+    }
+
+    check_corpus();
+    if (num_errors > 0) {
+        printf("%d checks failed\n", num_errors);
+        if (g_bench.check) {
+            return 1;
+        }
+    } else if (g_bench.check) {
+        puts("corpus checks passed");
+    }
+
+    printf("corpus: %d files, %.2f MB, %d passes\n", c->num_files, (double)c->total_size/(1024.0*1024.0),
+           g_bench.repeat);
+    puts("                                     ns/file               ns/sub-image        bytes touched");
+    puts("container     files    subs      parse     strict    get_sub  validated  hdr/file  lkp/sub   data MB");
+
+    bench_stats* total = &g_bench.stats[_CORPUS_CONTAINER_COUNT];
+    for (int k = 0; k < _CORPUS_CONTAINER_COUNT; k++) {
+        bench_stats* s = &g_bench.stats[k];
+        s->parse_ns = time_op(BENCH_PARSE, k);
+        s->strict_ns = time_op(BENCH_PARSE_STRICT, k);
+        s->sub_ns = time_op(BENCH_GET_SUB, k);
+        s->sub_validated_ns = time_op(BENCH_GET_SUB_VALIDATED, k);
+        print_row(k_corpus_container_names[k], s);
+
+        total->num_files += s->num_files;
+        total->num_subs += s->num_subs;
+        total->header_bytes += s->header_bytes;
+        total->lookup_bytes += s->lookup_bytes;
+        total->data_bytes += s->data_bytes;
+        total->parse_ns += s->parse_ns;
+        total->strict_ns += s->strict_ns;
+        total->sub_ns += s->sub_ns;
+        total->sub_validated_ns += s->sub_validated_ns;
+    }
+    print_row("all", total);
+
+    g_bench.num_threads = g_bench.num_threads < 0 ? 0 : (g_bench.num_threads > MAX_THREADS ? MAX_THREADS : g_bench.num_threads);
+    if (g_bench.num_threads > 0) {
+        print_batch();
+        if (num_errors > 0) {
+            printf("%d checks failed\n", num_errors);
+        }
+    }
+
+    free(g_bench.infos);
+    free(g_bench.infos_validated);
+    corpus_release(c);
+    return g_bench.check && num_errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,282 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// fuzz.c - Fuzz target of the parsers and sub-image lookups, over the same generated corpus as ctexbench
+//      LLVMFuzzerTestOneInput parses the input with ddsktx_parse_header, ddsktx_parse64 and ddsktx_parse_strict,
+//      Validated textures go through the metadata, the subresource table, ddsktx_get_sub (compared with the table), 
+//      tile spans and the block decoders, touching the first and the last byte of every sub-image
+//
+//      Build (libFuzzer):
+//          clang fuzz.c -g -O1 -fsanitize=fuzzer,address,undefined -DCTEXFUZZ_LIBFUZZER -o ctexfuzz_libfuzzer
+//      Build (replay driver, any compiler):
+//          gcc fuzz.c -g -O1 -fsanitize=address,undefined -o ctexfuzz
+//
+//      Usage (replay driver): ctexfuzz [-w dir] [file...]
+//          (no arguments)          runs the generated corpus and its malformed files, then truncated and mutated
+//                                  copies of every file
+//          -w, --write-corpus DIR  writes the generated corpus to DIR (must exist), as seed inputs for libFuzzer:
+//                                  ctexfuzz -w seeds && ctexfuzz_libfuzzer seeds
+//          file...                 runs the files, to reproduce crashes that libFuzzer found
+//
+
+#if defined(_WIN32) || defined(_WIN64)
+#   define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#define DDSKTX_IMPLEMENT
+#include "../dds-ktx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_DECODE_WIDTH 4096
+
+static volatile uint8_t g_sink;
+
+static void touch(const void* buff, int64_t size)
+{
+    if (buff && size > 0) {
+        g_sink ^= ((const uint8_t*)buff)[0] ^ ((const uint8_t*)buff)[size - 1];
+    }
+}
+
+static void fuzz_validated(const ddsktx_texture_info* tc, const uint8_t* data, size_t size)
+{
+    ddsktx_metadata_iter iter;
+    ddsktx_metadata kv;
+    ddsktx_metadata_begin(tc, data, size, &iter);
+    while (ddsktx_metadata_next(&iter, &kv)) {
+        touch(kv.key, 1);
+        touch(kv.value, kv.value_size);
+    }
+
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+        for (int mip = 0; mip < tc->num_mips; mip++) {
+            ddsktx_file_range range;
+            if (ddsktx_get_level_range(tc, data, size, mip, &range, NULL)) {
+                touch(data + range.offset, range.size);
+            }
+        }
+        return;
+    }
+
+    int num_subs = ddsktx_num_subresources(tc);
+    ddsktx_sub_entry* table = (ddsktx_sub_entry*)malloc(sizeof(ddsktx_sub_entry)*num_subs);
+    if (!table) {
+        return;
+    }
+    if (!ddsktx_build_subresource_table(tc, table, num_subs)) {
+        abort();    // validated layouts are always inside the file
+    }
+
+    int num_slices = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : tc->depth;
+    for (int layer = 0; layer < tc->num_layers; layer++) {
+        for (int slice = 0; slice < num_slices; slice++) {
+            for (int mip = 0; mip < tc->num_mips; mip++) {
+                ddsktx_sub_data sub, sub_indexed;
+                ddsktx_get_sub64(tc, &sub, data, size, layer, slice, mip);
+                ddsktx_get_sub_indexed(tc, table, &sub_indexed, data, layer, slice, mip);
+                if (!sub.buff || sub.buff != sub_indexed.buff || sub.size_bytes != sub_indexed.size_bytes) {
+                    abort();
+                }
+                touch(sub.buff, sub.size_bytes);
+
+                ddsktx_file_range spans[4];
+                int num_spans = ddsktx_get_tile_spans(tc, &sub, sub.width/3, sub.height/3, 5, 5, NULL, spans, 4);
+                for (int i = 0; i < num_spans && i < 4; i++) {
+                    touch((const uint8_t*)sub.buff + spans[i].offset, spans[i].size);
+                }
+            }
+        }
+    }
+    free(table);
+
+    // first block row of the first mip, 16 pixel rows cover the tallest blocks
+    ddsktx_format decode_format = ddsktx_block_decode_format(tc->format);
+    if (decode_format != _DDSKTX_FORMAT_COUNT && tc->width <= FUZZ_MAX_DECODE_WIDTH) {
+        ddsktx_sub_data sub;
+        ddsktx_get_sub64(tc, &sub, data, size, 0, 0, 0);
+        int pitch = sub.width * (decode_format == DDSKTX_FORMAT_RGBA16F ? 8 : 4);
+        uint8_t* pixels = (uint8_t*)malloc((size_t)pitch * 16);
+        if (pixels) {
+            ddsktx_decode_blocks(tc, &sub, pixels, pitch, 0, 1);
+            free(pixels);
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    ddsktx_texture_info tc;
+    int64_t required_size;
+    int header_size = size < 4096 ? (int)size : 4096;
+    ddsktx_parse_header(&tc, data, header_size, (int64_t)size, &required_size, NULL);
+
+    // headers of unvalidated textures are only safe to use with trusted files, see ddsktx_parse_strict
+    ddsktx_parse64(&tc, data, size, NULL);
+    if (ddsktx_parse_strict(&tc, data, size, NULL)) {
+        fuzz_validated(&tc, data, size);
+    }
+    return 0;
+}
+
+#ifndef CTEXFUZZ_LIBFUZZER
+#include "corpus.h"
+
+// runs a copy of the input, so reads past the end hit the sanitizers
+static void run_input(const uint8_t* data, size_t size)
+{
+    uint8_t* copy = (uint8_t*)malloc(size ? size : 1);
+    if (!copy) {
+        puts("Error: out of memory");
+        exit(-1);
+    }
+    memcpy(copy, data, size);
+    LLVMFuzzerTestOneInput(copy, size);
+    free(copy);
+}
+
+static bool write_corpus(const corpus* c, const char* dir)
+{
+    for (int i = 0; i < c->num_files + c->num_malformed; i++) {
+        const corpus_file* f = i < c->num_files ? &c->files[i] : &c->malformed[i - c->num_files];
+        char path[512];
+        int len = snprintf(path, sizeof(path), "%s/", dir);
+        for (const char* ch = f->name; *ch && len < (int)sizeof(path) - 6; ch++) {
+            path[len++] = *ch == '/' ? '_' : *ch;
+        }
+        strcpy(path + len, f->container == CORPUS_KTX2 ? ".ktx2" : (f->container == CORPUS_KTX ? ".ktx" : ".dds"));
+
+        FILE* fp = fopen(path, "wb");
+        if (!fp || fwrite(f->data, 1, f->size, fp) != f->size) {
+            printf("Error: could not write '%s'\n", path);
+            if (fp) {
+                fclose(fp);
+            }
+            return false;
+        }
+        fclose(fp);
+    }
+    printf("%d files written to '%s'\n", c->num_files + c->num_malformed, dir);
+    return true;
+}
+
+static bool run_file(const char* filepath)
+{
+    FILE* f = fopen(filepath, "rb");
+    if (!f) {
+        printf("Error: could not open '%s'\n", filepath);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = (uint8_t*)malloc(size > 0 ? (size_t)size : 1);
+    if (!data || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        printf("Error: could not read '%s'\n", filepath);
+        fclose(f);
+        free(data);
+        return false;
+    }
+    fclose(f);
+
+    run_input(data, (size_t)size);
+    free(data);
+    return true;
+}
+
+// deterministic mutations: truncation at every header field and at fractions of the file, and random bytes
+// written over the headers and the rest of the file
+static int run_corpus(const corpus* c)
+{
+    int num_runs = 0;
+    uint32_t seed = 0x9e3779b9;
+    for (int i = 0; i < c->num_files + c->num_malformed; i++) {
+        const corpus_file* f = i < c->num_files ? &c->files[i] : &c->malformed[i - c->num_files];
+        run_input(f->data, f->size);
+        num_runs++;
+
+        for (size_t cut = 1; cut < f->size && cut < 256; cut += 4) {
+            run_input(f->data, cut);
+            num_runs++;
+        }
+        for (int k = 1; k < 8; k++) {
+            run_input(f->data, f->size*k/8);
+            num_runs++;
+        }
+
+        uint8_t* mutated = (uint8_t*)malloc(f->size);
+        if (!mutated) {
+            puts("Error: out of memory");
+            exit(-1);
+        }
+        for (int k = 0; k < 64; k++) {
+            memcpy(mutated, f->data, f->size);
+            for (int m = 0; m < 1 + (k & 3); m++) {
+                seed = seed*1664525u + 1013904223u;
+                size_t range = (k & 4) ? f->size : (f->size < 256 ? f->size : 256);
+                size_t pos = (seed >> 8) % range;
+                seed = seed*1664525u + 1013904223u;
+                // small values and all-ones hit more size checks than random bytes
+                uint8_t value = (k & 8) ? (uint8_t)(seed >> 24) : ((seed >> 28) & 1 ? 0xff : (uint8_t)(seed >> 29));
+                mutated[pos] = value;
+            }
+            run_input(mutated, f->size);
+            num_runs++;
+        }
+        free(mutated);
+    }
+    return num_runs;
+}
+
+static bool is_arg(const char* arg, const char* short_name, const char* long_name)
+{
+    return strcmp(arg, short_name) == 0 || strcmp(arg, long_name) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* corpus_dir = NULL;
+    int num_files = 0;
+    for (int i = 1; i < argc; i++) {
+        if (is_arg(argv[i], "-w", "--write-corpus") && i + 1 < argc) {
+            corpus_dir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            puts("Usage: ctexfuzz [-w dir] [file...]");
+            return -1;
+        } else {
+            if (!run_file(argv[i])) {
+                return -1;
+            }
+            num_files++;
+        }
+    }
+    if (num_files > 0) {
+        printf("%d files ok\n", num_files);
+        return 0;
+    }
+
+    corpus c;
+    if (!corpus_build(&c)) {
+        puts("Error: out of memory");
+        return -1;
+    }
+
+    int r = 0;
+    if (corpus_dir) {
+        r = write_corpus(&c, corpus_dir) ? 0 : -1;
+    } else {
+        int num_runs = run_corpus(&c);
+        printf("%d files, %d inputs ok\n", c.num_files + c.num_malformed, num_runs);
+    }
+    corpus_release(&c);
+    return r;
+}
+#endif  // CTEXFUZZ_LIBFUZZER
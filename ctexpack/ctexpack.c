@@ -0,0 +1,110 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// ctexpack.c - Packs DDS/KTX/KTX2 files into a single texture pack, see dds-ktx-pack.h
+//      Usage: ctexpack [-r root_dir] output_file texture_file...
+//      Textures are named by their path, without the 'root_dir' prefix, so they can be found with:
+//          ddsktx_pack_find(&pack, "textures/rocks.dds")
+//
+
+#define DDSKTX_IMPLEMENT
+#define DDSKTX_MMAP_IMPLEMENT
+#define DDSKTX_PACK_IMPLEMENT
+#include "../dds-ktx-mmap.h"
+#include "../dds-ktx-pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool write_file(const ddsktx_write_buffer* buffs, int num_buffs, void* user)
+{
+    FILE* f = (FILE*)user;
+    for (int i = 0; i < num_buffs; i++) {
+        if (fwrite(buffs[i].data, 1, (size_t)buffs[i].size, f) != (size_t)buffs[i].size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_usage(void)
+{
+    puts("Usage: ctexpack [-r root_dir] output_file texture_file...");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* root = NULL;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0) {
+        root = argv[2];
+        first = 3;
+    }
+    if (argc - first < 2) {
+        print_usage();
+        return -1;
+    }
+
+    const char* output = argv[first];
+    int num_items = argc - first - 1;
+    ddsktx_mmap_file* files = (ddsktx_mmap_file*)calloc((size_t)num_items, sizeof(ddsktx_mmap_file));
+    ddsktx_pack_item* items = (ddsktx_pack_item*)calloc((size_t)num_items, sizeof(ddsktx_pack_item));
+    if (!files || !items) {
+        puts("out of memory");
+        return -1;
+    }
+
+    int result = 0;
+    size_t root_len = root ? strlen(root) : 0;
+    for (int i = 0; i < num_items; i++) {
+        const char* filepath = argv[first + 1 + i];
+        if (!ddsktx_mmap_open(&files[i], filepath)) {
+            printf("could not open file: %s\n", filepath);
+            result = -1;
+            break;
+        }
+
+        const char* name = filepath;
+        if (root_len > 0 && strncmp(name, root, root_len) == 0) {
+            name += root_len;
+            while (*name == '/' || *name == '\\') {
+                name++;
+            }
+        }
+        items[i].name = name;
+        items[i].file_data = files[i].data;
+        items[i].size = files[i].size;
+    }
+
+    if (result == 0) {
+        FILE* f = fopen(output, "wb");
+        ddsktx_error err;
+        if (!f) {
+            printf("could not create file: %s\n", output);
+            result = -1;
+        } else {
+            if (!ddsktx_pack_write(items, num_items, write_file, f, &err)) {
+                printf("%s\n", err.msg);
+                result = -1;
+            }
+            if (fclose(f) != 0 && result == 0) {
+                printf("could not write file: %s\n", output);
+                result = -1;
+            }
+            if (result != 0) {
+                remove(output);
+            } else {
+                printf("%s: %d textures\n", output, num_items);
+            }
+        }
+    }
+
+    for (int i = 0; i < num_items; i++) {
+        ddsktx_mmap_close(&files[i]);
+    }
+    free(items);
+    free(files);
+    return result;
+}
@@ -0,0 +1,805 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// ctextool.c - Headless batch tool for DDS/KTX/KTX2 files: layout reports (JSON) and PNG thumbnails
+//      Walks the given files and directories, memory-maps and parses every texture on a pool of worker threads
+//      Thumbnails are decoded on the CPU from one mip (the first one that fits --size by default)
+//      Memory of the decoded images that are in flight is bounded by --max-memory
+//
+//      Build:
+//          Windows: cl ctextool.c /O2
+//          Linux:   gcc ctextool.c -O2 -lpthread -lm -o ctextool
+//          MacOS:   clang ctextool.c -O2 -o ctextool
+//
+//      Usage: ctextool [options] file_or_directory...
+//          -j, --json FILE         write the layout report of all files to FILE ('-' for stdout)
+//          -o, --output DIR        write a PNG thumbnail for each texture to DIR (must exist)
+//          -s, --size N            thumbnail mip is the first one with both dimensions <= N (default: 256)
+//          -m, --mip N             decode this mip instead (clamped to the mip count)
+//          -t, --threads N         number of worker threads (default: number of cores)
+//          -M, --max-memory MB     limit of decoded image memory in flight (default: 512)
+//
+
+#if defined(_WIN32) || defined(_WIN64)
+#   define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#define DDSKTX_IMPLEMENT
+#define DDSKTX_MMAP_IMPLEMENT
+#include "../dds-ktx-mmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <dirent.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+#define MAX_THREADS 64
+#define DEFAULT_THUMB_SIZE 256
+#define DEFAULT_MAX_MEMORY 512      // MB
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// threads
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE tool_thread;
+typedef CRITICAL_SECTION tool_mutex;
+typedef CONDITION_VARIABLE tool_cond;
+
+static DWORD WINAPI thread_entry(LPVOID arg);
+
+static bool thread_start(tool_thread* thrd, void* arg)
+{
+    *thrd = CreateThread(NULL, 0, thread_entry, arg, 0, NULL);
+    return *thrd != NULL;
+}
+
+static void thread_join(tool_thread thrd)
+{
+    WaitForSingleObject(thrd, INFINITE);
+    CloseHandle(thrd);
+}
+
+static void mutex_init(tool_mutex* m)     { InitializeCriticalSection(m); }
+static void mutex_release(tool_mutex* m)  { DeleteCriticalSection(m); }
+static void mutex_lock(tool_mutex* m)     { EnterCriticalSection(m); }
+static void mutex_unlock(tool_mutex* m)   { LeaveCriticalSection(m); }
+static void cond_init(tool_cond* c)       { InitializeConditionVariable(c); }
+static void cond_release(tool_cond* c)    { (void)c; }
+static void cond_wait(tool_cond* c, tool_mutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void cond_broadcast(tool_cond* c)  { WakeAllConditionVariable(c); }
+
+static int num_cores(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t tool_thread;
+typedef pthread_mutex_t tool_mutex;
+typedef pthread_cond_t tool_cond;
+
+static void* thread_entry(void* arg);
+
+static bool thread_start(tool_thread* thrd, void* arg)
+{
+    return pthread_create(thrd, NULL, thread_entry, arg) == 0;
+}
+
+static void thread_join(tool_thread thrd)
+{
+    pthread_join(thrd, NULL);
+}
+
+static void mutex_init(tool_mutex* m)     { pthread_mutex_init(m, NULL); }
+static void mutex_release(tool_mutex* m)  { pthread_mutex_destroy(m); }
+static void mutex_lock(tool_mutex* m)     { pthread_mutex_lock(m); }
+static void mutex_unlock(tool_mutex* m)   { pthread_mutex_unlock(m); }
+static void cond_init(tool_cond* c)       { pthread_cond_init(c, NULL); }
+static void cond_release(tool_cond* c)    { pthread_cond_destroy(c); }
+static void cond_wait(tool_cond* c, tool_mutex* m) { pthread_cond_wait(c, m); }
+static void cond_broadcast(tool_cond* c)  { pthread_cond_broadcast(c); }
+
+static int num_cores(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct file_result
+{
+    char*               path;
+    int64_t             file_size;
+    ddsktx_texture_info tc;
+    bool                parsed;
+    int                 thumb_mip;      // -1 if there is no thumbnail
+    char                error[128];
+} file_result;
+
+typedef struct tool_state
+{
+    file_result*    files;
+    int             num_files;
+    int             max_files;
+
+    const char*     json_path;
+    const char*     thumb_dir;
+    int             thumb_size;
+    int             thumb_mip;          // -1: pick by thumb_size
+    int             num_threads;
+    int64_t         max_memory;
+
+    tool_mutex      mutex;
+    tool_cond       memory_freed;
+    int             next_file;
+    int64_t         memory_in_flight;
+} tool_state;
+
+static tool_state g_tool;
+
+static void set_error(file_result* r, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(r->error, sizeof(r->error), fmt, args);
+    va_end(args);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// file list
+static bool has_texture_ext(const char* path)
+{
+    const char* ext = strrchr(path, '.');
+    if (!ext) {
+        return false;
+    }
+    char lower[8] = {0};
+    for (int i = 0; i < 7 && ext[i]; i++) {
+        lower[i] = (ext[i] >= 'A' && ext[i] <= 'Z') ? (char)(ext[i] - 'A' + 'a') : ext[i];
+    }
+    return strcmp(lower, ".dds") == 0 || strcmp(lower, ".ktx") == 0 || strcmp(lower, ".ktx2") == 0;
+}
+
+static void add_file(const char* path)
+{
+    if (g_tool.num_files == g_tool.max_files) {
+        int max_files = g_tool.max_files ? g_tool.max_files*2 : 1024;
+        file_result* files = (file_result*)realloc(g_tool.files, sizeof(file_result)*max_files);
+        if (!files) {
+            puts("out of memory");
+            exit(-1);
+        }
+        g_tool.files = files;
+        g_tool.max_files = max_files;
+    }
+
+    file_result* r = &g_tool.files[g_tool.num_files++];
+    memset(r, 0x0, sizeof(file_result));
+    size_t len = strlen(path);
+    r->path = (char*)malloc(len + 1);
+    if (!r->path) {
+        puts("out of memory");
+        exit(-1);
+    }
+    memcpy(r->path, path, len + 1);
+    r->thumb_mip = -1;
+}
+
+static int compare_files(const void* a, const void* b)
+{
+    return strcmp(((const file_result*)a)->path, ((const file_result*)b)->path);
+}
+
+static void add_path(const char* path, bool explicit_file)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    DWORD attrs = GetFileAttributesA(path);
+    if (attrs == INVALID_FILE_ATTRIBUTES) {
+        printf("not found: %s\n", path);
+        return;
+    }
+    if (!(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+        if (explicit_file || has_texture_ext(path)) {
+            add_file(path);
+        }
+        return;
+    }
+
+    char pattern[MAX_PATH];
+    snprintf(pattern, sizeof(pattern), "%s\\*", path);
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA(pattern, &fd);
+    if (h == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    do {
+        if (strcmp(fd.cFileName, ".") != 0 && strcmp(fd.cFileName, "..") != 0) {
+            char child[MAX_PATH];
+            snprintf(child, sizeof(child), "%s\\%s", path, fd.cFileName);
+            add_path(child, false);
+        }
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        printf("not found: %s\n", path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        if (explicit_file || (S_ISREG(st.st_mode) && has_texture_ext(path))) {
+            add_file(path);
+        }
+        return;
+    }
+
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return;
+    }
+    struct dirent* e;
+    while ((e = readdir(dir)) != NULL) {
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0) {
+            size_t len = strlen(path) + strlen(e->d_name) + 2;
+            char* child = (char*)malloc(len);
+            if (child) {
+                snprintf(child, len, "%s/%s", path, e->d_name);
+                add_path(child, false);
+                free(child);
+            }
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PNG writer, deflate 'stored' blocks (no compression), thumbnails are small anyway
+static uint32_t k_crc_table[256];
+
+static void crc_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+        }
+        k_crc_table[i] = c;
+    }
+}
+
+static uint32_t crc_update(uint32_t crc, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        crc = k_crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void put_be32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static bool write_png_chunk(FILE* f, const char* type, const uint8_t* data, uint32_t size)
+{
+    uint8_t header[8];
+    put_be32(header, size);
+    memcpy(header + 4, type, 4);
+    uint32_t crc = crc_update(0xffffffffu, header + 4, 4);
+    crc = crc_update(crc, data, size) ^ 0xffffffffu;
+    uint8_t footer[4];
+    put_be32(footer, crc);
+    return fwrite(header, 1, 8, f) == 8 && (size == 0 || fwrite(data, 1, size, f) == size) &&
+           fwrite(footer, 1, 4, f) == 4;
+}
+
+static bool write_png(const char* filepath, const uint8_t* rgba, int width, int height)
+{
+    // filtered scanlines (filter 0 + row), wrapped in zlib stored blocks of up to 65535 bytes
+    size_t raw_size = (size_t)(width*4 + 1) * height;
+    size_t num_blocks = raw_size / 65535 + 1;
+    size_t zsize = 2 + raw_size + num_blocks*5 + 4;
+    if (zsize > 0x7fffffff) {
+        return false;
+    }
+    uint8_t* z = (uint8_t*)malloc(zsize);
+    if (!z) {
+        return false;
+    }
+
+    uint8_t* p = z;
+    *p++ = 0x78;
+    *p++ = 0x01;
+    uint32_t a = 1, b = 0;
+    size_t remain = raw_size;
+    int x = -1, y = 0;   // x == -1 is the filter byte of the row
+    do {
+        uint16_t n = (uint16_t)(remain > 65535 ? 65535 : remain);
+        uint16_t nn = (uint16_t)~n;
+        remain -= n;
+        *p++ = remain == 0 ? 1 : 0;
+        *p++ = (uint8_t)n;
+        *p++ = (uint8_t)(n >> 8);
+        *p++ = (uint8_t)nn;
+        *p++ = (uint8_t)(nn >> 8);
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t v = x < 0 ? 0 : rgba[((size_t)y*width)*4 + x];
+            if (++x == width*4) {
+                x = -1;
+                y++;
+            }
+            *p++ = v;
+            a = (a + v) % 65521;
+            b = (b + a) % 65521;
+        }
+    } while (remain > 0);
+    put_be32(p, (b << 16) | a);
+    p += 4;
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, (uint32_t)width);
+    put_be32(ihdr + 4, (uint32_t)height);
+    ihdr[8] = 8;    // bit depth
+    ihdr[9] = 6;    // RGBA
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    FILE* f = fopen(filepath, "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        ok = fwrite(signature, 1, 8, f) == 8 && write_png_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+             write_png_chunk(f, "IDAT", z, (uint32_t)(p - z)) && write_png_chunk(f, "IEND", NULL, 0);
+        ok = fclose(f) == 0 && ok;
+    }
+    free(z);
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// decoding to RGBA8
+static inline uint8_t unorm8(float v)
+{
+    return (uint8_t)(v <= 0.0f ? 0 : (v >= 1.0f ? 255 : (int)(v*255.0f + 0.5f)));
+}
+
+// 16 and 32 bit formats are clamped to [0, 1], sRGB and signed data is shown as is
+static bool decode_rgba8(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, uint8_t* dst)
+{
+    int w = sub->width;
+    int h = sub->height;
+    int num_block_rows = (int)(sub->size_bytes / sub->row_pitch_bytes);     // ASTC blocks are not always 4 rows
+    ddsktx_format format = tc->format;
+
+    if (format < _DDSKTX_FORMAT_COMPRESSED) {
+        ddsktx_format decode_format = ddsktx_block_decode_format(format);
+        if (decode_format == DDSKTX_FORMAT_RGBA8) {
+            return ddsktx_decode_blocks(tc, sub, dst, w*4, 0, num_block_rows);
+        } else if (decode_format == DDSKTX_FORMAT_RGBA16F) {
+            uint16_t* half = (uint16_t*)malloc((size_t)w*h*8);
+            float* row = (float*)malloc((size_t)w*16);
+            bool ok = half && row && ddsktx_decode_blocks(tc, sub, half, w*8, 0, num_block_rows);
+            for (int y = 0; ok && y < h; y++) {
+                ddsktx_convert_row(DDSKTX_CONVERT_RGBA16F_TO_RGBA32F, half + (size_t)y*w*4, row, w);
+                for (int x = 0; x < w*4; x++) {
+                    dst[((size_t)y*w)*4 + x] = unorm8(row[x]);
+                }
+            }
+            free(row);
+            free(half);
+            return ok;
+        }
+        return false;
+    }
+
+    float* frow = (float*)malloc((size_t)w*16);
+    if (!frow) {
+        return false;
+    }
+
+    bool ok = true;
+    for (int y = 0; y < h && ok; y++) {
+        const uint8_t* src = (const uint8_t*)sub->buff + (size_t)y*sub->row_pitch_bytes;
+        uint8_t* d = dst + (size_t)y*w*4;
+        switch (format) {
+        case DDSKTX_FORMAT_RGBA8:
+            memcpy(d, src, (size_t)w*4);
+            break;
+        case DDSKTX_FORMAT_BGRA8:
+            ddsktx_convert_row(DDSKTX_CONVERT_BGRA8_TO_RGBA8, src, d, w);
+            break;
+        case DDSKTX_FORMAT_RGB8:
+            ddsktx_convert_row(DDSKTX_CONVERT_RGB8_TO_RGBA8, src, d, w);
+            break;
+        case DDSKTX_FORMAT_R8:
+        case DDSKTX_FORMAT_A8:
+            for (int x = 0; x < w; x++) {
+                d[x*4 + 0] = d[x*4 + 1] = d[x*4 + 2] = src[x];
+                d[x*4 + 3] = 255;
+            }
+            break;
+        case DDSKTX_FORMAT_RG8:
+            for (int x = 0; x < w; x++) {
+                d[x*4 + 0] = src[x*2];
+                d[x*4 + 1] = src[x*2 + 1];
+                d[x*4 + 2] = 0;
+                d[x*4 + 3] = 255;
+            }
+            break;
+        case DDSKTX_FORMAT_R16:
+        case DDSKTX_FORMAT_RG16:
+        case DDSKTX_FORMAT_RGBA16: {
+            int nc = format == DDSKTX_FORMAT_R16 ? 1 : (format == DDSKTX_FORMAT_RG16 ? 2 : 4);
+            const uint16_t* s = (const uint16_t*)src;
+            for (int x = 0; x < w; x++) {
+                d[x*4 + 0] = (uint8_t)(s[x*nc] >> 8);
+                d[x*4 + 1] = nc > 1 ? (uint8_t)(s[x*nc + 1] >> 8) : d[x*4 + 0];
+                d[x*4 + 2] = nc > 2 ? (uint8_t)(s[x*nc + 2] >> 8) : (nc == 1 ? d[x*4 + 0] : 0);
+                d[x*4 + 3] = nc > 3 ? (uint8_t)(s[x*nc + 3] >> 8) : 255;
+            }
+            break;
+        }
+        case DDSKTX_FORMAT_RGB10A2: {
+            const uint32_t* s = (const uint32_t*)src;
+            for (int x = 0; x < w; x++) {
+                d[x*4 + 0] = (uint8_t)((s[x] >> 2) & 0xff);
+                d[x*4 + 1] = (uint8_t)((s[x] >> 12) & 0xff);
+                d[x*4 + 2] = (uint8_t)((s[x] >> 22) & 0xff);
+                d[x*4 + 3] = (uint8_t)(((s[x] >> 30) & 0x3) * 85);
+            }
+            break;
+        }
+        case DDSKTX_FORMAT_R32F:
+        case DDSKTX_FORMAT_R16F:
+        case DDSKTX_FORMAT_RG16F:
+        case DDSKTX_FORMAT_RGBA16F: {
+            int nc = (format == DDSKTX_FORMAT_R32F || format == DDSKTX_FORMAT_R16F) ? 1 :
+                     (format == DDSKTX_FORMAT_RG16F ? 2 : 4);
+            const float* f = (const float*)src;
+            if (format != DDSKTX_FORMAT_R32F) {
+                ddsktx_convert_op op = format == DDSKTX_FORMAT_R16F ? DDSKTX_CONVERT_R16F_TO_R32F :
+                    (format == DDSKTX_FORMAT_RG16F ? DDSKTX_CONVERT_RG16F_TO_RG32F : DDSKTX_CONVERT_RGBA16F_TO_RGBA32F);
+                ddsktx_convert_row(op, src, frow, w);
+                f = frow;
+            }
+            for (int x = 0; x < w; x++) {
+                d[x*4 + 0] = unorm8(f[x*nc]);
+                d[x*4 + 1] = nc > 1 ? unorm8(f[x*nc + 1]) : d[x*4 + 0];
+                d[x*4 + 2] = nc > 2 ? unorm8(f[x*nc + 2]) : (nc == 1 ? d[x*4 + 0] : 0);
+                d[x*4 + 3] = nc > 3 ? unorm8(f[x*nc + 3]) : 255;
+            }
+            break;
+        }
+        default:
+            ok = false;
+            break;
+        }
+    }
+
+    free(frow);
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// in flight memory budget: a job waits until there is room, unless nothing else is in flight
+static void memory_acquire(int64_t size)
+{
+    mutex_lock(&g_tool.mutex);
+    while (g_tool.memory_in_flight > 0 && g_tool.memory_in_flight + size > g_tool.max_memory) {
+        cond_wait(&g_tool.memory_freed, &g_tool.mutex);
+    }
+    g_tool.memory_in_flight += size;
+    mutex_unlock(&g_tool.mutex);
+}
+
+static void memory_release(int64_t size)
+{
+    mutex_lock(&g_tool.mutex);
+    g_tool.memory_in_flight -= size;
+    cond_broadcast(&g_tool.memory_freed);
+    mutex_unlock(&g_tool.mutex);
+}
+
+static int pick_mip(const ddsktx_texture_info* tc)
+{
+    if (g_tool.thumb_mip >= 0) {
+        return g_tool.thumb_mip < tc->num_mips ? g_tool.thumb_mip : tc->num_mips - 1;
+    }
+    int mip = 0;
+    while (mip < tc->num_mips - 1 &&
+           ((tc->width >> mip) > g_tool.thumb_size || (tc->height >> mip) > g_tool.thumb_size)) {
+        mip++;
+    }
+    return mip;
+}
+
+static void write_thumbnail(file_result* r, const ddsktx_mmap_file* file)
+{
+    const ddsktx_texture_info* tc = &r->tc;
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+        set_error(r, "thumbnail: supercompressed ktx2 is not supported");
+        return;
+    }
+
+    int mip = pick_mip(tc);
+    ddsktx_sub_data sub;
+    ddsktx_get_sub64(tc, &sub, file->data, file->size, 0, 0, mip);
+    if (!sub.buff) {
+        set_error(r, "thumbnail: mip %d is truncated", mip);
+        return;
+    }
+
+    int64_t size = (int64_t)sub.width * sub.height * 4;
+    memory_acquire(size);
+    uint8_t* rgba = (uint8_t*)malloc((size_t)size);
+    if (!rgba) {
+        set_error(r, "thumbnail: out of memory");
+    } else if (!decode_rgba8(tc, &sub, rgba)) {
+        set_error(r, "thumbnail: format %s cannot be decoded", ddsktx_format_str(tc->format));
+    } else {
+        // flatten the path, so all thumbnails are in one directory
+        char name[512];
+        size_t len = strlen(r->path);
+        const char* src = len > 400 ? r->path + len - 400 : r->path;
+        size_t n = 0;
+        for (; *src && n < 400; src++) {
+            name[n++] = (*src == '/' || *src == '\\' || *src == ':') ? '_' : *src;
+        }
+        name[n] = '\0';
+
+        char filepath[1024];
+        snprintf(filepath, sizeof(filepath), "%s/%s.png", g_tool.thumb_dir, name);
+        if (write_png(filepath, rgba, sub.width, sub.height)) {
+            r->thumb_mip = mip;
+        } else {
+            set_error(r, "thumbnail: could not write %s", filepath);
+        }
+    }
+    free(rgba);
+    memory_release(size);
+}
+
+static void process_file(file_result* r)
+{
+    ddsktx_mmap_file file;
+    if (!ddsktx_mmap_open(&file, r->path)) {
+        set_error(r, "could not open file");
+        return;
+    }
+    r->file_size = (int64_t)file.size;
+
+    ddsktx_error err;
+    if (!ddsktx_parse_strict(&r->tc, file.data, file.size, &err)) {
+        set_error(r, "%s", err.msg);
+    } else {
+        r->parsed = true;
+        if (g_tool.thumb_dir) {
+            write_thumbnail(r, &file);
+        }
+    }
+    ddsktx_mmap_close(&file);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI thread_entry(LPVOID arg)
+#else
+static void* thread_entry(void* arg)
+#endif
+{
+    (void)arg;
+    for (;;) {
+        mutex_lock(&g_tool.mutex);
+        int index = g_tool.next_file < g_tool.num_files ? g_tool.next_file++ : -1;
+        mutex_unlock(&g_tool.mutex);
+        if (index < 0) {
+            break;
+        }
+        process_file(&g_tool.files[index]);
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JSON report
+static void json_string(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(f, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+static const char* container_str(unsigned int flags)
+{
+    if (flags & DDSKTX_TEXTURE_FLAG_DDS)    return "dds";
+    if (flags & DDSKTX_TEXTURE_FLAG_KTX2)   return "ktx2";
+    if (flags & DDSKTX_TEXTURE_FLAG_KTX)    return "ktx";
+    return "unknown";
+}
+
+static bool write_json(const char* filepath)
+{
+    bool to_stdout = strcmp(filepath, "-") == 0;
+    FILE* f = to_stdout ? stdout : fopen(filepath, "wt");
+    if (!f) {
+        return false;
+    }
+
+    fputs("[\n", f);
+    for (int i = 0; i < g_tool.num_files; i++) {
+        const file_result* r = &g_tool.files[i];
+        const ddsktx_texture_info* tc = &r->tc;
+        fputs("  {\"path\": ", f);
+        json_string(f, r->path);
+        fprintf(f, ", \"file_size\": %lld", (long long)r->file_size);
+        if (r->parsed) {
+            int num_faces = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : 1;
+            fprintf(f, ", \"container\": \"%s\", \"format\": \"%s\", \"width\": %d, \"height\": %d, \"depth\": %d, "
+                       "\"layers\": %d, \"faces\": %d, \"num_mips\": %d, \"srgb\": %s, \"data_offset\": %lld, "
+                       "\"data_size\": %lld",
+                    container_str(tc->flags), ddsktx_format_str(tc->format), tc->width, tc->height, tc->depth,
+                    tc->num_layers, num_faces, tc->num_mips, (tc->flags & DDSKTX_TEXTURE_FLAG_SRGB) ? "true" : "false",
+                    (long long)tc->data_offset, (long long)tc->size_bytes);
+            if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+                fprintf(f, ", \"supercompression\": %d", (int)tc->supercompression);
+            }
+
+            // one image of each mip, multiply by layers*faces*depth for the whole mip
+            fputs(", \"mips\": [", f);
+            for (int mip = 0; mip < tc->num_mips; mip++) {
+                int row_bytes;
+                int64_t size = ddsktx_calc_mip_size(tc->format, tc->width, tc->height, mip, &row_bytes);
+                fprintf(f, "%s{\"width\": %d, \"height\": %d, \"row_bytes\": %d, \"size\": %lld}", mip ? ", " : "",
+                        tc->width >> mip ? tc->width >> mip : 1, tc->height >> mip ? tc->height >> mip : 1,
+                        row_bytes, (long long)size);
+            }
+            fputc(']', f);
+            if (r->thumb_mip >= 0) {
+                fprintf(f, ", \"thumbnail_mip\": %d", r->thumb_mip);
+            }
+        }
+        if (r->error[0]) {
+            fputs(", \"error\": ", f);
+            json_string(f, r->error);
+        }
+        fprintf(f, "}%s\n", i + 1 < g_tool.num_files ? "," : "");
+    }
+    fputs("]\n", f);
+
+    bool ok = !ferror(f);
+    if (!to_stdout) {
+        ok = fclose(f) == 0 && ok;
+    }
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+static void print_usage(void)
+{
+    puts("Usage: ctextool [options] file_or_directory...\n"
+         "  -j, --json FILE         write the layout report of all files to FILE ('-' for stdout)\n"
+         "  -o, --output DIR        write a PNG thumbnail for each texture to DIR (must exist)\n"
+         "  -s, --size N            thumbnail mip is the first one with both dimensions <= N (default: 256)\n"
+         "  -m, --mip N             decode this mip instead (clamped to the mip count)\n"
+         "  -t, --threads N         number of worker threads (default: number of cores)\n"
+         "  -M, --max-memory MB     limit of decoded image memory in flight (default: 512)");
+}
+
+static bool is_arg(const char* arg, const char* short_name, const char* long_name)
+{
+    return strcmp(arg, short_name) == 0 || strcmp(arg, long_name) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    g_tool.thumb_size = DEFAULT_THUMB_SIZE;
+    g_tool.thumb_mip = -1;
+    g_tool.num_threads = num_cores();
+    g_tool.max_memory = (int64_t)DEFAULT_MAX_MEMORY*1024*1024;
+
+    int num_paths = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (is_arg(arg, "-j", "--json") && has_value) {
+            g_tool.json_path = argv[++i];
+        } else if (is_arg(arg, "-o", "--output") && has_value) {
+            g_tool.thumb_dir = argv[++i];
+        } else if (is_arg(arg, "-s", "--size") && has_value) {
+            g_tool.thumb_size = atoi(argv[++i]);
+        } else if (is_arg(arg, "-m", "--mip") && has_value) {
+            g_tool.thumb_mip = atoi(argv[++i]);
+        } else if (is_arg(arg, "-t", "--threads") && has_value) {
+            g_tool.num_threads = atoi(argv[++i]);
+        } else if (is_arg(arg, "-M", "--max-memory") && has_value) {
+            g_tool.max_memory = (int64_t)atoi(argv[++i])*1024*1024;
+        } else if (arg[0] == '-' && arg[1] != '\0') {
+            print_usage();
+            return -1;
+        } else {
+            add_path(arg, true);
+            num_paths++;
+        }
+    }
+
+    if (num_paths == 0 || (!g_tool.json_path && !g_tool.thumb_dir)) {
+        print_usage();
+        return -1;
+    }
+
+    // directory order depends on the file system, sort for reproducible reports
+    if (g_tool.num_files > 1) {
+        qsort(g_tool.files, (size_t)g_tool.num_files, sizeof(file_result), compare_files);
+    }
+
+    g_tool.num_threads = g_tool.num_threads < 1 ? 1 : (g_tool.num_threads > MAX_THREADS ? MAX_THREADS : g_tool.num_threads);
+    g_tool.thumb_size = g_tool.thumb_size < 1 ? 1 : g_tool.thumb_size;
+    crc_init();
+    mutex_init(&g_tool.mutex);
+    cond_init(&g_tool.memory_freed);
+
+    tool_thread threads[MAX_THREADS];
+    int num_threads = 0;
+    for (int i = 0; i < g_tool.num_threads && i < g_tool.num_files; i++) {
+        if (!thread_start(&threads[num_threads], NULL)) {
+            break;
+        }
+        num_threads++;
+    }
+    if (num_threads == 0) {
+        thread_entry(NULL);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        thread_join(threads[i]);
+    }
+
+    cond_release(&g_tool.memory_freed);
+    mutex_release(&g_tool.mutex);
+
+    int num_failed = 0;
+    for (int i = 0; i < g_tool.num_files; i++) {
+        num_failed += g_tool.files[i].error[0] ? 1 : 0;
+    }
+
+    int result = 0;
+    if (g_tool.json_path && !write_json(g_tool.json_path)) {
+        printf("could not write file: %s\n", g_tool.json_path);
+        result = -1;
+    }
+    if (!g_tool.json_path || strcmp(g_tool.json_path, "-") != 0) {
+        printf("%d files, %d with errors\n", g_tool.num_files, num_failed);
+        for (int i = 0; i < g_tool.num_files; i++) {
+            if (g_tool.files[i].error[0]) {
+                printf("  %s: %s\n", g_tool.files[i].path, g_tool.files[i].error);
+            }
+        }
+    }
+
+    for (int i = 0; i < g_tool.num_files; i++) {
+        free(g_tool.files[i].path);
+    }
+    free(g_tool.files);
+    return result;
+}
@@ -9,3 +9,11 @@ glslcc -i quad.frag --lang metal -o quad_metal.frag.h --cvar quad
 glslcc -i quad.frag --lang hlsl --bin -o quad_cubemap_hlsl.frag.h --cvar quad_cubemap --defines CUBEMAP
 glslcc -i quad.frag --lang glsl --flatten-ubos --profile 330 -o quad_cubemap_glsl.frag.h --cvar quad_cubemap --defines CUBEMAP
 glslcc -i quad.frag --lang metal -o quad_cubemap_metal.frag.h --cvar quad_cubemap --defines CUBEMAP
+
+glslcc -i quad.frag --lang hlsl --bin -o quad_array_hlsl.frag.h --cvar quad_array --defines ARRAY
+glslcc -i quad.frag --lang glsl --flatten-ubos --profile 330 -o quad_array_glsl.frag.h --cvar quad_array --defines ARRAY
+glslcc -i quad.frag --lang metal -o quad_array_metal.frag.h --cvar quad_array --defines ARRAY
+
+glslcc -i quad.frag --lang hlsl --bin -o quad_volume_hlsl.frag.h --cvar quad_volume --defines VOLUME
+glslcc -i quad.frag --lang glsl --flatten-ubos --profile 330 -o quad_volume_glsl.frag.h --cvar quad_volume --defines VOLUME
+glslcc -i quad.frag --lang metal -o quad_volume_metal.frag.h --cvar quad_volume --defines VOLUME
@@ -5,16 +5,22 @@
 #   include "quad_hlsl.vert.h"
 #   include "quad_hlsl.frag.h"
 #   include "quad_cubemap_hlsl.frag.h"
+#   include "quad_array_hlsl.frag.h"
+#   include "quad_volume_hlsl.frag.h"
 #   define SOKOL_LOG(s) OutputDebugStringA(s)
 #elif defined(__linux__)
 #   include "quad_glsl.vert.h"
 #   include "quad_glsl.frag.h"
 #   include "quad_cubemap_glsl.frag.h"
+#   include "quad_array_glsl.frag.h"
+#   include "quad_volume_glsl.frag.h"
 #   define SOKOL_GLCORE33
 #elif defined(__ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__)
 #   include "quad_metal.vert.h"
 #   include "quad_metal.frag.h"
 #   include "quad_cubemap_metal.frag.h"
+#   include "quad_array_metal.frag.h"
+#   include "quad_volume_metal.frag.h"
 #   define SOKOL_METAL
 #endif
 
@@ -29,18 +35,35 @@
 #define DDSKTX_API static
 #include "../dds-ktx.h"
 
+#define DDSKTX_SOKOL_IMPLEMENT
+#include "../dds-ktx-sokol.h"
+
+#define DDSKTX_MMAP_IMPLEMENT
+#include "../dds-ktx-mmap.h"
+
 #ifndef __APPLE__
 #   include <malloc.h>
 #endif
 #include <stdio.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <sys/stat.h>
+#if !defined(_WIN32) && !defined(_WIN64)
+#   include <pthread.h>
+#   include <dirent.h>
+#endif
 
 #define SOKOL_DEBUGTEXT_IMPL
 #include "sokol_debugtext.h"
 
 #define FONT_SCALE 1.1f
 #define CHECKER_SIZE 8
+#define WATCH_INTERVAL 30   // frames between checking the file for changes in watch mode
+#define UPLOAD_BUDGET (4*1024*1024)     // bytes per frame that are uploaded in progressive mode
+#define GALLERY_PREFETCH 3              // files on each side of the current one that are parsed (and uploaded) ahead
+#define GALLERY_KEEP_MAPPED 8           // files that are further away from the current one are unmapped
+#define GALLERY_CACHE_SIZE 64           // max number of images in the gallery cache
+#define GALLERY_CACHE_BUDGET 256        // default GPU memory budget of the gallery cache in MB
 
 typedef struct uniforms_fs 
 {
@@ -66,14 +89,17 @@ typedef struct vertex
 typedef struct ctexview_state
 {
     sg_pass_action pass_action;
-    void* file_data;
-    int file_size;
+    ddsktx_mmap_file file;
     ddsktx_texture_info texinfo;
     sg_image tex;
     sg_shader shader;
     sg_shader shader_cubemap;
+    sg_shader shader_array;
+    sg_shader shader_volume;
     sg_pipeline pip;
     sg_pipeline pip_cubemap;
+    sg_pipeline pip_array;
+    sg_pipeline pip_volume;
     sg_pipeline pip_checker;
     sg_buffer vb;
     sg_buffer ib;
@@ -83,11 +109,132 @@ typedef struct ctexview_state
     uniforms_fs vars_fs;
     int cur_mip;
     int cur_slice;
+    int cur_layer;
     int cube_face;
+    const char* filepath;
+    bool watch;
+    int watch_frame;
+    int64_t file_mtime;
+    int64_t file_size;
+    sg_image_type tex_type;
+    sg_image_desc tex_layout;   // layout of 'tex' (without content), to check if a reload can reuse it
+    bool tex_dynamic;
+    uint64_t sub_hashes[DDSKTX_CUBE_FACE_COUNT][SG_MAX_MIPMAPS];
+    char status[128];
+    bool progressive;
+    bool streaming;
+    int resident_mip;           // first mip of the file that is in 'tex', larger ones are still streamed
+    int64_t resident_bytes;
+    int64_t total_bytes;
+    sg_image_desc stream_desc;  // all the mips, content points to the file or 'stream_mem'
+    void* stream_mem;
 } ctexview_state;
 
 ctexview_state g_state;
 
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE gallery_thread;
+typedef CRITICAL_SECTION gallery_mutex;
+typedef CONDITION_VARIABLE gallery_cond;
+
+static DWORD WINAPI gallery_loader(LPVOID arg);
+
+static bool thread_start(gallery_thread* thrd)
+{
+    *thrd = CreateThread(NULL, 0, gallery_loader, NULL, 0, NULL);
+    return *thrd != NULL;
+}
+
+static void thread_join(gallery_thread thrd)
+{
+    WaitForSingleObject(thrd, INFINITE);
+    CloseHandle(thrd);
+}
+
+static void mutex_init(gallery_mutex* m)    { InitializeCriticalSection(m); }
+static void mutex_release(gallery_mutex* m) { DeleteCriticalSection(m); }
+static void mutex_lock(gallery_mutex* m)    { EnterCriticalSection(m); }
+static void mutex_unlock(gallery_mutex* m)  { LeaveCriticalSection(m); }
+static void cond_init(gallery_cond* c)      { InitializeConditionVariable(c); }
+static void cond_release(gallery_cond* c)   { (void)c; }
+static void cond_wait(gallery_cond* c, gallery_mutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void cond_signal(gallery_cond* c)    { WakeConditionVariable(c); }
+#else
+typedef pthread_t gallery_thread;
+typedef pthread_mutex_t gallery_mutex;
+typedef pthread_cond_t gallery_cond;
+
+static void* gallery_loader(void* arg);
+
+static bool thread_start(gallery_thread* thrd)
+{
+    return pthread_create(thrd, NULL, gallery_loader, NULL) == 0;
+}
+
+static void thread_join(gallery_thread thrd)
+{
+    pthread_join(thrd, NULL);
+}
+
+static void mutex_init(gallery_mutex* m)    { pthread_mutex_init(m, NULL); }
+static void mutex_release(gallery_mutex* m) { pthread_mutex_destroy(m); }
+static void mutex_lock(gallery_mutex* m)    { pthread_mutex_lock(m); }
+static void mutex_unlock(gallery_mutex* m)  { pthread_mutex_unlock(m); }
+static void cond_init(gallery_cond* c)      { pthread_cond_init(c, NULL); }
+static void cond_release(gallery_cond* c)   { pthread_cond_destroy(c); }
+static void cond_wait(gallery_cond* c, gallery_mutex* m) { pthread_cond_wait(c, m); }
+static void cond_signal(gallery_cond* c)    { pthread_cond_signal(c); }
+#endif
+
+typedef enum gallery_file_state
+{
+    GALLERY_FILE_PENDING = 0,
+    GALLERY_FILE_LOADING,       // owned by the loader thread
+    GALLERY_FILE_READY,         // mapped and parsed
+    GALLERY_FILE_FAILED
+} gallery_file_state;
+
+typedef struct gallery_file
+{
+    char* path;
+    gallery_file_state state;
+    ddsktx_mmap_file file;
+    ddsktx_texture_info texinfo;
+    bool skip_prefetch;         // didn't fit in the cache (or isn't supported), retried when the current file changes
+    char error[128];
+} gallery_file;
+
+typedef struct gallery_image
+{
+    int file_idx;
+    sg_image img;
+    sg_image_type type;
+    ddsktx_texture_info texinfo;
+    int64_t bytes;
+    uint64_t last_used;
+} gallery_image;
+
+// gallery mode: files are mapped and parsed by a loader thread, nearest to the current one first, 
+// and the uploaded images are kept in an LRU cache that is limited by GPU memory
+typedef struct gallery_state
+{
+    gallery_file* files;
+    int num_files;
+    int cur;                    // protected by 'mutex', together with the file states
+    bool waiting;               // current file is not loaded yet
+    gallery_image cache[GALLERY_CACHE_SIZE];
+    int num_cached;
+    int64_t cache_bytes;
+    int64_t cache_budget;
+    uint64_t use_counter;
+    gallery_thread thread;
+    gallery_mutex mutex;
+    gallery_cond wake;
+    bool quit;
+} gallery_state;
+
+gallery_state g_gallery;
+
 static const vertex k_vertices[] = {
     { -1.0f, -1.0f, 0.0f, 1.0f, 0 },
     {  1.0f, -1.0f, 1.0f, 1.0f, 0 },
@@ -301,6 +448,279 @@ static sg_image create_checker_texture(int checker_size, int size, uint32_t colo
 }
 
 
+static uint64_t hash_fnv1a(const void* data, int size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (int i = 0; i < size; i++) {
+        h = (h ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+static bool file_stamp(const char* filepath, int64_t* mtime, int64_t* size)
+{
+    struct stat st;
+    if (stat(filepath, &st) != 0) {
+        return false;
+    }
+    *mtime = (int64_t)st.st_mtime;
+    *size = (int64_t)st.st_size;
+    return true;
+}
+
+static bool same_layout(const sg_image_desc* a, const sg_image_desc* b)
+{
+    return a->type == b->type && a->width == b->width && a->height == b->height && a->depth == b->depth &&
+           a->num_mipmaps == b->num_mipmaps && a->pixel_format == b->pixel_format;
+}
+
+static sg_image make_texture(const sg_image_desc* desc, bool dynamic)
+{
+    if (!dynamic) {
+        return sg_make_image(desc);
+    }
+
+    sg_image_desc dyn_desc = *desc;
+    memset(&dyn_desc.content, 0x0, sizeof(dyn_desc.content));
+    dyn_desc.usage = SG_USAGE_DYNAMIC;
+    sg_image img = sg_make_image(&dyn_desc);
+    sg_update_image(img, &desc->content);
+    return img;
+}
+
+static int64_t level_size(const sg_image_desc* desc, int mip)
+{
+    int num_faces = desc->type == SG_IMAGETYPE_CUBE ? DDSKTX_CUBE_FACE_COUNT : 1;
+    int64_t size = 0;
+    for (int face = 0; face < num_faces; face++) {
+        size += desc->content.subimage[face][mip].size;
+    }
+    return size;
+}
+
+static void stop_streaming(void)
+{
+    if (g_state.streaming) {
+        ddsktx_sg_free_mem(g_state.stream_mem);
+        g_state.stream_mem = NULL;
+        g_state.streaming = false;
+    }
+}
+
+// progressive mode: re-creates the texture with the next larger mips, as many as fit in the per-frame budget
+// (at least one). sokol_gfx images can't get mips added, so the smaller mips are uploaded again, which is at 
+// most a third of the size of the new mips
+static void stream_mips(void)
+{
+    if (!g_state.streaming) {
+        return;
+    }
+
+    const sg_image_desc* full = &g_state.stream_desc;
+    int mip = g_state.resident_mip;
+    int64_t budget = UPLOAD_BUDGET;
+    do {
+        mip--;
+        budget -= level_size(full, mip);
+        g_state.resident_bytes += level_size(full, mip);
+    } while (mip > 0 && level_size(full, mip - 1) <= budget);
+
+    sg_image_desc desc = *full;
+    desc.width = (full->width >> mip) > 0 ? (full->width >> mip) : 1;
+    desc.height = (full->height >> mip) > 0 ? (full->height >> mip) : 1;
+    desc.num_mipmaps = full->num_mipmaps - mip;
+    if (desc.type == SG_IMAGETYPE_3D) {
+        desc.depth = (full->depth >> mip) > 0 ? (full->depth >> mip) : 1;
+    }
+    memset(&desc.content, 0x0, sizeof(desc.content));
+    for (int face = 0; face < DDSKTX_CUBE_FACE_COUNT; face++) {
+        for (int i = 0; i < desc.num_mipmaps; i++) {
+            desc.content.subimage[face][i] = full->content.subimage[face][mip + i];
+        }
+    }
+
+    sg_image tex = make_texture(&desc, mip == 0 && g_state.tex_dynamic);
+    if (g_state.tex.id != SG_INVALID_ID) {
+        sg_destroy_image(g_state.tex);
+    }
+    g_state.tex = tex;
+    g_state.resident_mip = mip;
+
+    if (mip == 0) {
+        g_state.tex_layout = *full;
+        memset(&g_state.tex_layout.content, 0x0, sizeof(g_state.tex_layout.content));
+        stop_streaming();
+    }
+}
+
+// all the array layers (depth slices) go to one array (3D) image, so browsing them only changes a uniform
+// cube arrays (no support in sokol_gfx) and images that exceed the limits of the backend show the first layer
+static int texture_layer(const ddsktx_texture_info* tc)
+{
+    sg_features features = sg_query_features();
+    sg_limits limits = sg_query_limits();
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
+        return 0;
+    } else if (tc->depth > 1) {
+        int max_size = (int)limits.max_image_size_3d;
+        return (features.imagetype_3d && tc->width <= max_size && tc->height <= max_size && tc->depth <= max_size) ?
+            DDSKTX_SG_ALL_LAYERS : 0;
+    } else if (tc->num_layers > 1) {
+        int max_size = (int)limits.max_image_size_array;
+        return (features.imagetype_array && tc->width <= max_size && tc->height <= max_size && 
+                tc->num_layers <= (int)limits.max_image_array_layers) ? DDSKTX_SG_ALL_LAYERS : 0;
+    }
+    return 0;
+}
+
+// creates (or updates) the texture from the mapped file
+// in watch mode, uncompressed images are dynamic, so reloads with the same layout only upload the data again,
+// and the data is hashed per face/mip, so nothing is uploaded if the file is touched but not changed
+// sokol_gfx can't update compressed images, those are re-created if any of the subresources have changed
+// in progressive mode, new images start with the smallest mips, larger ones are added by stream_mips
+static bool upload_texture(void)
+{
+    // a pending stream points to the previous file
+    stop_streaming();
+
+    // read-ahead the mips that are uploaded, instead of faulting the pages in one by one
+    ddsktx_mmap_prefetch_mips(&g_state.file, &g_state.texinfo, 0, SG_MAX_MIPMAPS);
+
+    sg_image_desc desc = {
+        .min_filter = SG_FILTER_NEAREST,
+        .mag_filter = SG_FILTER_NEAREST
+    };
+    void* mem;
+    if (!ddsktx_sg_image_desc(&g_state.texinfo, g_state.file.data, texture_layer(&g_state.texinfo), &desc, &mem)) {
+        return false;
+    }
+
+    bool reuse = g_state.tex.id != SG_INVALID_ID && same_layout(&desc, &g_state.tex_layout);
+    if (!reuse) {
+        memset(g_state.sub_hashes, 0x0, sizeof(g_state.sub_hashes));
+    }
+
+    int num_faces = desc.type == SG_IMAGETYPE_CUBE ? DDSKTX_CUBE_FACE_COUNT : 1;
+    int num_subs = num_faces*desc.num_mipmaps;
+    int num_changed = num_subs;
+    if (g_state.watch) {
+        num_changed = 0;
+        for (int face = 0; face < num_faces; face++) {
+            for (int mip = 0; mip < desc.num_mipmaps; mip++) {
+                const sg_subimage_content* sub = &desc.content.subimage[face][mip];
+                uint64_t h = hash_fnv1a(sub->ptr, sub->size);
+                if (h != g_state.sub_hashes[face][mip]) {
+                    g_state.sub_hashes[face][mip] = h;
+                    num_changed++;
+                }
+            }
+        }
+    }
+
+    if (reuse && num_changed == 0) {
+        snprintf(g_state.status, sizeof(g_state.status), "reloaded: no changes");
+    } else if (reuse && g_state.tex_dynamic) {
+        sg_update_image(g_state.tex, &desc.content);
+        snprintf(g_state.status, sizeof(g_state.status), "reloaded: updated (%d/%d changed)", num_changed, num_subs);
+    } else {
+        if (g_state.tex.id != SG_INVALID_ID) {
+            sg_destroy_image(g_state.tex);
+            g_state.tex.id = SG_INVALID_ID;
+            snprintf(g_state.status, sizeof(g_state.status), "reloaded: %s (%d/%d changed)", 
+                     reuse ? "recreated" : "new layout", num_changed, num_subs);
+        }
+
+        bool compressed = ddsktx_format_compressed(g_state.texinfo.format) &&
+            desc.pixel_format == ddsktx_sg_pixel_format(g_state.texinfo.format, g_state.texinfo.flags);
+        g_state.tex_dynamic = g_state.watch && !compressed;
+        g_state.tex_type = desc.type;
+
+        if (g_state.progressive && desc.num_mipmaps > 1) {
+            // memory is freed when all the mips are resident
+            memset(&g_state.tex_layout, 0x0, sizeof(g_state.tex_layout));
+            g_state.stream_desc = desc;
+            g_state.stream_mem = mem;
+            g_state.streaming = true;
+            g_state.resident_mip = desc.num_mipmaps;
+            g_state.resident_bytes = 0;
+            g_state.total_bytes = 0;
+            for (int mip = 0; mip < desc.num_mipmaps; mip++) {
+                g_state.total_bytes += level_size(&desc, mip);
+            }
+            stream_mips();
+            return g_state.tex.id != SG_INVALID_ID;
+        }
+
+        g_state.tex = make_texture(&desc, g_state.tex_dynamic);
+        g_state.resident_mip = 0;
+        g_state.tex_layout = desc;
+        memset(&g_state.tex_layout.content, 0x0, sizeof(g_state.tex_layout.content));
+    }
+
+    ddsktx_sg_free_mem(mem);
+    return g_state.tex.id != SG_INVALID_ID;
+}
+
+// keeps the current mip/layer/slice in the range of the (new) texture
+static void clamp_view(bool cubemap_changed)
+{
+    const ddsktx_texture_info* tc = &g_state.texinfo;
+    g_state.cur_mip = g_state.cur_mip < tc->num_mips ? g_state.cur_mip : (tc->num_mips - 1);
+    g_state.cur_layer = g_state.cur_layer < tc->num_layers ? g_state.cur_layer : (tc->num_layers - 1);
+    g_state.cur_slice = g_state.cur_slice < tc->depth ? g_state.cur_slice : (tc->depth - 1);
+    if (cubemap_changed) {
+        g_state.cube_face = 0;
+        if (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
+            set_cube_face(0);
+        } else {
+            sg_update_buffer(g_state.vb, k_vertices, sizeof(k_vertices));
+        }
+    }
+}
+
+// watch mode: re-parses the file if it's modified, the texture is replaced only if the new file is valid
+// if the file is still being written (can't be parsed), the previous texture stays and it's checked again later
+static void check_file_changes(void)
+{
+    int64_t mtime, size;
+    if (!file_stamp(g_state.filepath, &mtime, &size) || 
+        (mtime == g_state.file_mtime && size == g_state.file_size)) {
+        return;
+    }
+
+    ddsktx_mmap_file file;
+    ddsktx_texture_info tc = {0};
+    if (!ddsktx_mmap_open(&file, g_state.filepath)) {
+        return;
+    }
+    if (!ddsktx_parse64(&tc, file.data, file.size, NULL)) {
+        ddsktx_mmap_close(&file);
+        return;
+    }
+
+    bool cubemap_changed = (tc.flags ^ g_state.texinfo.flags) & DDSKTX_TEXTURE_FLAG_CUBEMAP;
+    ddsktx_mmap_file old_file = g_state.file;
+    ddsktx_texture_info old_tc = g_state.texinfo;
+    g_state.file = file;
+    g_state.texinfo = tc;
+
+    if (!upload_texture()) {
+        // keep the previous texture and leave the stamp alone, so the next poll retries
+        g_state.file = old_file;
+        g_state.texinfo = old_tc;
+        ddsktx_mmap_close(&file);
+        snprintf(g_state.status, sizeof(g_state.status), "reload failed: '%s' is not supported, retrying",
+                 ddsktx_format_str(tc.format));
+        return;
+    }
+
+    ddsktx_mmap_close(&old_file);
+    g_state.file_mtime = mtime;
+    g_state.file_size = size;
+    clamp_view(cubemap_changed);
+}
+
 static void print_msg(const char* fmt, ...)
 {
     char msg[1024];
@@ -316,6 +736,371 @@ static void print_msg(const char* fmt, ...)
     #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// gallery mode
+static bool has_texture_ext(const char* path)
+{
+    const char* ext = strrchr(path, '.');
+    if (!ext) {
+        return false;
+    }
+    char lower[8] = {0};
+    for (int i = 0; i < 7 && ext[i]; i++) {
+        lower[i] = (ext[i] >= 'A' && ext[i] <= 'Z') ? (char)(ext[i] - 'A' + 'a') : ext[i];
+    }
+    return strcmp(lower, ".dds") == 0 || strcmp(lower, ".ktx") == 0 || strcmp(lower, ".ktx2") == 0;
+}
+
+static void gallery_add_file(const char* dir, const char* name)
+{
+    gallery_file* files = (gallery_file*)realloc(g_gallery.files, sizeof(gallery_file)*(g_gallery.num_files + 1));
+    size_t len = strlen(dir) + strlen(name) + 1;
+    char* path = (char*)malloc(len);
+    if (!files || !path) {
+        print_msg("Error: out of memory");
+        exit(-1);
+    }
+    snprintf(path, len, "%s%s", dir, name);
+
+    g_gallery.files = files;
+    gallery_file* f = &files[g_gallery.num_files++];
+    memset(f, 0x0, sizeof(gallery_file));
+    f->path = path;
+}
+
+static int compare_files(const void* a, const void* b)
+{
+    return strcmp(((const gallery_file*)a)->path, ((const gallery_file*)b)->path);
+}
+
+// adds a file, or the textures in a directory (not recursive), or a wildcard pattern on windows (the shell 
+// expands them on other platforms). returns true if the path was a directory or a pattern
+static bool gallery_add_path(const char* path)
+{
+    int first = g_gallery.num_files;
+#if defined(_WIN32) || defined(_WIN64)
+    char pattern[MAX_PATH];
+    char dir[MAX_PATH];
+    if (strpbrk(path, "*?")) {
+        snprintf(pattern, sizeof(pattern), "%s", path);
+        snprintf(dir, sizeof(dir), "%s", path);
+        char* sep = strrchr(dir, '\\');
+        char* sep2 = strrchr(dir, '/');
+        if (!sep || (sep2 && sep2 > sep)) {
+            sep = sep2;
+        }
+        *(sep ? (sep + 1) : dir) = '\0';
+    } else {
+        DWORD attrs = GetFileAttributesA(path);
+        if (attrs == INVALID_FILE_ATTRIBUTES || !(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+            gallery_add_file("", path);
+            return false;
+        }
+        snprintf(pattern, sizeof(pattern), "%s\\*", path);
+        snprintf(dir, sizeof(dir), "%s\\", path);
+    }
+
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA(pattern, &fd);
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && has_texture_ext(fd.cFileName)) {
+                gallery_add_file(dir, fd.cFileName);
+            }
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+    }
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        gallery_add_file("", path);
+        return false;
+    }
+
+    size_t dir_len = strlen(path) + 2;
+    char* dir = (char*)malloc(dir_len);
+    DIR* d = opendir(path);
+    if (dir && d) {
+        snprintf(dir, dir_len, "%s/", path);
+        struct dirent* e;
+        while ((e = readdir(d)) != NULL) {
+            if (!has_texture_ext(e->d_name)) {
+                continue;
+            }
+            gallery_add_file(dir, e->d_name);
+            gallery_file* f = &g_gallery.files[g_gallery.num_files - 1];
+            if (stat(f->path, &st) != 0 || !S_ISREG(st.st_mode)) {
+                free(f->path);
+                g_gallery.num_files--;
+            }
+        }
+    }
+    if (d) {
+        closedir(d);
+    }
+    free(dir);
+#endif
+
+    qsort(g_gallery.files + first, (size_t)(g_gallery.num_files - first), sizeof(gallery_file), compare_files);
+    return true;
+}
+
+// next file to load, nearest to the current one first. must be called with the mutex locked
+static int gallery_next_pending(void)
+{
+    for (int d = 0; d <= GALLERY_PREFETCH; d++) {
+        int next = g_gallery.cur + d;
+        int prev = g_gallery.cur - d;
+        if (next < g_gallery.num_files && g_gallery.files[next].state == GALLERY_FILE_PENDING) {
+            return next;
+        }
+        if (prev >= 0 && g_gallery.files[prev].state == GALLERY_FILE_PENDING) {
+            return prev;
+        }
+    }
+    return -1;
+}
+
+// loader thread: maps and parses the files around the current one, and reads-ahead their mips, so uploading
+// on the main thread doesn't wait on the disk. files are parsed with ddsktx_parse_strict, a broken file in the 
+// directory only shows an error
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI gallery_loader(LPVOID arg)
+#else
+static void* gallery_loader(void* arg)
+#endif
+{
+    (void)arg;
+    mutex_lock(&g_gallery.mutex);
+    while (!g_gallery.quit) {
+        int index = gallery_next_pending();
+        if (index < 0) {
+            cond_wait(&g_gallery.wake, &g_gallery.mutex);
+            continue;
+        }
+
+        // the main thread doesn't touch files while they are loading
+        gallery_file* f = &g_gallery.files[index];
+        f->state = GALLERY_FILE_LOADING;
+        mutex_unlock(&g_gallery.mutex);
+
+        gallery_file_state state = GALLERY_FILE_FAILED;
+        ddsktx_error err;
+        if (!ddsktx_mmap_open(&f->file, f->path)) {
+            snprintf(f->error, sizeof(f->error), "could not open file (or it's empty)");
+        } else if (!ddsktx_parse_strict(&f->texinfo, f->file.data, f->file.size, &err)) {
+            snprintf(f->error, sizeof(f->error), "%s", err.msg);
+            ddsktx_mmap_close(&f->file);
+        } else {
+            ddsktx_mmap_prefetch_mips(&f->file, &f->texinfo, 0, f->texinfo.num_mips);
+            state = GALLERY_FILE_READY;
+        }
+
+        mutex_lock(&g_gallery.mutex);
+        f->state = state;
+    }
+    mutex_unlock(&g_gallery.mutex);
+    return 0;
+}
+
+static int gallery_find_image(int file_idx)
+{
+    for (int i = 0; i < g_gallery.num_cached; i++) {
+        if (g_gallery.cache[i].file_idx == file_idx) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void gallery_evict(int index)
+{
+    sg_destroy_image(g_gallery.cache[index].img);
+    g_gallery.cache_bytes -= g_gallery.cache[index].bytes;
+    g_gallery.cache[index] = g_gallery.cache[--g_gallery.num_cached];
+}
+
+// uploads a loaded file to a new cache entry, returns the entry or -1 if the texture isn't supported or 
+// doesn't fit. with 'evict', the least recently used images (except the current one) are destroyed until 
+// the new one fits in the budget, a single image that is larger than the budget is still uploaded
+static int gallery_upload(int file_idx, bool evict)
+{
+    const gallery_file* f = &g_gallery.files[file_idx];
+    sg_image_desc desc = {
+        .min_filter = SG_FILTER_NEAREST,
+        .mag_filter = SG_FILTER_NEAREST
+    };
+    void* mem;
+    if (!ddsktx_sg_image_desc(&f->texinfo, f->file.data, texture_layer(&f->texinfo), &desc, &mem)) {
+        return -1;
+    }
+
+    int64_t bytes = 0;
+    for (int mip = 0; mip < desc.num_mipmaps; mip++) {
+        bytes += level_size(&desc, mip);
+    }
+
+    while (g_gallery.num_cached > 0 && 
+           (g_gallery.num_cached == GALLERY_CACHE_SIZE || g_gallery.cache_bytes + bytes > g_gallery.cache_budget)) {
+        int lru = -1;
+        for (int i = 0; evict && i < g_gallery.num_cached; i++) {
+            if (g_gallery.cache[i].file_idx != g_gallery.cur && 
+                (lru < 0 || g_gallery.cache[i].last_used < g_gallery.cache[lru].last_used)) {
+                lru = i;
+            }
+        }
+        if (lru < 0) {
+            ddsktx_sg_free_mem(mem);
+            return -1;
+        }
+        gallery_evict(lru);
+    }
+
+    sg_image img = sg_make_image(&desc);
+    ddsktx_sg_free_mem(mem);
+    if (img.id == SG_INVALID_ID) {
+        return -1;
+    }
+
+    int index = g_gallery.num_cached++;
+    g_gallery.cache[index] = (gallery_image) {
+        .file_idx = file_idx,
+        .img = img,
+        .type = desc.type,
+        .texinfo = f->texinfo,
+        .bytes = bytes,
+        .last_used = ++g_gallery.use_counter
+    };
+    g_gallery.cache_bytes += bytes;
+    return index;
+}
+
+// makes 'index' the current file, from the cache if it's already uploaded. if it's still loading, the previous
+// texture stays on screen and gallery_update tries again on the next frames
+static void gallery_show(int index)
+{
+    g_gallery.waiting = false;
+
+    mutex_lock(&g_gallery.mutex);
+    if (g_gallery.cur != index) {
+        for (int i = 0; i < g_gallery.num_files; i++) {
+            g_gallery.files[i].skip_prefetch = false;
+        }
+    }
+    g_gallery.cur = index;
+
+    // files that are far from the current one are unmapped (their cached images stay), they are mapped again
+    // when they get close
+    for (int i = 0; i < g_gallery.num_files; i++) {
+        gallery_file* f = &g_gallery.files[i];
+        if (f->state == GALLERY_FILE_READY && (i < index - GALLERY_KEEP_MAPPED || i > index + GALLERY_KEEP_MAPPED)) {
+            ddsktx_mmap_close(&f->file);
+            f->state = GALLERY_FILE_PENDING;
+        }
+    }
+    gallery_file_state state = g_gallery.files[index].state;
+    cond_signal(&g_gallery.wake);
+    mutex_unlock(&g_gallery.mutex);
+
+    const gallery_file* f = &g_gallery.files[index];
+    int slot = gallery_find_image(index);
+    if (slot < 0) {
+        if (state == GALLERY_FILE_PENDING || state == GALLERY_FILE_LOADING) {
+            g_gallery.waiting = true;
+            snprintf(g_state.status, sizeof(g_state.status), "loading ...");
+            return;
+        }
+
+        if (state == GALLERY_FILE_READY) {
+            slot = gallery_upload(index, true);
+        }
+        if (slot < 0) {
+            g_state.tex.id = SG_INVALID_ID;
+            if (state == GALLERY_FILE_FAILED) {
+                snprintf(g_state.status, sizeof(g_state.status), "error: %s", f->error);
+            } else {
+                snprintf(g_state.status, sizeof(g_state.status), "error: texture format '%s' is not supported",
+                         ddsktx_format_str(f->texinfo.format));
+            }
+            return;
+        }
+    }
+
+    gallery_image* img = &g_gallery.cache[slot];
+    img->last_used = ++g_gallery.use_counter;
+
+    bool cubemap_changed = (img->texinfo.flags ^ g_state.texinfo.flags) & DDSKTX_TEXTURE_FLAG_CUBEMAP;
+    g_state.texinfo = img->texinfo;
+    g_state.tex = img->img;
+    g_state.tex_type = img->type;
+    g_state.resident_mip = 0;
+    g_state.status[0] = '\0';
+    clamp_view(cubemap_changed);
+}
+
+// called every frame: shows the current file when it's loaded, or uploads one of the loaded neighbours,
+// only if it fits in the cache without evicting anything
+static void gallery_update(void)
+{
+    if (g_gallery.waiting) {
+        gallery_show(g_gallery.cur);
+        return;
+    }
+
+    int next = -1;
+    mutex_lock(&g_gallery.mutex);
+    for (int d = 1; d <= GALLERY_PREFETCH && next < 0; d++) {
+        int indices[2] = { g_gallery.cur + d, g_gallery.cur - d };
+        for (int i = 0; i < 2 && next < 0; i++) {
+            int index = indices[i];
+            if (index >= 0 && index < g_gallery.num_files && g_gallery.files[index].state == GALLERY_FILE_READY &&
+                !g_gallery.files[index].skip_prefetch && gallery_find_image(index) < 0) {
+                next = index;
+            }
+        }
+    }
+    mutex_unlock(&g_gallery.mutex);
+
+    if (next >= 0 && gallery_upload(next, false) < 0) {
+        g_gallery.files[next].skip_prefetch = true;
+    }
+}
+
+static void gallery_start(void)
+{
+    mutex_init(&g_gallery.mutex);
+    cond_init(&g_gallery.wake);
+    if (!thread_start(&g_gallery.thread)) {
+        print_msg("Error: could not start the loader thread");
+        exit(-1);
+    }
+    gallery_show(0);
+}
+
+static void gallery_stop(void)
+{
+    mutex_lock(&g_gallery.mutex);
+    g_gallery.quit = true;
+    cond_signal(&g_gallery.wake);
+    mutex_unlock(&g_gallery.mutex);
+    thread_join(g_gallery.thread);
+    mutex_release(&g_gallery.mutex);
+    cond_release(&g_gallery.wake);
+
+    while (g_gallery.num_cached > 0) {
+        gallery_evict(g_gallery.num_cached - 1);
+    }
+    g_state.tex.id = SG_INVALID_ID;
+
+    for (int i = 0; i < g_gallery.num_files; i++) {
+        ddsktx_mmap_close(&g_gallery.files[i].file);
+        free(g_gallery.files[i].path);
+    }
+    free(g_gallery.files);
+    g_gallery.files = NULL;
+    g_gallery.num_files = 0;
+}
+
 static sg_shader_desc get_shader_desc(const void* vs_data, uint32_t vs_size, const void* fs_data, 
                                       uint32_t fs_size, sg_image_type imgtype)
 {
@@ -410,6 +1195,18 @@ static void init(void)
         g_state.shader_cubemap = sg_make_shader(&desc);
     }
 
+    {
+        sg_shader_desc desc = get_shader_desc(quad_vs_data, quad_vs_size, quad_array_fs_data, 
+                                              quad_array_fs_size, SG_IMAGETYPE_ARRAY);
+        g_state.shader_array = sg_make_shader(&desc);
+    }
+
+    {
+        sg_shader_desc desc = get_shader_desc(quad_vs_data, quad_vs_size, quad_volume_fs_data, 
+                                              quad_volume_fs_size, SG_IMAGETYPE_3D);
+        g_state.shader_volume = sg_make_shader(&desc);
+    }
+
     sg_pipeline_desc pip_desc = (sg_pipeline_desc) {
         .layout = {
             .buffers[0] = {
@@ -442,6 +1239,16 @@ static void init(void)
         g_state.pip_cubemap = sg_make_pipeline(&pip_desc);
     }
 
+    {
+        pip_desc.shader = g_state.shader_array;
+        g_state.pip_array = sg_make_pipeline(&pip_desc);
+    }
+
+    {
+        pip_desc.shader = g_state.shader_volume;
+        g_state.pip_volume = sg_make_pipeline(&pip_desc);
+    }
+
     // main texture (dds-ktx)
     if (imgtype == SG_IMAGETYPE_CUBE) {
         set_cube_face(0);
@@ -451,57 +1258,13 @@ static void init(void)
 
     adjust_checker_coords(sapp_width(), sapp_height());
 
-    sg_image_desc desc = {
-        .type = imgtype,
-        .width = g_state.texinfo.width,
-        .height = g_state.texinfo.height,
-        .depth = 1,
-        .num_mipmaps = g_state.texinfo.num_mips,
-        .min_filter = SG_FILTER_NEAREST,
-        .mag_filter = SG_FILTER_NEAREST
-    };
-
-    switch (g_state.texinfo.format) {
-    case DDSKTX_FORMAT_BC1:     desc.pixel_format = SG_PIXELFORMAT_BC1_RGBA; break;
-    case DDSKTX_FORMAT_BC2:     desc.pixel_format = SG_PIXELFORMAT_BC2_RGBA; break;
-    case DDSKTX_FORMAT_BC3:     desc.pixel_format = SG_PIXELFORMAT_BC3_RGBA; break;
-    case DDSKTX_FORMAT_BC4:     desc.pixel_format = SG_PIXELFORMAT_BC4_R; break;
-    case DDSKTX_FORMAT_BC5:     desc.pixel_format = SG_PIXELFORMAT_BC5_RG; break;
-    case DDSKTX_FORMAT_BC6H:    desc.pixel_format = SG_PIXELFORMAT_BC6H_RGBF; break;
-    case DDSKTX_FORMAT_BC7:     desc.pixel_format = SG_PIXELFORMAT_BC7_RGBA; break;
-    case DDSKTX_FORMAT_A8:      
-    case DDSKTX_FORMAT_R8:      desc.pixel_format = SG_PIXELFORMAT_R8; break;
-    case DDSKTX_FORMAT_RGBA8:
-    case DDSKTX_FORMAT_RGBA8S:   desc.pixel_format = SG_PIXELFORMAT_RGBA8; break;
-    case DDSKTX_FORMAT_RG16:     desc.pixel_format = SG_PIXELFORMAT_RG16; break;
-    case DDSKTX_FORMAT_RGB8:     desc.pixel_format = SG_PIXELFORMAT_RGBA8; break;
-    case DDSKTX_FORMAT_R16:      desc.pixel_format = SG_PIXELFORMAT_R16; break;
-    case DDSKTX_FORMAT_R32F:     desc.pixel_format = SG_PIXELFORMAT_R32F; break;
-    case DDSKTX_FORMAT_R16F:     desc.pixel_format = SG_PIXELFORMAT_R16F; break;
-    case DDSKTX_FORMAT_RG16F:    desc.pixel_format = SG_PIXELFORMAT_RG16F; break;
-    case DDSKTX_FORMAT_RG16S:    desc.pixel_format = SG_PIXELFORMAT_RG16; break;
-    case DDSKTX_FORMAT_RGBA16F:  desc.pixel_format = SG_PIXELFORMAT_RGBA16F; break;
-    case DDSKTX_FORMAT_RGBA16:   desc.pixel_format = SG_PIXELFORMAT_RGBA16; break;
-    case DDSKTX_FORMAT_BGRA8:    desc.pixel_format = SG_PIXELFORMAT_BGRA8; break;
-    case DDSKTX_FORMAT_RGB10A2:  desc.pixel_format = SG_PIXELFORMAT_RGB10A2; break;
-    case DDSKTX_FORMAT_RG11B10F: desc.pixel_format = SG_PIXELFORMAT_RG11B10F; break;
-    case DDSKTX_FORMAT_RG8:      desc.pixel_format = SG_PIXELFORMAT_RG8; break;
-    case DDSKTX_FORMAT_RG8S:     desc.pixel_format = SG_PIXELFORMAT_RG8; break;
-    default:    assert(0); exit(-1);
-    }    
-
-    int num_faces = imgtype == SG_IMAGETYPE_CUBE ? 6 : 1;
-    for (int face = 0; face < num_faces; face++) {
-        for (int mip = 0; mip < g_state.texinfo.num_mips; mip++) {
-            ddsktx_sub_data subdata;
-            ddsktx_get_sub(&g_state.texinfo, &subdata, g_state.file_data, g_state.file_size, 0, face, mip);
-            desc.content.subimage[face][mip].ptr = subdata.buff;
-            desc.content.subimage[face][mip].size = subdata.size_bytes;
-        }
+    if (g_gallery.num_files > 0) {
+        gallery_start();
+    } else if (!upload_texture()) {
+        print_msg("Error: texture format '%s' is not supported", ddsktx_format_str(g_state.texinfo.format));
+        exit(-1);
     }
 
-    g_state.tex = sg_make_image(&desc);
-
     sdtx_setup(&(sdtx_desc_t) {
         .fonts = {
             [0] = sdtx_font_c64(),
@@ -525,7 +1288,9 @@ static const char* texture_type_info()
     if (g_state.texinfo.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
         snprintf(info, sizeof(info), "Cube (%s)", k_cube_face_names[g_state.cube_face]);
     } else if (g_state.texinfo.depth > 1) {
-        snprintf(info, sizeof(info), "3D (%d/%d)", g_state.cur_slice, g_state.texinfo.depth);
+        snprintf(info, sizeof(info), "3D (%d/%d)", g_state.cur_slice + 1, g_state.texinfo.depth);
+    } else if (g_state.texinfo.num_layers > 1) {
+        snprintf(info, sizeof(info), "Array (%d/%d)", g_state.cur_layer + 1, g_state.texinfo.num_layers);
     } else {
         strcpy(info, "2D");
     }
@@ -536,24 +1301,58 @@ static const char* texture_type_info()
 
 static void frame(void) 
 {
+    if (g_state.watch && ++g_state.watch_frame >= WATCH_INTERVAL) {
+        g_state.watch_frame = 0;
+        check_file_changes();
+    }
+    stream_mips();
+    if (g_gallery.num_files > 0) {
+        gallery_update();
+    }
+
     sdtx_home();
     sdtx_origin(1, 1);
     sdtx_pos(0, 0);
     sdtx_color3b(!g_state.inv_text_color ? 255 : 0, !g_state.inv_text_color ? 255 : 0, 0);
 
-    sdtx_printf("%s\t%dx%d (mip %d/%d)", 
-                ddsktx_format_str(g_state.texinfo.format), g_state.texinfo.width, 
-                g_state.texinfo.height, g_state.cur_mip + 1, g_state.texinfo.num_mips);
-    sdtx_crlf();
-    sdtx_printf("%s\tmask: %c%c%c%c\t", 
-                texture_type_info(),
-                g_state.vars_fs.color[0] == 1.0f ? 'R' : 'X',
-                g_state.vars_fs.color[1] == 1.0f ? 'G' : 'X',
-                g_state.vars_fs.color[2] == 1.0f ? 'B' : 'X',
-                g_state.vars_fs.color[3] == 1.0f ? 'A' : 'X');
-    sdtx_crlf();
+    if (g_gallery.num_files > 0) {
+        sdtx_printf("%d/%d\t%s", g_gallery.cur + 1, g_gallery.num_files, g_gallery.files[g_gallery.cur].path);
+        sdtx_crlf();
+        sdtx_printf("cache: %d images, %d/%d MB\t%s", g_gallery.num_cached, (int)(g_gallery.cache_bytes >> 20),
+                    (int)(g_gallery.cache_budget >> 20), g_state.status);
+        sdtx_crlf();
+    }
+    if (g_state.tex.id) {
+        sdtx_printf("%s\t%dx%d (mip %d/%d)", 
+                    ddsktx_format_str(g_state.texinfo.format), g_state.texinfo.width, 
+                    g_state.texinfo.height, g_state.cur_mip + 1, g_state.texinfo.num_mips);
+        sdtx_crlf();
+        sdtx_printf("%s\tmask: %c%c%c%c\t", 
+                    texture_type_info(),
+                    g_state.vars_fs.color[0] == 1.0f ? 'R' : 'X',
+                    g_state.vars_fs.color[1] == 1.0f ? 'G' : 'X',
+                    g_state.vars_fs.color[2] == 1.0f ? 'B' : 'X',
+                    g_state.vars_fs.color[3] == 1.0f ? 'A' : 'X');
+        sdtx_crlf();
+    }
+    if (g_state.watch) {
+        sdtx_printf("watching\t%s", g_state.status);
+        sdtx_crlf();
+    }
+    if (g_state.streaming) {
+        sdtx_printf("resident: mips %d-%d (%d%%)", g_state.resident_mip + 1, g_state.stream_desc.num_mipmaps,
+                    (int)(g_state.resident_bytes*100/g_state.total_bytes));
+        sdtx_crlf();
+    }
 
-    g_state.vars_fs.args[0] = (float)g_state.cur_mip;
+    // shows the nearest resident mip, until the current one is streamed in
+    g_state.vars_fs.args[0] = (float)(g_state.cur_mip > g_state.resident_mip ? 
+                                      (g_state.cur_mip - g_state.resident_mip) : 0);
+    if (g_state.tex_type == SG_IMAGETYPE_ARRAY) {
+        g_state.vars_fs.args[1] = (float)g_state.cur_layer;
+    } else if (g_state.tex_type == SG_IMAGETYPE_3D) {
+        g_state.vars_fs.args[1] = ((float)g_state.cur_slice + 0.5f) / (float)g_state.texinfo.depth;
+    }
 
     sg_begin_default_pass(&g_state.pass_action, sapp_width(), sapp_height());
     if (g_state.tex.id) {
@@ -608,7 +1407,12 @@ static void frame(void)
 
         sg_apply_viewport((sapp_width() - w)/2, (sapp_height() - h)/2, w, h, true);
 
-        sg_apply_pipeline((g_state.texinfo.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? g_state.pip_cubemap : g_state.pip);
+        switch (g_state.tex_type) {
+        case SG_IMAGETYPE_CUBE:     sg_apply_pipeline(g_state.pip_cubemap);    break;
+        case SG_IMAGETYPE_ARRAY:    sg_apply_pipeline(g_state.pip_array);      break;
+        case SG_IMAGETYPE_3D:       sg_apply_pipeline(g_state.pip_volume);     break;
+        default:                    sg_apply_pipeline(g_state.pip);            break;
+        }
         sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, &uvs, sizeof(uvs));
         sg_apply_uniforms(SG_SHADERSTAGE_FS, 0, &g_state.vars_fs, sizeof(g_state.vars_fs));
         sg_apply_bindings(&bindings);
@@ -624,12 +1428,20 @@ static void frame(void)
 
 static void release(void)
 {
-    free(g_state.file_data);
+    if (g_gallery.num_files > 0) {
+        gallery_stop();
+    }
+    stop_streaming();
+    ddsktx_mmap_close(&g_state.file);
     sg_destroy_pipeline(g_state.pip);
     sg_destroy_pipeline(g_state.pip_checker);
     sg_destroy_pipeline(g_state.pip_cubemap);
+    sg_destroy_pipeline(g_state.pip_array);
+    sg_destroy_pipeline(g_state.pip_volume);
     sg_destroy_shader(g_state.shader);
     sg_destroy_shader(g_state.shader_cubemap);
+    sg_destroy_shader(g_state.shader_array);
+    sg_destroy_shader(g_state.shader_volume);
     sg_destroy_buffer(g_state.vb);
     sg_destroy_buffer(g_state.vb_checker);
     sg_destroy_buffer(g_state.ib);
@@ -674,56 +1486,104 @@ static void on_events(const sapp_event* e)
             sapp_request_quit();
         }
 
+        if (g_gallery.num_files > 0 && (e->key_code == SAPP_KEYCODE_N || e->key_code == SAPP_KEYCODE_P)) {
+            int index = g_gallery.cur + (e->key_code == SAPP_KEYCODE_N ? 1 : -1);
+            if (index >= 0 && index < g_gallery.num_files) {
+                gallery_show(index);
+            }
+        }
+
         if (e->key_code == SAPP_KEYCODE_F) {
             g_state.cube_face = (g_state.cube_face + 1) % DDSKTX_CUBE_FACE_COUNT;
             set_cube_face(g_state.cube_face);
         }
 
+        // array layers or depth slices, PAGE_UP/PAGE_DOWN move 10 at a time
+        if (e->key_code == SAPP_KEYCODE_LEFT || e->key_code == SAPP_KEYCODE_RIGHT || 
+            e->key_code == SAPP_KEYCODE_PAGE_UP || e->key_code == SAPP_KEYCODE_PAGE_DOWN) {
+            int step = (e->key_code == SAPP_KEYCODE_PAGE_UP || e->key_code == SAPP_KEYCODE_PAGE_DOWN) ? 10 : 1;
+            step = (e->key_code == SAPP_KEYCODE_LEFT || e->key_code == SAPP_KEYCODE_PAGE_DOWN) ? -step : step;
+            if (g_state.tex_type == SG_IMAGETYPE_ARRAY) {
+                int layer = g_state.cur_layer + step;
+                g_state.cur_layer = layer < 0 ? 0 : (layer >= g_state.texinfo.num_layers ? (g_state.texinfo.num_layers - 1) : layer);
+            } else if (g_state.tex_type == SG_IMAGETYPE_3D) {
+                int slice = g_state.cur_slice + step;
+                g_state.cur_slice = slice < 0 ? 0 : (slice >= g_state.texinfo.depth ? (g_state.texinfo.depth - 1) : slice);
+            }
+        }
+
         break;
     }
 }
 
 sapp_desc sokol_main(int argc, char* argv[]) 
 {
-    if (argc <= 1) {
-        print_msg("Provide a file to load as argument");
-        exit(-1);
+    // usage: ctexview [-w|--watch] [-p|--progressive] [--cache-mb N] file_or_directory...
+    //      -w, --watch: reload the texture when the file is modified
+    //      -p, --progressive: show the smallest mips first and stream in the larger ones over the next frames
+    //      --cache-mb N: GPU memory budget of the gallery cache (default: GALLERY_CACHE_BUDGET)
+    //      a directory, a wildcard pattern (windows) or multiple files open the gallery, N/P switch between the
+    //      files. watch and progressive modes only apply to a single file
+    int num_paths = 0;
+    bool listed = false;
+    g_gallery.cache_budget = (int64_t)GALLERY_CACHE_BUDGET << 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--watch") == 0) {
+            g_state.watch = true;
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--progressive") == 0) {
+            g_state.progressive = true;
+        } else if (strcmp(argv[i], "--cache-mb") == 0 && i + 1 < argc) {
+            int mb = atoi(argv[++i]);
+            g_gallery.cache_budget = (int64_t)(mb > 0 ? mb : 1) << 20;
+        } else {
+            g_state.filepath = argv[i];
+            listed |= gallery_add_path(argv[i]);
+            num_paths++;
+        }
     }
 
-    FILE* f = fopen(argv[1], "rb");
-    if (!f) {
-        print_msg("Error: could not open file: %s\n", argv[1]);
+    if (!g_state.filepath) {
+        print_msg("Provide a file to load as argument");
         exit(-1);
     }
 
-    fseek(f, 0, SEEK_END);
-    int size = (int)ftell(f);
-    if (size == 0) {
-        print_msg("Error: file '%s' is empty\n", argv[1]);
-        exit(-1);
+    if (num_paths > 1 || listed) {
+        if (g_gallery.num_files == 0) {
+            print_msg("Error: no dds/ktx files found");
+            exit(-1);
+        }
+        g_state.watch = false;
+        g_state.progressive = false;
+        return (sapp_desc) {
+            .init_cb = init,
+            .frame_cb = frame,
+            .cleanup_cb = release,
+            .event_cb = on_events,
+            .width = 1024,
+            .height = 768,
+            .window_title = "DDS/KTX viewer",
+            .swap_interval = 2,
+            .sample_count = 1
+        };
     }
-    fseek(f, 0, SEEK_SET);
 
-    void* data = malloc(size);
-    if (!data) {
-        print_msg("out of memory: requested size: %d\n", (int)size);
-        exit(-1);
-    }
-    
-    if (fread(data, 1, size, f) != size) {
-        print_msg("could not read file data : %s\n", argv[1]);
+    // single file, the list isn't needed
+    free(g_gallery.files[0].path);
+    free(g_gallery.files);
+    g_gallery.files = NULL;
+    g_gallery.num_files = 0;
+
+    // file is memory-mapped, pages are only read when the mips are uploaded
+    if (!ddsktx_mmap_open(&g_state.file, g_state.filepath)) {
+        print_msg("Error: could not open file (or it's empty): %s\n", g_state.filepath);
         exit(-1);
     }
-
-    g_state.file_data = data;
-    g_state.file_size = size;
-
-    fclose(f);
+    file_stamp(g_state.filepath, &g_state.file_mtime, &g_state.file_size);
 
     ddsktx_texture_info tc = {0};
     ddsktx_error img_err;
-    if (!ddsktx_parse(&tc, data, size, &img_err)) {
-        print_msg("Loading image '%s' failed: %s", argv[1], img_err.msg);
+    if (!ddsktx_parse64(&tc, g_state.file.data, g_state.file.size, &img_err)) {
+        print_msg("Loading image '%s' failed: %s", g_state.filepath, img_err.msg);
         exit(-1);
     } 
 
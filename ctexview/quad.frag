@@ -6,12 +6,17 @@ precision mediump float;
 layout (location = TEXCOORD0)  in  vec3 f_uv;
 layout (location = SV_Target0) out vec4 frag_color;
 
-#ifdef CUBEMAP
+#if defined(CUBEMAP)
 layout (binding = 0) uniform samplerCube tex_image;
+#elif defined(ARRAY)
+layout (binding = 0) uniform sampler2DArray tex_image;
+#elif defined(VOLUME)
+layout (binding = 0) uniform sampler3D tex_image;
 #else
 layout (binding = 0) uniform sampler2D tex_image;
 #endif
 
+// target_lod.x: mip, target_lod.y: array layer (ARRAY) or normalized depth (VOLUME)
 layout (binding = 0, std140) uniform globals {
     vec4 color;
 	vec4 target_lod;
@@ -19,8 +24,10 @@ layout (binding = 0, std140) uniform globals {
 
 void main() 
 {
-    #ifdef CUBEMAP
+    #if defined(CUBEMAP)
         frag_color = textureLod(tex_image, f_uv, target_lod.x) * vec4(color.xyz, 1.0); 
+    #elif defined(ARRAY) || defined(VOLUME)
+        frag_color = textureLod(tex_image, vec3(f_uv.xy, target_lod.y), target_lod.x) * vec4(color.xyz, 1.0); 
     #else
         frag_color = textureLod(tex_image, f_uv.xy, target_lod.x) * vec4(color.rgb, 1.0);
     #endif
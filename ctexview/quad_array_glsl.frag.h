@@ -0,0 +1,22 @@
+// This file is automatically created by glslcc v1.7.3
+// http://www.github.com/septag/glslcc
+// 
+#pragma once
+
+static const unsigned int quad_array_fs_size = 406;
+static const unsigned int quad_array_fs_data[408/4] = {
+	0x72657623, 0x6e6f6973, 0x30333320, 0x6e750a0a, 0x726f6669, 0x6576206d, 0x67203463, 0x61626f6c, 
+	0x325b736c, 0x750a3b5d, 0x6f66696e, 0x73206d72, 0x6c706d61, 0x44327265, 0x61727241, 0x65742079, 
+	0x6d695f78, 0x3b656761, 0x616c0a0a, 0x74756f79, 0x636f6c28, 0x6f697461, 0x203d206e, 0x6f202930, 
+	0x76207475, 0x20346365, 0x67617266, 0x6c6f635f, 0x0a3b726f, 0x76206e69, 0x20336365, 0x76755f66, 
+	0x760a0a3b, 0x2064696f, 0x6e69616d, 0x7b0a2928, 0x2020200a, 0x61726620, 0x6f635f67, 0x20726f6c, 
+	0x6574203d, 0x72757478, 0x646f4c65, 0x78657428, 0x616d695f, 0x202c6567, 0x33636576, 0x755f6628, 
+	0x79782e76, 0x6c67202c, 0x6c61626f, 0x5d315b73, 0x2c29792e, 0x6f6c6720, 0x736c6162, 0x2e5d315b, 
+	0x2a202978, 0x63657620, 0x6c672834, 0x6c61626f, 0x5d305b73, 0x7a79782e, 0x2e31202c, 0x0a3b2930, 
+	0x20202020, 0x616f6c66, 0x355f2074, 0x200a3b36, 0x69202020, 0x67282066, 0x61626f6c, 0x305b736c, 
+	0x20772e5d, 0x2e31203c, 0x200a2930, 0x7b202020, 0x2020200a, 0x20202020, 0x36355f20, 0x31203d20, 
+	0x0a3b302e, 0x20202020, 0x20200a7d, 0x6c652020, 0x200a6573, 0x7b202020, 0x2020200a, 0x20202020, 
+	0x36355f20, 0x66203d20, 0x5f676172, 0x6f6c6f63, 0x3b772e72, 0x2020200a, 0x200a7d20, 0x66202020, 
+	0x5f676172, 0x6f6c6f63, 0x20772e72, 0x355f203d, 0x7d0a3b36, 0x00000a0a };
+
+	
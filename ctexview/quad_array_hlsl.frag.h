@@ -0,0 +1,41 @@
+// This file is automatically created by glslcc v1.7.3
+// http://www.github.com/septag/glslcc
+// 
+#pragma once
+
+static const unsigned int quad_array_fs_size = 1032;
+static const unsigned int quad_array_fs_data[1032/4] = {
+	0x43425844, 0xb214061d, 0xd21fe545, 0x08ae8583, 0x7327e1a7, 0x00000001, 0x00000408, 0x00000005, 
+	0x00000034, 0x000001d8, 0x0000020c, 0x00000240, 0x0000036c, 0x46454452, 0x0000019c, 0x00000001, 
+	0x000000c4, 0x00000003, 0x0000003c, 0xffff0500, 0x00008100, 0x00000173, 0x31314452, 0x0000003c, 
+	0x00000018, 0x00000020, 0x00000028, 0x00000024, 0x0000000c, 0x00000000, 0x0000009c, 0x00000003, 
+	0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000001, 0x000000af, 0x00000002, 
+	0x00000005, 0x00000005, 0xffffffff, 0x00000000, 0x00000001, 0x0000000d, 0x000000b9, 0x00000000, 
+	0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000001, 0x7865745f, 0x616d695f, 
+	0x735f6567, 0x6c706d61, 0x74007265, 0x695f7865, 0x6567616d, 0x6f6c6700, 0x736c6162, 0xababab00, 
+	0x000000b9, 0x00000002, 0x000000dc, 0x00000020, 0x00000000, 0x00000000, 0x0000012c, 0x00000000, 
+	0x00000010, 0x00000002, 0x00000140, 0x00000000, 0xffffffff, 0x00000000, 0xffffffff, 0x00000000, 
+	0x00000164, 0x00000010, 0x00000010, 0x00000002, 0x00000140, 0x00000000, 0xffffffff, 0x00000000, 
+	0xffffffff, 0x00000000, 0x5f31325f, 0x6f6c6f63, 0x6c660072, 0x3474616f, 0xababab00, 0x00030001, 
+	0x00040001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000136, 
+	0x5f31325f, 0x67726174, 0x6c5f7465, 0x4d00646f, 0x6f726369, 0x74666f73, 0x29522820, 0x534c4820, 
+	0x6853204c, 0x72656461, 0x6d6f4320, 0x656c6970, 0x30312072, 0xab00312e, 0x4e475349, 0x0000002c, 
+	0x00000001, 0x00000008, 0x00000020, 0x00000002, 0x00000000, 0x00000003, 0x00000000, 0x00000307, 
+	0x43584554, 0x44524f4f, 0xababab00, 0x4e47534f, 0x0000002c, 0x00000001, 0x00000008, 0x00000020, 
+	0x00000000, 0x00000000, 0x00000003, 0x00000000, 0x0000000f, 0x545f5653, 0x65677261, 0xabab0074, 
+	0x58454853, 0x00000124, 0x00000050, 0x00000049, 0x0100086a, 0x04000059, 0x00208e46, 0x00000000, 
+	0x00000002, 0x0300005a, 0x00106000, 0x00000000, 0x04004058, 0x00107000, 0x00000000, 0x00005555, 
+	0x03001062, 0x00101032, 0x00000000, 0x03000065, 0x001020f2, 0x00000000, 0x02000068, 0x00000002, 
+	0x08000031, 0x00100012, 0x00000000, 0x0020803a, 0x00000000, 0x00000000, 0x00004001, 0x3f800000, 
+	0x05000036, 0x00100032, 0x00000001, 0x00101046, 0x00000000, 0x06000036, 0x00100042, 0x00000001, 
+	0x0020801a, 0x00000000, 0x00000001, 0x8e000048, 0x80000202, 0x00155543, 0x001000f2, 0x00000001, 
+	0x00100246, 0x00000001, 0x00107936, 0x00000000, 0x00106000, 0x00000000, 0x0020800a, 0x00000000, 
+	0x00000001, 0x08000038, 0x00102072, 0x00000000, 0x00100796, 0x00000001, 0x00208246, 0x00000000, 
+	0x00000000, 0x09000037, 0x00102082, 0x00000000, 0x0010000a, 0x00000000, 0x00004001, 0x3f800000, 
+	0x0010000a, 0x00000001, 0x0100003e, 0x54415453, 0x00000094, 0x00000007, 0x00000002, 0x00000000, 
+	0x00000002, 0x00000002, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 
+	0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 
+	0x00000002, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
+	0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
+	0x00000000, 0x00000000 };
+
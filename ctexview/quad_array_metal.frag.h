@@ -0,0 +1,34 @@
+// This file is automatically created by glslcc v1.7.3
+// http://www.github.com/septag/glslcc
+// 
+#pragma once
+
+static const unsigned int quad_array_fs_size = 775;
+static const unsigned int quad_array_fs_data[776/4] = {
+	0x636e6923, 0x6564756c, 0x656d3c20, 0x5f6c6174, 0x6c647473, 0x0a3e6269, 0x636e6923, 0x6564756c, 
+	0x69733c20, 0x732f646d, 0x2e646d69, 0x0a0a3e68, 0x6e697375, 0x616e2067, 0x7073656d, 0x20656361, 
+	0x6174656d, 0x0a0a3b6c, 0x75727473, 0x67207463, 0x61626f6c, 0x7b0a736c, 0x2020200a, 0x6f6c6620, 
+	0x20347461, 0x6f6c6f63, 0x200a3b72, 0x66202020, 0x74616f6c, 0x61742034, 0x74656772, 0x646f6c5f, 
+	0x3b7d0a3b, 0x74730a0a, 0x74637572, 0x69616d20, 0x6f5f306e, 0x7b0a7475, 0x2020200a, 0x6f6c6620, 
+	0x20347461, 0x67617266, 0x6c6f635f, 0x5b20726f, 0x6c6f635b, 0x3028726f, 0x3b5d5d29, 0x0a3b7d0a, 
+	0x7274730a, 0x20746375, 0x6e69616d, 0x6e695f30, 0x200a7b0a, 0x66202020, 0x74616f6c, 0x5f662033, 
+	0x5b207675, 0x6573755b, 0x6f6c2872, 0x29326e63, 0x0a3b5d5d, 0x0a0a3b7d, 0x67617266, 0x746e656d, 
+	0x69616d20, 0x6f5f306e, 0x6d207475, 0x306e6961, 0x69616d28, 0x695f306e, 0x6e69206e, 0x735b5b20, 
+	0x65676174, 0x5d6e695f, 0x63202c5d, 0x74736e6f, 0x20746e61, 0x626f6c67, 0x26736c61, 0x33325f20, 
+	0x625b5b20, 0x65666675, 0x29302872, 0x202c5d5d, 0x74786574, 0x32657275, 0x72615f64, 0x3c796172, 
+	0x616f6c66, 0x74203e74, 0x695f7865, 0x6567616d, 0x745b5b20, 0x75747865, 0x30286572, 0x2c5d5d29, 
+	0x6d617320, 0x72656c70, 0x78657420, 0x616d695f, 0x6d536567, 0x20726c70, 0x61735b5b, 0x656c706d, 
+	0x29302872, 0x0a295d5d, 0x20200a7b, 0x616d2020, 0x5f306e69, 0x2074756f, 0x2074756f, 0x7d7b203d, 
+	0x20200a3b, 0x756f2020, 0x72662e74, 0x635f6761, 0x726f6c6f, 0x74203d20, 0x695f7865, 0x6567616d, 
+	0x6d61732e, 0x28656c70, 0x5f786574, 0x67616d69, 0x706d5365, 0x202c726c, 0x662e6e69, 0x2e76755f, 
+	0x202c7978, 0x746e6975, 0x756f7228, 0x5f28646e, 0x742e3332, 0x65677261, 0x6f6c5f74, 0x29792e64, 
+	0x6c202c29, 0x6c657665, 0x33325f28, 0x7261742e, 0x5f746567, 0x2e646f6c, 0x20292978, 0x6c66202a, 
+	0x3474616f, 0x33325f28, 0x6c6f632e, 0x782e726f, 0x202c7a79, 0x29302e31, 0x20200a3b, 0x6c662020, 
+	0x2074616f, 0x3b36355f, 0x2020200a, 0x20666920, 0x33325f28, 0x6c6f632e, 0x772e726f, 0x31203c20, 
+	0x0a29302e, 0x20202020, 0x20200a7b, 0x20202020, 0x355f2020, 0x203d2036, 0x3b302e31, 0x2020200a, 
+	0x200a7d20, 0x65202020, 0x0a65736c, 0x20202020, 0x20200a7b, 0x20202020, 0x355f2020, 0x203d2036, 
+	0x2e74756f, 0x67617266, 0x6c6f635f, 0x772e726f, 0x20200a3b, 0x0a7d2020, 0x20202020, 0x2e74756f, 
+	0x67617266, 0x6c6f635f, 0x772e726f, 0x5f203d20, 0x0a3b3635, 0x20202020, 0x75746572, 0x6f206e72, 
+	0x0a3b7475, 0x000a0a7d };
+
+	
@@ -0,0 +1,22 @@
+// This file is automatically created by glslcc v1.7.3
+// http://www.github.com/septag/glslcc
+// 
+#pragma once
+
+static const unsigned int quad_volume_fs_size = 401;
+static const unsigned int quad_volume_fs_data[404/4] = {
+	0x72657623, 0x6e6f6973, 0x30333320, 0x6e750a0a, 0x726f6669, 0x6576206d, 0x67203463, 0x61626f6c, 
+	0x325b736c, 0x750a3b5d, 0x6f66696e, 0x73206d72, 0x6c706d61, 0x44337265, 0x78657420, 0x616d695f, 
+	0x0a3b6567, 0x79616c0a, 0x2874756f, 0x61636f6c, 0x6e6f6974, 0x30203d20, 0x756f2029, 0x65762074, 
+	0x66203463, 0x5f676172, 0x6f6c6f63, 0x690a3b72, 0x6576206e, 0x66203363, 0x3b76755f, 0x6f760a0a, 
+	0x6d206469, 0x286e6961, 0x0a7b0a29, 0x20202020, 0x67617266, 0x6c6f635f, 0x3d20726f, 0x78657420, 
+	0x65727574, 0x28646f4c, 0x5f786574, 0x67616d69, 0x76202c65, 0x28336365, 0x76755f66, 0x2c79782e, 
+	0x6f6c6720, 0x736c6162, 0x2e5d315b, 0x202c2979, 0x626f6c67, 0x5b736c61, 0x782e5d31, 0x202a2029, 
+	0x34636576, 0x6f6c6728, 0x736c6162, 0x2e5d305b, 0x2c7a7978, 0x302e3120, 0x200a3b29, 0x66202020, 
+	0x74616f6c, 0x36355f20, 0x20200a3b, 0x66692020, 0x6c672820, 0x6c61626f, 0x5d305b73, 0x3c20772e, 
+	0x302e3120, 0x20200a29, 0x0a7b2020, 0x20202020, 0x20202020, 0x2036355f, 0x2e31203d, 0x200a3b30, 
+	0x7d202020, 0x2020200a, 0x736c6520, 0x20200a65, 0x0a7b2020, 0x20202020, 0x20202020, 0x2036355f, 
+	0x7266203d, 0x635f6761, 0x726f6c6f, 0x0a3b772e, 0x20202020, 0x20200a7d, 0x72662020, 0x635f6761, 
+	0x726f6c6f, 0x3d20772e, 0x36355f20, 0x0a7d0a3b, 0x0000000a };
+
+	
@@ -0,0 +1,33 @@
+// This file is automatically created by glslcc v1.7.3
+// http://www.github.com/septag/glslcc
+// 
+#pragma once
+
+static const unsigned int quad_volume_fs_size = 764;
+static const unsigned int quad_volume_fs_data[768/4] = {
+	0x636e6923, 0x6564756c, 0x656d3c20, 0x5f6c6174, 0x6c647473, 0x0a3e6269, 0x636e6923, 0x6564756c, 
+	0x69733c20, 0x732f646d, 0x2e646d69, 0x0a0a3e68, 0x6e697375, 0x616e2067, 0x7073656d, 0x20656361, 
+	0x6174656d, 0x0a0a3b6c, 0x75727473, 0x67207463, 0x61626f6c, 0x7b0a736c, 0x2020200a, 0x6f6c6620, 
+	0x20347461, 0x6f6c6f63, 0x200a3b72, 0x66202020, 0x74616f6c, 0x61742034, 0x74656772, 0x646f6c5f, 
+	0x3b7d0a3b, 0x74730a0a, 0x74637572, 0x69616d20, 0x6f5f306e, 0x7b0a7475, 0x2020200a, 0x6f6c6620, 
+	0x20347461, 0x67617266, 0x6c6f635f, 0x5b20726f, 0x6c6f635b, 0x3028726f, 0x3b5d5d29, 0x0a3b7d0a, 
+	0x7274730a, 0x20746375, 0x6e69616d, 0x6e695f30, 0x200a7b0a, 0x66202020, 0x74616f6c, 0x5f662033, 
+	0x5b207675, 0x6573755b, 0x6f6c2872, 0x29326e63, 0x0a3b5d5d, 0x0a0a3b7d, 0x67617266, 0x746e656d, 
+	0x69616d20, 0x6f5f306e, 0x6d207475, 0x306e6961, 0x69616d28, 0x695f306e, 0x6e69206e, 0x735b5b20, 
+	0x65676174, 0x5d6e695f, 0x63202c5d, 0x74736e6f, 0x20746e61, 0x626f6c67, 0x26736c61, 0x33325f20, 
+	0x625b5b20, 0x65666675, 0x29302872, 0x202c5d5d, 0x74786574, 0x33657275, 0x6c663c64, 0x3e74616f, 
+	0x78657420, 0x616d695f, 0x5b206567, 0x7865745b, 0x65727574, 0x5d293028, 0x73202c5d, 0x6c706d61, 
+	0x74207265, 0x695f7865, 0x6567616d, 0x6c706d53, 0x5b5b2072, 0x706d6173, 0x2872656c, 0x5d5d2930, 
+	0x0a7b0a29, 0x20202020, 0x6e69616d, 0x756f5f30, 0x756f2074, 0x203d2074, 0x0a3b7d7b, 0x20202020, 
+	0x2e74756f, 0x67617266, 0x6c6f635f, 0x3d20726f, 0x78657420, 0x616d695f, 0x732e6567, 0x6c706d61, 
+	0x65742865, 0x6d695f78, 0x53656761, 0x726c706d, 0x6c66202c, 0x3374616f, 0x2e6e6928, 0x76755f66, 
+	0x2c79782e, 0x33325f20, 0x7261742e, 0x5f746567, 0x2e646f6c, 0x202c2979, 0x6576656c, 0x325f286c, 
+	0x61742e33, 0x74656772, 0x646f6c5f, 0x2929782e, 0x66202a20, 0x74616f6c, 0x325f2834, 0x6f632e33, 
+	0x2e726f6c, 0x2c7a7978, 0x302e3120, 0x200a3b29, 0x66202020, 0x74616f6c, 0x36355f20, 0x20200a3b, 
+	0x66692020, 0x325f2820, 0x6f632e33, 0x2e726f6c, 0x203c2077, 0x29302e31, 0x2020200a, 0x200a7b20, 
+	0x20202020, 0x5f202020, 0x3d203635, 0x302e3120, 0x20200a3b, 0x0a7d2020, 0x20202020, 0x65736c65, 
+	0x2020200a, 0x200a7b20, 0x20202020, 0x5f202020, 0x3d203635, 0x74756f20, 0x6172662e, 0x6f635f67, 
+	0x2e726f6c, 0x200a3b77, 0x7d202020, 0x2020200a, 0x74756f20, 0x6172662e, 0x6f635f67, 0x2e726f6c, 
+	0x203d2077, 0x3b36355f, 0x2020200a, 0x74657220, 0x206e7275, 0x3b74756f, 0x0a0a7d0a, 0x00000000 };
+
+	
@@ -0,0 +1,215 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// dds-ktx-mmap.h - Optional memory-mapped file loader for dds-ktx.h
+//      Maps texture files read-only (mmap on posix, CreateFileMapping on windows), so they can be passed
+//      to ddsktx_parse64/ddsktx_get_sub without reading the whole file to memory
+//      Pages are loaded on first access, ddsktx_mmap_prefetch_mips hints the OS to read ahead only the mips
+//      that are going to be uploaded
+//
+//      Define DDSKTX_MMAP_IMPLEMENT in one source file before including this file
+//
+//      Overriable macros:
+//          DDSKTX_MMAP_API     function specifier for public functions (default: DDSKTX_API)
+//
+//      API:
+//          bool ddsktx_mmap_open(ddsktx_mmap_file* file, const char* filepath);
+//              Maps the whole file for reading, file->data and file->size are valid until ddsktx_mmap_close
+//              Returns false if the file can't be opened or is empty
+//
+//          void ddsktx_mmap_close(ddsktx_mmap_file* file);
+//              Unmaps the file and closes the handles, file->data becomes NULL
+//
+//          void ddsktx_mmap_prefetch(const ddsktx_mmap_file* file, int64_t offset, int64_t size);
+//              Hints the OS to read the range ahead (madvise WILLNEED, PrefetchVirtualMemory on Windows 8+)
+//              The call doesn't block. Ranges outside the file are clipped
+//
+//          void ddsktx_mmap_prefetch_mips(const ddsktx_mmap_file* file, const ddsktx_texture_info* tc,
+//                                         int first_mip, int num_mips);
+//              Prefetches the file ranges of mips [first_mip, first_mip+num_mips) of all layers and faces
+//              (see ddsktx_get_mip_ranges). Supercompressed KTX2 levels are prefetched with the level index
+//
+//      Example:
+//          ddsktx_mmap_file file;
+//          ddsktx_texture_info tc;
+//          if (ddsktx_mmap_open(&file, "test.ktx") && ddsktx_parse64(&tc, file.data, file.size, NULL)) {
+//              ddsktx_mmap_prefetch_mips(&file, &tc, 0, tc.num_mips);
+//              // upload, ddsktx_get_sub64(&tc, &sub, file.data, file.size, ...)
+//          }
+//          ddsktx_mmap_close(&file);
+//
+#pragma once
+
+#include "dds-ktx.h"
+
+#ifndef DDSKTX_MMAP_API
+#   define DDSKTX_MMAP_API DDSKTX_API
+#endif
+
+typedef struct ddsktx_mmap_file
+{
+    const void* data;
+    size_t      size;
+#if defined(_WIN32) || defined(_WIN64)
+    void*       file_handle;
+    void*       mapping_handle;
+#endif
+} ddsktx_mmap_file;
+
+DDSKTX_MMAP_API bool ddsktx_mmap_open(ddsktx_mmap_file* file, const char* filepath);
+DDSKTX_MMAP_API void ddsktx_mmap_close(ddsktx_mmap_file* file);
+DDSKTX_MMAP_API void ddsktx_mmap_prefetch(const ddsktx_mmap_file* file, int64_t offset, int64_t size);
+DDSKTX_MMAP_API void ddsktx_mmap_prefetch_mips(const ddsktx_mmap_file* file, const ddsktx_texture_info* tc,
+                                               int first_mip, int num_mips);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef DDSKTX_MMAP_IMPLEMENT
+
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+bool ddsktx_mmap_open(ddsktx_mmap_file* file, const char* filepath)
+{
+    memset(file, 0x0, sizeof(ddsktx_mmap_file));
+
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE f = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL|FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (f == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size) || size.QuadPart == 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) {
+        CloseHandle(f);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(f);
+        return false;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(f);
+        return false;
+    }
+
+    file->data = data;
+    file->size = (size_t)size.QuadPart;
+    file->file_handle = f;
+    file->mapping_handle = mapping;
+    return true;
+#else
+    int fd = open(filepath, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file referenced
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    file->data = data;
+    file->size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+void ddsktx_mmap_close(ddsktx_mmap_file* file)
+{
+    if (!file->data) {
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(file->data);
+    CloseHandle((HANDLE)file->mapping_handle);
+    CloseHandle((HANDLE)file->file_handle);
+#else
+    munmap((void*)file->data, file->size);
+#endif
+    memset(file, 0x0, sizeof(ddsktx_mmap_file));
+}
+
+void ddsktx_mmap_prefetch(const ddsktx_mmap_file* file, int64_t offset, int64_t size)
+{
+    if (!file->data || offset < 0 || offset >= (int64_t)file->size || size <= 0) {
+        return;
+    }
+    if (size > (int64_t)file->size - offset) {
+        size = (int64_t)file->size - offset;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+#   if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = (uint8_t*)file->data + offset;
+    range.NumberOfBytes = (SIZE_T)size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#   endif
+#elif defined(POSIX_MADV_WILLNEED) || defined(MADV_WILLNEED)
+    // address must be page aligned
+    int64_t page_size = (int64_t)sysconf(_SC_PAGESIZE);
+    int64_t start = page_size > 0 ? (offset / page_size) * page_size : 0;
+#   if defined(POSIX_MADV_WILLNEED)
+    posix_madvise((uint8_t*)file->data + start, (size_t)(offset + size - start), POSIX_MADV_WILLNEED);
+#   else
+    madvise((uint8_t*)file->data + start, (size_t)(offset + size - start), MADV_WILLNEED);
+#   endif
+#endif
+}
+
+void ddsktx_mmap_prefetch_mips(const ddsktx_mmap_file* file, const ddsktx_texture_info* tc,
+                               int first_mip, int num_mips)
+{
+    if (first_mip < 0 || first_mip >= tc->num_mips) {
+        return;
+    }
+    if (num_mips > tc->num_mips - first_mip) {
+        num_mips = tc->num_mips - first_mip;
+    }
+
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+        for (int mip = first_mip; mip < first_mip + num_mips; mip++) {
+            ddsktx_file_range range;
+            if (ddsktx_get_level_range(tc, file->data, file->size, mip, &range, NULL)) {
+                ddsktx_mmap_prefetch(file, range.offset, range.size);
+            }
+        }
+        return;
+    }
+
+    // the number of ranges is at most layers*faces (DDS), so this is enough for most files,
+    // the rest is read on first access anyway
+    ddsktx_file_range ranges[64];
+    int num_ranges = ddsktx_get_mip_ranges(tc, first_mip, num_mips, ranges, 64);
+    for (int i = 0; i < num_ranges && i < 64; i++) {
+        ddsktx_mmap_prefetch(file, ranges[i].offset, ranges[i].size);
+    }
+}
+
+#endif  // DDSKTX_MMAP_IMPLEMENT
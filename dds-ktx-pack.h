@@ -0,0 +1,601 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// dds-ktx-pack.h - Optional texture pack (archive) format for dds-ktx.h
+//      Stores many DDS/KTX/KTX2 files in one file, together with an index of pre-parsed texture infos and
+//      subresource tables, so textures can be looked up by name and used without opening or parsing the files
+//      The pack is meant to be memory-mapped (see dds-ktx-mmap.h), opening it only checks the header and the
+//      index, a lookup is a binary search over the name hashes
+//
+//      Define DDSKTX_PACK_IMPLEMENT in one source file before including this file
+//
+//      Overriable macros:
+//          DDSKTX_PACK_API     function specifier for public functions (default: DDSKTX_API)
+//          DDSKTX_PACK_ALIGN   alignment of the texture files in the pack, power of two (default: 64)
+//          ddsktx_pack_malloc  default: malloc(size), only used by ddsktx_pack_write
+//          ddsktx_pack_free    default: free(ptr)
+//
+//      Layout (little-endian):
+//          ddsktx_pack_header
+//          uint64_t            hashes[num_textures]        name hashes, sorted, for the binary search
+//          ddsktx_pack_record  records[num_textures]       in the same order as hashes, 128 bytes each
+//          ddsktx_sub_entry    subs[num_subs]              subresource tables of all textures
+//          char                names[names_size]           zero-terminated names
+//          texture files, each one aligned to DDSKTX_PACK_ALIGN
+//          All sections start at 64 byte alignment
+//
+//      API:
+//          bool ddsktx_pack_write(const ddsktx_pack_item* items, int num_items,
+//                                 ddsktx_write_cb* write_cb, void* user, ddsktx_error* err);
+//              Parses and validates all the files (ddsktx_parse_strict), builds the index and writes the pack
+//              through write_cb, in order (see ddsktx_write_dds). Names must be unique
+//              Item file data is only referenced by the output buffers, it's not copied
+//
+//          bool ddsktx_pack_open(ddsktx_pack* pack, const void* data, size_t size, ddsktx_error* err);
+//              Checks the header and all index records against the size, and validates every texture against
+//              its file data (ddsktx_validate), pack->data must stay valid while the pack is used, there is
+//              nothing to close
+//
+//          int ddsktx_pack_find(const ddsktx_pack* pack, const char* name);
+//              Returns the index of the texture, or -1 if it's not in the pack
+//
+//          void ddsktx_pack_texture_info(const ddsktx_pack* pack, int index, ddsktx_texture_info* tc);
+//              Fills the texture info, as ddsktx_parse_strict would for the file (DDSKTX_TEXTURE_FLAG_VALIDATED is 
+//              set, the layout was checked by ddsktx_pack_open)
+//
+//          const void* ddsktx_pack_file_data(const ddsktx_pack* pack, int index, size_t* size);
+//              Returns the texture file inside the pack, it can be passed to all ddsktx functions that take file_data
+//
+//          const char* ddsktx_pack_name(const ddsktx_pack* pack, int index);
+//
+//          const ddsktx_sub_entry* ddsktx_pack_sub_table(const ddsktx_pack* pack, int index);
+//              Returns the subresource table of the texture (see ddsktx_build_subresource_table)
+//
+//          void ddsktx_pack_get_sub(const ddsktx_pack* pack, int index, ddsktx_sub_data* sub_data,
+//                                   int array_idx, int slice_face_idx, int mip_idx);
+//              Same as ddsktx_get_sub, but reads the sub-image from the subresource table in O(1)
+//              Supercompressed KTX2 levels must be decoded first, see ddsktx_decode_level
+//
+//          uint64_t ddsktx_pack_hash(const char* name);
+//              Hash of the names in the index (FNV-1a 64)
+//
+//      Example:
+//          ddsktx_mmap_file file;
+//          ddsktx_pack pack;
+//          if (ddsktx_mmap_open(&file, "textures.pak") && ddsktx_pack_open(&pack, file.data, file.size, NULL)) {
+//              int index = ddsktx_pack_find(&pack, "rocks_diffuse");
+//              if (index >= 0) {
+//                  ddsktx_sub_data sub;
+//                  ddsktx_pack_get_sub(&pack, index, &sub, 0, 0, 0);
+//              }
+//          }
+//
+#pragma once
+
+#include "dds-ktx.h"
+
+#ifndef DDSKTX_PACK_API
+#   define DDSKTX_PACK_API DDSKTX_API
+#endif
+
+#define DDSKTX_PACK_VERSION 1
+
+typedef struct ddsktx_pack_header
+{
+    uint8_t     magic[8];           // "DDSKTXPK"
+    uint32_t    version;            // DDSKTX_PACK_VERSION
+    uint32_t    num_textures;
+    uint32_t    num_subs;
+    uint32_t    names_size;
+    int64_t     hashes_offset;
+    int64_t     records_offset;
+    int64_t     subs_offset;
+    int64_t     names_offset;
+    int64_t     file_size;
+} ddsktx_pack_header;
+
+// fixed size version of ddsktx_texture_info, offsets are relative to the start of the texture file
+typedef struct ddsktx_pack_record
+{
+    int64_t     file_offset;        // from the start of the pack
+    int64_t     file_size;
+    int64_t     data_offset;
+    int64_t     size_bytes;
+    int64_t     metadata_offset;
+    uint32_t    name_offset;        // into names
+    uint32_t    first_sub;          // into subs
+    int32_t     format;
+    uint32_t    flags;
+    int32_t     width;
+    int32_t     height;
+    int32_t     depth;
+    int32_t     num_layers;
+    int32_t     num_mips;
+    int32_t     bpp;
+    int32_t     metadata_size;
+    int32_t     supercompression;
+    uint8_t     reserved[40];
+} ddsktx_pack_record;
+
+typedef struct ddsktx_pack
+{
+    const uint8_t*              data;
+    size_t                      size;
+    int                         num_textures;
+    const uint64_t*             hashes;
+    const ddsktx_pack_record*   records;
+    const ddsktx_sub_entry*     subs;
+    const char*                 names;
+} ddsktx_pack;
+
+typedef struct ddsktx_pack_item
+{
+    const char* name;
+    const void* file_data;
+    size_t      size;
+} ddsktx_pack_item;
+
+DDSKTX_PACK_API bool ddsktx_pack_write(const ddsktx_pack_item* items, int num_items,
+                                       ddsktx_write_cb* write_cb, void* user, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_PACK_API bool ddsktx_pack_open(ddsktx_pack* pack, const void* data, size_t size,
+                                      ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_PACK_API int  ddsktx_pack_find(const ddsktx_pack* pack, const char* name);
+DDSKTX_PACK_API void ddsktx_pack_texture_info(const ddsktx_pack* pack, int index, ddsktx_texture_info* tc);
+DDSKTX_PACK_API const void* ddsktx_pack_file_data(const ddsktx_pack* pack, int index, size_t* size);
+DDSKTX_PACK_API const char* ddsktx_pack_name(const ddsktx_pack* pack, int index);
+DDSKTX_PACK_API const ddsktx_sub_entry* ddsktx_pack_sub_table(const ddsktx_pack* pack, int index);
+DDSKTX_PACK_API void ddsktx_pack_get_sub(const ddsktx_pack* pack, int index, ddsktx_sub_data* sub_data,
+                                         int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_PACK_API uint64_t ddsktx_pack_hash(const char* name);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef DDSKTX_PACK_IMPLEMENT
+
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+#ifndef DDSKTX_PACK_ALIGN
+#   define DDSKTX_PACK_ALIGN 64
+#endif
+
+#ifndef ddsktx_pack_malloc
+#   include <stdlib.h>
+#   define ddsktx_pack_malloc(_size)  malloc(_size)
+#endif
+
+#ifndef ddsktx_pack_free
+#   include <stdlib.h>
+#   define ddsktx_pack_free(_ptr)     free(_ptr)
+#endif
+
+#define ddsktx_pack__err(_err, _msg)   if (_err)  strcpy((_err)->msg, _msg);   return false
+
+#define DDSKTX_PACK__SECTION_ALIGN 64
+
+// on-disk structs must not depend on the compiler
+typedef char ddsktx_pack__header_size[sizeof(ddsktx_pack_header) == 64 ? 1 : -1];
+typedef char ddsktx_pack__record_size[sizeof(ddsktx_pack_record) == 128 ? 1 : -1];
+typedef char ddsktx_pack__sub_size[sizeof(ddsktx_sub_entry) == 32 ? 1 : -1];
+
+static const uint8_t k__pack_magic[8] = { 'D', 'D', 'S', 'K', 'T', 'X', 'P', 'K' };
+static const uint8_t k__pack_zeros[DDSKTX_PACK_ALIGN > DDSKTX_PACK__SECTION_ALIGN ?
+                                   DDSKTX_PACK_ALIGN : DDSKTX_PACK__SECTION_ALIGN] = { 0 };
+
+static inline int64_t ddsktx_pack__align(int64_t value, int64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint64_t ddsktx_pack_hash(const char* name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const uint8_t* c = (const uint8_t*)name; *c; c++) {
+        hash = (hash ^ *c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+typedef struct ddsktx_pack__sort_item
+{
+    uint64_t    hash;
+    const char* name;
+    int         index;
+} ddsktx_pack__sort_item;
+
+static int ddsktx_pack__compare(const void* a, const void* b)
+{
+    const ddsktx_pack__sort_item* ia = (const ddsktx_pack__sort_item*)a;
+    const ddsktx_pack__sort_item* ib = (const ddsktx_pack__sort_item*)b;
+    if (ia->hash != ib->hash) {
+        return ia->hash < ib->hash ? -1 : 1;
+    }
+    return strcmp(ia->name, ib->name);
+}
+
+// writes all the buffers plus padding to 'alignment', returns the new offset or -1 if writing fails
+static int64_t ddsktx_pack__write(ddsktx_write_cb* write_cb, void* user, int64_t offset,
+                                  const void* data, int64_t size, int64_t alignment)
+{
+    ddsktx_write_buffer buffs[2];
+    int num_buffs = 0;
+    if (size > 0) {
+        buffs[num_buffs].data = data;
+        buffs[num_buffs].size = size;
+        num_buffs++;
+    }
+    int64_t padding = ddsktx_pack__align(offset + size, alignment) - (offset + size);
+    if (padding > 0) {
+        buffs[num_buffs].data = k__pack_zeros;
+        buffs[num_buffs].size = padding;
+        num_buffs++;
+    }
+    if (num_buffs > 0 && !write_cb(buffs, num_buffs, user)) {
+        return -1;
+    }
+    return offset + size + padding;
+}
+
+bool ddsktx_pack_write(const ddsktx_pack_item* items, int num_items,
+                       ddsktx_write_cb* write_cb, void* user, ddsktx_error* err)
+{
+    assert(items || num_items == 0);
+    assert(write_cb);
+
+    if (num_items < 0) {
+        ddsktx_pack__err(err, "pack: invalid number of items");
+    }
+
+    // parse all the files first and sort them by name hash
+    ddsktx_pack__sort_item* sorted = NULL;
+    ddsktx_texture_info* infos = NULL;
+    if (num_items > 0) {
+        sorted = (ddsktx_pack__sort_item*)ddsktx_pack_malloc(sizeof(ddsktx_pack__sort_item)*num_items);
+        infos = (ddsktx_texture_info*)ddsktx_pack_malloc(sizeof(ddsktx_texture_info)*num_items);
+        if (!sorted || !infos) {
+            ddsktx_pack_free(sorted);
+            ddsktx_pack_free(infos);
+            ddsktx_pack__err(err, "pack: out of memory");
+        }
+    }
+
+    int64_t num_subs = 0;
+    int64_t names_size = 0;
+    for (int i = 0; i < num_items; i++) {
+        if (!items[i].name || !items[i].file_data || items[i].size == 0 ||
+            !ddsktx_parse_strict(&infos[i], items[i].file_data, items[i].size, err))
+        {
+            ddsktx_pack_free(sorted);
+            ddsktx_pack_free(infos);
+            if (err && items[i].name) {
+                // keep the error of the parser, but tell which file it is
+                char msg[sizeof(err->msg)];
+                strcpy(msg, err->msg);
+                snprintf(err->msg, sizeof(err->msg), "pack: %.64s: %.160s", items[i].name, msg);
+            } else if (err) {
+                strcpy(err->msg, "pack: invalid item");
+            }
+            return false;
+        }
+        sorted[i].hash = ddsktx_pack_hash(items[i].name);
+        sorted[i].name = items[i].name;
+        sorted[i].index = i;
+        num_subs += ddsktx_num_subresources(&infos[i]);
+        names_size += (int64_t)strlen(items[i].name) + 1;
+    }
+
+    if (num_subs > UINT32_MAX || names_size > UINT32_MAX) {
+        ddsktx_pack_free(sorted);
+        ddsktx_pack_free(infos);
+        ddsktx_pack__err(err, "pack: too many textures");
+    }
+
+    if (num_items > 1) {
+        qsort(sorted, (size_t)num_items, sizeof(ddsktx_pack__sort_item), ddsktx_pack__compare);
+        for (int i = 1; i < num_items; i++) {
+            if (sorted[i].hash == sorted[i-1].hash && strcmp(sorted[i].name, sorted[i-1].name) == 0) {
+                ddsktx_pack_free(sorted);
+                ddsktx_pack_free(infos);
+                ddsktx_pack__err(err, "pack: duplicate texture name");
+            }
+        }
+    }
+
+    // index sections are built in memory, texture files are written directly from the items
+    ddsktx_pack_header header;
+    memset(&header, 0x0, sizeof(header));
+    memcpy(header.magic, k__pack_magic, sizeof(header.magic));
+    header.version = DDSKTX_PACK_VERSION;
+    header.num_textures = (uint32_t)num_items;
+    header.num_subs = (uint32_t)num_subs;
+    header.names_size = (uint32_t)names_size;
+    header.hashes_offset = ddsktx_pack__align((int64_t)sizeof(header), DDSKTX_PACK__SECTION_ALIGN);
+    header.records_offset = ddsktx_pack__align(header.hashes_offset + (int64_t)sizeof(uint64_t)*num_items,
+                                               DDSKTX_PACK__SECTION_ALIGN);
+    header.subs_offset = ddsktx_pack__align(header.records_offset + (int64_t)sizeof(ddsktx_pack_record)*num_items,
+                                            DDSKTX_PACK__SECTION_ALIGN);
+    header.names_offset = ddsktx_pack__align(header.subs_offset + (int64_t)sizeof(ddsktx_sub_entry)*num_subs,
+                                             DDSKTX_PACK__SECTION_ALIGN);
+
+    size_t index_size = sizeof(uint64_t)*num_items + sizeof(ddsktx_pack_record)*num_items +
+                        sizeof(ddsktx_sub_entry)*(size_t)num_subs + (size_t)names_size;
+    uint8_t* index = index_size > 0 ? (uint8_t*)ddsktx_pack_malloc(index_size) : NULL;
+    if (index_size > 0 && !index) {
+        ddsktx_pack_free(sorted);
+        ddsktx_pack_free(infos);
+        ddsktx_pack__err(err, "pack: out of memory");
+    }
+    if (index) {
+        memset(index, 0x0, index_size);
+    }
+
+    uint64_t* hashes = (uint64_t*)index;
+    ddsktx_pack_record* records = (ddsktx_pack_record*)(hashes + num_items);
+    ddsktx_sub_entry* subs = (ddsktx_sub_entry*)(records + num_items);
+    char* names = (char*)(subs + num_subs);
+
+    int64_t file_offset = ddsktx_pack__align(header.names_offset + names_size, DDSKTX_PACK_ALIGN);
+    uint32_t first_sub = 0;
+    uint32_t name_offset = 0;
+    for (int i = 0; i < num_items; i++) {
+        const ddsktx_pack_item* item = &items[sorted[i].index];
+        const ddsktx_texture_info* tc = &infos[sorted[i].index];
+        ddsktx_pack_record* rec = &records[i];
+        int tc_subs = ddsktx_num_subresources(tc);
+
+        hashes[i] = sorted[i].hash;
+        rec->file_offset = file_offset;
+        rec->file_size = (int64_t)item->size;
+        rec->data_offset = tc->data_offset;
+        rec->size_bytes = tc->size_bytes;
+        rec->metadata_offset = tc->metadata_offset;
+        rec->name_offset = name_offset;
+        rec->first_sub = first_sub;
+        rec->format = (int32_t)tc->format;
+        rec->flags = tc->flags;
+        rec->width = tc->width;
+        rec->height = tc->height;
+        rec->depth = tc->depth;
+        rec->num_layers = tc->num_layers;
+        rec->num_mips = tc->num_mips;
+        rec->bpp = tc->bpp;
+        rec->metadata_size = tc->metadata_size;
+        rec->supercompression = (int32_t)tc->supercompression;
+
+        // validated textures always fit their table, so this can't fail
+        bool table_ok = ddsktx_build_subresource_table(tc, &subs[first_sub], tc_subs);
+        assert(table_ok);
+        (void)table_ok;
+
+        size_t name_len = strlen(item->name) + 1;
+        memcpy(names + name_offset, item->name, name_len);
+
+        first_sub += (uint32_t)tc_subs;
+        name_offset += (uint32_t)name_len;
+        file_offset = ddsktx_pack__align(file_offset + (int64_t)item->size, DDSKTX_PACK_ALIGN);
+    }
+    header.file_size = file_offset;
+
+    // paddings are written as zeros, so the same items always give the same pack
+    int64_t offset = 0;
+    offset = ddsktx_pack__write(write_cb, user, offset, &header, sizeof(header), DDSKTX_PACK__SECTION_ALIGN);
+    if (offset >= 0) {
+        offset = ddsktx_pack__write(write_cb, user, offset, hashes, (int64_t)sizeof(uint64_t)*num_items,
+                                    DDSKTX_PACK__SECTION_ALIGN);
+    }
+    if (offset >= 0) {
+        offset = ddsktx_pack__write(write_cb, user, offset, records, (int64_t)sizeof(ddsktx_pack_record)*num_items,
+                                    DDSKTX_PACK__SECTION_ALIGN);
+    }
+    if (offset >= 0) {
+        offset = ddsktx_pack__write(write_cb, user, offset, subs, (int64_t)sizeof(ddsktx_sub_entry)*num_subs,
+                                    DDSKTX_PACK__SECTION_ALIGN);
+    }
+    if (offset >= 0) {
+        offset = ddsktx_pack__write(write_cb, user, offset, names, names_size, DDSKTX_PACK_ALIGN);
+    }
+    for (int i = 0; i < num_items && offset >= 0; i++) {
+        const ddsktx_pack_item* item = &items[sorted[i].index];
+        offset = ddsktx_pack__write(write_cb, user, offset, item->file_data, (int64_t)item->size, DDSKTX_PACK_ALIGN);
+    }
+
+    ddsktx_pack_free(index);
+    ddsktx_pack_free(sorted);
+    ddsktx_pack_free(infos);
+
+    if (offset < 0) {
+        ddsktx_pack__err(err, "pack: write failed");
+    }
+    assert(offset == header.file_size);
+    return true;
+}
+
+static inline bool ddsktx_pack__in_range(int64_t offset, int64_t size, int64_t total)
+{
+    return offset >= 0 && size >= 0 && offset <= total && size <= total - offset;
+}
+
+static void ddsktx_pack__record_info(const ddsktx_pack_record* rec, ddsktx_texture_info* tc)
+{
+    memset(tc, 0x0, sizeof(ddsktx_texture_info));
+    tc->data_offset = rec->data_offset;
+    tc->size_bytes = rec->size_bytes;
+    tc->format = (ddsktx_format)rec->format;
+    tc->flags = rec->flags & ~(unsigned int)DDSKTX_TEXTURE_FLAG_VALIDATED;
+    tc->width = rec->width;
+    tc->height = rec->height;
+    tc->depth = rec->depth;
+    tc->num_layers = rec->num_layers;
+    tc->num_mips = rec->num_mips;
+    tc->bpp = rec->bpp;
+    tc->metadata_offset = rec->metadata_offset;
+    tc->metadata_size = rec->metadata_size;
+    tc->supercompression = (ddsktx_supercompression)rec->supercompression;
+}
+
+bool ddsktx_pack_open(ddsktx_pack* pack, const void* data, size_t size, ddsktx_error* err)
+{
+    assert(pack);
+    assert(data);
+
+    memset(pack, 0x0, sizeof(ddsktx_pack));
+
+    const ddsktx_pack_header* header = (const ddsktx_pack_header*)data;
+    int64_t total = (int64_t)size;
+    if (size < sizeof(ddsktx_pack_header)) {
+        ddsktx_pack__err(err, "pack: header is truncated");
+    }
+    if (memcmp(header->magic, k__pack_magic, sizeof(header->magic)) != 0) {
+        ddsktx_pack__err(err, "pack: invalid file");
+    }
+    if (header->version != DDSKTX_PACK_VERSION) {
+        ddsktx_pack__err(err, "pack: unsupported version");
+    }
+    if (header->num_textures > INT32_MAX || header->file_size > total ||
+        !ddsktx_pack__in_range(header->hashes_offset, (int64_t)sizeof(uint64_t)*header->num_textures, total) ||
+        !ddsktx_pack__in_range(header->records_offset, (int64_t)sizeof(ddsktx_pack_record)*header->num_textures, total) ||
+        !ddsktx_pack__in_range(header->subs_offset, (int64_t)sizeof(ddsktx_sub_entry)*header->num_subs, total) ||
+        !ddsktx_pack__in_range(header->names_offset, header->names_size, total) ||
+        (header->hashes_offset | header->records_offset | header->subs_offset) % 8 != 0)
+    {
+        ddsktx_pack__err(err, "pack: index is truncated");
+    }
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    const char* names = (const char*)(bytes + header->names_offset);
+    if (header->num_textures > 0 && (header->names_size == 0 || names[header->names_size - 1] != '\0')) {
+        ddsktx_pack__err(err, "pack: invalid name table");
+    }
+
+    // records are checked once here, so lookups don't need to
+    const uint64_t* hashes = (const uint64_t*)(bytes + header->hashes_offset);
+    const ddsktx_pack_record* records = (const ddsktx_pack_record*)(bytes + header->records_offset);
+    for (uint32_t i = 0; i < header->num_textures; i++) {
+        const ddsktx_pack_record* rec = &records[i];
+        bool cubemap = (rec->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0;
+        bool supercompressed = rec->supercompression != DDSKTX_SUPERCOMPRESSION_NONE;
+        int64_t num_subs = -1;
+        if (rec->num_layers > 0 && rec->num_mips > 0 && rec->depth > 0 && !(cubemap && rec->depth > 1)) {
+            num_subs = (int64_t)rec->num_layers * rec->num_mips * (cubemap ? DDSKTX_CUBE_FACE_COUNT : rec->depth);
+        }
+        if (!ddsktx_pack__in_range(rec->file_offset, rec->file_size, header->file_size) ||
+            !ddsktx_pack__in_range(rec->data_offset, rec->size_bytes, rec->file_size) ||
+            rec->name_offset >= header->names_size || (i > 0 && hashes[i] < hashes[i-1]) ||
+            rec->format < 0 || rec->format >= _DDSKTX_FORMAT_COUNT || rec->format == _DDSKTX_FORMAT_COMPRESSED ||
+            num_subs < 0 || !ddsktx_pack__in_range(rec->first_sub, num_subs, header->num_subs) ||
+            (supercompressed && (!(rec->flags & DDSKTX_TEXTURE_FLAG_KTX2) ||
+                                 (rec->supercompression != DDSKTX_SUPERCOMPRESSION_ZSTD &&
+                                  rec->supercompression != DDSKTX_SUPERCOMPRESSION_ZLIB))))
+        {
+            ddsktx_pack__err(err, "pack: invalid index record");
+        }
+
+        // supercompressed KTX2 tables are relative to the decoded levels, not to the file. The record check above
+        // only allows the schemes of the KTX2 parser on KTX2 records, so DDS/KTX tables are always checked
+        const ddsktx_sub_entry* subs = (const ddsktx_sub_entry*)(bytes + header->subs_offset) + rec->first_sub;
+        for (int64_t k = 0; k < num_subs && !supercompressed; k++) {
+            if (!ddsktx_pack__in_range(subs[k].offset, subs[k].size_bytes, rec->file_size)) {
+                ddsktx_pack__err(err, "pack: invalid subresource table");
+            }
+        }
+
+        // the flags in the record are not trusted, ddsktx_get_sub skips the bounds checks for validated textures
+        ddsktx_texture_info tc;
+        ddsktx_pack__record_info(rec, &tc);
+        if (rec->file_size == 0 || ddsktx_validate(&tc, bytes + rec->file_offset, (size_t)rec->file_size) != DDSKTX_OK) {
+            ddsktx_pack__err(err, "pack: texture does not match its file");
+        }
+    }
+
+    pack->data = bytes;
+    pack->size = size;
+    pack->num_textures = (int)header->num_textures;
+    pack->hashes = hashes;
+    pack->records = records;
+    pack->subs = (const ddsktx_sub_entry*)(bytes + header->subs_offset);
+    pack->names = names;
+    return true;
+}
+
+int ddsktx_pack_find(const ddsktx_pack* pack, const char* name)
+{
+    assert(pack);
+    assert(name);
+
+    uint64_t hash = ddsktx_pack_hash(name);
+    int first = 0;
+    int count = pack->num_textures;
+    while (count > 0) {
+        int step = count / 2;
+        if (pack->hashes[first + step] < hash) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    // names with the same hash are next to each other
+    for (int i = first; i < pack->num_textures && pack->hashes[i] == hash; i++) {
+        if (strcmp(pack->names + pack->records[i].name_offset, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ddsktx_pack_texture_info(const ddsktx_pack* pack, int index, ddsktx_texture_info* tc)
+{
+    assert(pack);
+    assert(tc);
+    assert(index >= 0 && index < pack->num_textures);
+
+    // every record passed ddsktx_validate in ddsktx_pack_open
+    ddsktx_pack__record_info(&pack->records[index], tc);
+    tc->flags |= DDSKTX_TEXTURE_FLAG_VALIDATED;
+}
+
+const void* ddsktx_pack_file_data(const ddsktx_pack* pack, int index, size_t* size)
+{
+    assert(pack);
+    assert(index >= 0 && index < pack->num_textures);
+
+    const ddsktx_pack_record* rec = &pack->records[index];
+    if (size) {
+        *size = (size_t)rec->file_size;
+    }
+    return pack->data + rec->file_offset;
+}
+
+const char* ddsktx_pack_name(const ddsktx_pack* pack, int index)
+{
+    assert(pack);
+    assert(index >= 0 && index < pack->num_textures);
+    return pack->names + pack->records[index].name_offset;
+}
+
+const ddsktx_sub_entry* ddsktx_pack_sub_table(const ddsktx_pack* pack, int index)
+{
+    assert(pack);
+    assert(index >= 0 && index < pack->num_textures);
+    return pack->subs + pack->records[index].first_sub;
+}
+
+void ddsktx_pack_get_sub(const ddsktx_pack* pack, int index, ddsktx_sub_data* sub_data,
+                         int array_idx, int slice_face_idx, int mip_idx)
+{
+    assert(pack);
+    assert(index >= 0 && index < pack->num_textures);
+
+    const ddsktx_pack_record* rec = &pack->records[index];
+    assert(rec->supercompression == DDSKTX_SUPERCOMPRESSION_NONE &&
+           "supercompressed levels must be decoded first, see ddsktx_decode_level");
+
+    ddsktx_texture_info tc;
+    ddsktx_pack_texture_info(pack, index, &tc);
+    ddsktx_get_sub_indexed(&tc, pack->subs + rec->first_sub, sub_data, pack->data + rec->file_offset,
+                           array_idx, slice_face_idx, mip_idx);
+}
+
+#endif  // DDSKTX_PACK_IMPLEMENT
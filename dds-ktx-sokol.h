@@ -0,0 +1,364 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// dds-ktx-sokol.h - Optional sokol_gfx helpers for dds-ktx.h
+//      Builds a complete sg_image_desc (2D, cube, array and 3D textures, all mips) from a parsed texture,
+//      with one pass over the subresource table
+//      Formats that sokol_gfx (or the current backend) doesn't support are converted or decoded on the CPU
+//
+//      Include sokol_gfx.h before this file, and define DDSKTX_SOKOL_IMPLEMENT in one source file
+//      (together with DDSKTX_IMPLEMENT, or in the same translation unit that implements dds-ktx.h)
+//
+//      Overriable macros:
+//          DDSKTX_SOKOL_API    function specifier for public functions (default: DDSKTX_API)
+//          ddsktx_sg_malloc    default: malloc(size)
+//          ddsktx_sg_free      default: free(ptr)
+//          ddsktx_sg_assert    default: assert(a)
+//
+//      API:
+//          sg_pixel_format ddsktx_sg_pixel_format(ddsktx_format format, unsigned int flags);
+//              Returns the sokol_gfx pixel format of a ddsktx format, _SG_PIXELFORMAT_DEFAULT if there isn't any
+//              flags: ddsktx_texture_info.flags, for the signed variant of BC6H (sRGB has no sokol_gfx formats)
+//
+//          bool ddsktx_sg_image_desc(const ddsktx_texture_info* tc, const void* file_data, int layer,
+//                                    sg_image_desc* desc, void** mem);
+//              Fills type, size, mips, pixel_format and content of 'desc', other members are not touched
+//              layer: DDSKTX_SG_ALL_LAYERS creates an array (or 3D) image with all array layers (depth slices),
+//                     otherwise only this array layer (depth slice) is used for a 2D (or cube) image
+//              Sub-images point to file_data if the data is already laid out like sokol_gfx wants it (one piece
+//              per mip), otherwise they are gathered or converted into '*mem', which must stay valid until
+//              sg_make_image and be freed by ddsktx_sg_free_mem (it's NULL if nothing is allocated)
+//              Mips beyond SG_MAX_MIPMAPS are skipped. Returns false if the texture can't be represented:
+//              cube arrays with DDSKTX_SG_ALL_LAYERS, formats that are neither supported nor decodable, or
+//              supercompressed KTX2 (decode the levels with ddsktx_decode_level first)
+//              Must be called after sg_setup, because it queries the backend for pixel format support
+//
+//          void ddsktx_sg_free_mem(void* mem);
+//              Frees the memory that is returned by ddsktx_sg_image_desc
+//
+//          sg_image ddsktx_sg_make_image(const ddsktx_texture_info* tc, const void* file_data, int layer,
+//                                        const sg_image_desc* base);
+//              Builds the descriptor, creates the image and frees the temp memory, 'base' (can be NULL) provides
+//              the rest of the parameters (filters, wrap modes, label, ...). Returns an invalid image on error
+//
+//      Example:
+//          ddsktx_texture_info tc;
+//          if (ddsktx_parse(&tc, data, size, NULL)) {
+//              sg_image img = ddsktx_sg_make_image(&tc, data, DDSKTX_SG_ALL_LAYERS,
+//                                                  &(sg_image_desc){ .min_filter = SG_FILTER_LINEAR });
+//          }
+//
+#pragma once
+
+#if !defined(SOKOL_GFX_INCLUDED)
+#   error "Please include sokol_gfx.h before dds-ktx-sokol.h"
+#endif
+
+#include "dds-ktx.h"
+
+#ifndef DDSKTX_SOKOL_API
+#   define DDSKTX_SOKOL_API DDSKTX_API
+#endif
+
+#define DDSKTX_SG_ALL_LAYERS -1
+
+DDSKTX_SOKOL_API sg_pixel_format ddsktx_sg_pixel_format(ddsktx_format format, unsigned int flags);
+DDSKTX_SOKOL_API bool ddsktx_sg_image_desc(const ddsktx_texture_info* tc, const void* file_data, int layer,
+                                           sg_image_desc* desc, void** mem);
+DDSKTX_SOKOL_API void ddsktx_sg_free_mem(void* mem);
+DDSKTX_SOKOL_API sg_image ddsktx_sg_make_image(const ddsktx_texture_info* tc, const void* file_data, int layer,
+                                               const sg_image_desc* base);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef DDSKTX_SOKOL_IMPLEMENT
+
+#include <string.h>
+#include <limits.h>
+
+#ifndef ddsktx_sg_malloc
+#   include <stdlib.h>
+#   define ddsktx_sg_malloc(_size)    malloc(_size)
+#endif
+
+#ifndef ddsktx_sg_free
+#   include <stdlib.h>
+#   define ddsktx_sg_free(_ptr)       free(_ptr)
+#endif
+
+#ifndef ddsktx_sg_assert
+#   include <assert.h>
+#   define ddsktx_sg_assert(_a)       assert(_a)
+#endif
+
+// how sub-images are turned into the sokol_gfx image
+typedef struct ddsktx_sg__source
+{
+    ddsktx_convert_op   convert_op;     // row conversion, or DDSKTX_CONVERT_NONE
+    bool                decode;         // block decoding (ddsktx_decode_blocks)
+    int                 pixel_bytes;    // bytes per pixel of the converted/decoded data
+} ddsktx_sg__source;
+
+sg_pixel_format ddsktx_sg_pixel_format(ddsktx_format format, unsigned int flags)
+{
+    switch (format) {
+    case DDSKTX_FORMAT_BC1:      return SG_PIXELFORMAT_BC1_RGBA;
+    case DDSKTX_FORMAT_BC2:      return SG_PIXELFORMAT_BC2_RGBA;
+    case DDSKTX_FORMAT_BC3:      return SG_PIXELFORMAT_BC3_RGBA;
+    case DDSKTX_FORMAT_BC4:      return SG_PIXELFORMAT_BC4_R;
+    case DDSKTX_FORMAT_BC5:      return SG_PIXELFORMAT_BC5_RG;
+    case DDSKTX_FORMAT_BC6H:     return (flags & DDSKTX_TEXTURE_FLAG_SIGNED) ? SG_PIXELFORMAT_BC6H_RGBF :
+                                                                             SG_PIXELFORMAT_BC6H_RGBUF;
+    case DDSKTX_FORMAT_BC7:      return SG_PIXELFORMAT_BC7_RGBA;
+    case DDSKTX_FORMAT_ETC1:     // ETC2 decoders are backward compatible with ETC1
+    case DDSKTX_FORMAT_ETC2:     return SG_PIXELFORMAT_ETC2_RGB8;
+    case DDSKTX_FORMAT_ETC2A:    return SG_PIXELFORMAT_ETC2_RGBA8;
+    case DDSKTX_FORMAT_ETC2A1:   return SG_PIXELFORMAT_ETC2_RGB8A1;
+    case DDSKTX_FORMAT_PTC12:    return SG_PIXELFORMAT_PVRTC_RGB_2BPP;
+    case DDSKTX_FORMAT_PTC14:    return SG_PIXELFORMAT_PVRTC_RGB_4BPP;
+    case DDSKTX_FORMAT_PTC12A:   return SG_PIXELFORMAT_PVRTC_RGBA_2BPP;
+    case DDSKTX_FORMAT_PTC14A:   return SG_PIXELFORMAT_PVRTC_RGBA_4BPP;
+    case DDSKTX_FORMAT_A8:
+    case DDSKTX_FORMAT_R8:       return SG_PIXELFORMAT_R8;
+    case DDSKTX_FORMAT_RGBA8:    return SG_PIXELFORMAT_RGBA8;
+    case DDSKTX_FORMAT_RGBA8S:   return SG_PIXELFORMAT_RGBA8SN;
+    case DDSKTX_FORMAT_RG16:     return SG_PIXELFORMAT_RG16;
+    case DDSKTX_FORMAT_R16:      return SG_PIXELFORMAT_R16;
+    case DDSKTX_FORMAT_R32F:     return SG_PIXELFORMAT_R32F;
+    case DDSKTX_FORMAT_R16F:     return SG_PIXELFORMAT_R16F;
+    case DDSKTX_FORMAT_RG16F:    return SG_PIXELFORMAT_RG16F;
+    case DDSKTX_FORMAT_RG16S:    return SG_PIXELFORMAT_RG16SN;
+    case DDSKTX_FORMAT_RGBA16F:  return SG_PIXELFORMAT_RGBA16F;
+    case DDSKTX_FORMAT_RGBA16:   return SG_PIXELFORMAT_RGBA16;
+    case DDSKTX_FORMAT_BGRA8:    return SG_PIXELFORMAT_BGRA8;
+    case DDSKTX_FORMAT_RGB10A2:  return SG_PIXELFORMAT_RGB10A2;
+    case DDSKTX_FORMAT_RG11B10F: return SG_PIXELFORMAT_RG11B10F;
+    case DDSKTX_FORMAT_RG8:      return SG_PIXELFORMAT_RG8;
+    case DDSKTX_FORMAT_RG8S:     return SG_PIXELFORMAT_RG8SN;
+    default:                     return _SG_PIXELFORMAT_DEFAULT;    // RGB8, ATC, ASTC
+    }
+}
+
+static bool ddsktx_sg__supported(sg_pixel_format fmt)
+{
+    return fmt != _SG_PIXELFORMAT_DEFAULT && sg_query_pixelformat(fmt).sample;
+}
+
+// picks the sokol_gfx format, and the conversion if the format isn't supported by the backend
+static sg_pixel_format ddsktx_sg__source_format(const ddsktx_texture_info* tc, ddsktx_sg__source* src)
+{
+    src->convert_op = DDSKTX_CONVERT_NONE;
+    src->decode = false;
+    src->pixel_bytes = 0;
+
+    sg_pixel_format fmt = ddsktx_sg_pixel_format(tc->format, tc->flags);
+    if (ddsktx_sg__supported(fmt)) {
+        return fmt;
+    }
+
+    ddsktx_convert_op op = ddsktx_gpu_convert_op(tc->format);
+    switch (tc->format) {
+    case DDSKTX_FORMAT_BGRA8:   op = DDSKTX_CONVERT_BGRA8_TO_RGBA8;      break;
+    case DDSKTX_FORMAT_RGB10A2: op = DDSKTX_CONVERT_RGB10A2_TO_RGBA16;   break;
+    case DDSKTX_FORMAT_R16F:    op = DDSKTX_CONVERT_R16F_TO_R32F;        break;
+    case DDSKTX_FORMAT_RG16F:   op = DDSKTX_CONVERT_RG16F_TO_RG32F;      break;
+    case DDSKTX_FORMAT_RGBA16F: op = DDSKTX_CONVERT_RGBA16F_TO_RGBA32F;  break;
+    default:                                                               break;
+    }
+
+    if (op != DDSKTX_CONVERT_NONE) {
+        switch (op) {
+        case DDSKTX_CONVERT_RGB8_TO_RGBA8:
+        case DDSKTX_CONVERT_BGRA8_TO_RGBA8:      fmt = SG_PIXELFORMAT_RGBA8;   break;
+        case DDSKTX_CONVERT_RGBA8_TO_BGRA8:      fmt = SG_PIXELFORMAT_BGRA8;   break;
+        case DDSKTX_CONVERT_RGB10A2_TO_RGBA16:   fmt = SG_PIXELFORMAT_RGBA16;  break;
+        case DDSKTX_CONVERT_R16F_TO_R32F:        fmt = SG_PIXELFORMAT_R32F;    break;
+        case DDSKTX_CONVERT_RG16F_TO_RG32F:      fmt = SG_PIXELFORMAT_RG32F;   break;
+        case DDSKTX_CONVERT_RGBA16F_TO_RGBA32F:  fmt = SG_PIXELFORMAT_RGBA32F; break;
+        default:                                 return _SG_PIXELFORMAT_DEFAULT;
+        }
+        src->convert_op = op;
+        return ddsktx_sg__supported(fmt) ? fmt : _SG_PIXELFORMAT_DEFAULT;
+    }
+
+    ddsktx_format decode_format = ddsktx_block_decode_format(tc->format);
+    if (decode_format == DDSKTX_FORMAT_RGBA8 || decode_format == DDSKTX_FORMAT_RGBA16F) {
+        src->decode = true;
+        src->pixel_bytes = decode_format == DDSKTX_FORMAT_RGBA8 ? 4 : 8;
+        fmt = decode_format == DDSKTX_FORMAT_RGBA8 ? SG_PIXELFORMAT_RGBA8 : SG_PIXELFORMAT_RGBA16F;
+        return ddsktx_sg__supported(fmt) ? fmt : _SG_PIXELFORMAT_DEFAULT;
+    }
+
+    return _SG_PIXELFORMAT_DEFAULT;
+}
+
+// returns the size of memory that is needed for gathering and converting the sub-images (-1 if a sub-image is 
+// too large for sokol_gfx), with 'fill', also fills the content of 'desc' using 'mem'
+static int64_t ddsktx_sg__content(const ddsktx_texture_info* tc, const ddsktx_sub_entry* table,
+                                  const void* file_data, const ddsktx_sg__source* src,
+                                  int first_item, int num_items, bool volume, sg_image_desc* desc, 
+                                  bool fill, uint8_t* mem)
+{
+    int num_faces = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : 1;
+    int64_t offset = 0;
+
+    for (int face = 0; face < num_faces; face++) {
+        for (int mip = 0; mip < desc->num_mipmaps; mip++) {
+            // items (array layers or depth slices) of a mip must be in one piece for sokol_gfx
+            int64_t size = 0;
+            bool contiguous = true;
+            const uint8_t* first = NULL;
+            for (int i = first_item; i < first_item + num_items; i++) {
+                ddsktx_sub_data sub;
+                ddsktx_get_sub_indexed(tc, table, &sub, file_data, volume ? 0 : i, volume ? i : face, mip);
+                if (!first) {
+                    first = (const uint8_t*)sub.buff;
+                } else if ((const uint8_t*)sub.buff != first + size) {
+                    contiguous = false;
+                }
+
+                if (src->convert_op != DDSKTX_CONVERT_NONE) {
+                    size += (int64_t)ddsktx_convert_row_bytes(src->convert_op, sub.width) * sub.height;
+                } else if (src->decode) {
+                    size += (int64_t)src->pixel_bytes * sub.width * sub.height;
+                } else {
+                    size += sub.size_bytes;
+                }
+            }
+            if (size > INT_MAX) {
+                return -1;
+            }
+
+            bool direct = contiguous && src->convert_op == DDSKTX_CONVERT_NONE && !src->decode;
+            if (fill) {
+                sg_subimage_content* content = &desc->content.subimage[face][mip];
+                content->size = (int)size;
+                if (direct) {
+                    content->ptr = first;
+                } else {
+                    uint8_t* dst = mem + offset;
+                    content->ptr = dst;
+                    for (int i = first_item; i < first_item + num_items; i++) {
+                        ddsktx_sub_data sub;
+                        ddsktx_get_sub_indexed(tc, table, &sub, file_data, volume ? 0 : i, volume ? i : face, mip);
+                        if (src->convert_op != DDSKTX_CONVERT_NONE) {
+                            int row_bytes = ddsktx_convert_row_bytes(src->convert_op, sub.width);
+                            ddsktx_convert_sub(src->convert_op, &sub, dst, row_bytes, 0, sub.height);
+                            dst += (int64_t)row_bytes * sub.height;
+                        } else if (src->decode) {
+                            int row_bytes = src->pixel_bytes * sub.width;
+                            ddsktx_decode_blocks(tc, &sub, dst, row_bytes, 0,
+                                                 (int)(sub.size_bytes / sub.row_pitch_bytes));
+                            dst += (int64_t)row_bytes * sub.height;
+                        } else {
+                            memcpy(dst, sub.buff, (size_t)sub.size_bytes);
+                            dst += sub.size_bytes;
+                        }
+                    }
+                }
+            }
+
+            if (!direct) {
+                offset += size;
+            }
+        }
+    }
+
+    return offset;
+}
+
+bool ddsktx_sg_image_desc(const ddsktx_texture_info* tc, const void* file_data, int layer,
+                          sg_image_desc* desc, void** mem)
+{
+    ddsktx_sg_assert(tc && file_data && desc && mem);
+    *mem = NULL;
+
+    if (tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE) {
+        return false;   // levels are not sub-images in the file
+    }
+
+    bool cubemap = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0;
+    bool volume = !cubemap && tc->depth > 1;
+    int num_items = 1;
+    if (layer == DDSKTX_SG_ALL_LAYERS) {
+        if (cubemap && tc->num_layers > 1) {
+            return false;   // sokol_gfx has no cube arrays
+        }
+        num_items = volume ? tc->depth : tc->num_layers;
+        layer = 0;
+    } else if (layer < 0 || layer >= (volume ? tc->depth : tc->num_layers)) {
+        return false;
+    }
+
+    ddsktx_sg__source src;
+    sg_pixel_format pixel_format = ddsktx_sg__source_format(tc, &src);
+    if (pixel_format == _SG_PIXELFORMAT_DEFAULT) {
+        return false;
+    }
+
+    int num_subs = ddsktx_num_subresources(tc);
+    ddsktx_sub_entry* table = (ddsktx_sub_entry*)ddsktx_sg_malloc(sizeof(ddsktx_sub_entry)*num_subs);
+    if (!table) {
+        return false;
+    }
+    if (!ddsktx_build_subresource_table(tc, table, num_subs)) {
+        ddsktx_sg_free(table);
+        return false;
+    }
+
+    if (cubemap) {
+        desc->type = SG_IMAGETYPE_CUBE;
+    } else if (num_items > 1) {
+        desc->type = volume ? SG_IMAGETYPE_3D : SG_IMAGETYPE_ARRAY;
+    } else {
+        desc->type = SG_IMAGETYPE_2D;
+    }
+    desc->width = tc->width;
+    desc->height = tc->height;
+    desc->depth = num_items;
+    desc->num_mipmaps = tc->num_mips < SG_MAX_MIPMAPS ? tc->num_mips : SG_MAX_MIPMAPS;
+    desc->pixel_format = pixel_format;
+    memset(&desc->content, 0x0, sizeof(desc->content));
+
+    bool r = false;
+    int64_t mem_size = ddsktx_sg__content(tc, table, file_data, &src, layer, num_items, volume, desc, false, NULL);
+    if (mem_size >= 0) {
+        uint8_t* buff = mem_size > 0 ? (uint8_t*)ddsktx_sg_malloc((size_t)mem_size) : NULL;
+        if (buff || mem_size == 0) {
+            ddsktx_sg__content(tc, table, file_data, &src, layer, num_items, volume, desc, true, buff);
+            *mem = buff;
+            r = true;
+        }
+    }
+
+    ddsktx_sg_free(table);
+    return r;
+}
+
+void ddsktx_sg_free_mem(void* mem)
+{
+    if (mem) {
+        ddsktx_sg_free(mem);
+    }
+}
+
+sg_image ddsktx_sg_make_image(const ddsktx_texture_info* tc, const void* file_data, int layer,
+                              const sg_image_desc* base)
+{
+    sg_image_desc desc;
+    if (base) {
+        desc = *base;
+    } else {
+        memset(&desc, 0x0, sizeof(desc));
+    }
+
+    void* mem;
+    sg_image img = { SG_INVALID_ID };
+    if (ddsktx_sg_image_desc(tc, file_data, layer, &desc, &mem)) {
+        img = sg_make_image(&desc);
+        ddsktx_sg_free_mem(mem);
+    }
+    return img;
+}
+
+#endif  // DDSKTX_SOKOL_IMPLEMENT
@@ -10,10 +10,12 @@
 //
 // dds-ktx.h - v1.1.0 - Reader/Writer for DDS/KTX formats
 //      Parses DDS and KTX files from a memory blob, written in C99
+//      Writes DDS and KTX files through a user callback, without assembling the file in memory
 //      
 //      Supported formats:
 //          For supported formats, see ddsktx_format enum. 
 //          Both KTX/DDS parser supports all formats defined in ddsktx_format
+//          KTX2 files are also supported, supercompressed levels (Zstd/ZLIB) are decoded by a user callback
 //
 //      Overriable macros:
 //          DDSKTX_API     Define any function specifier for public functions (default: extern)
@@ -22,6 +24,16 @@
 //          ddsktx_assert  default: assert(a)
 //          ddsktx_strcpy  default: strcpy(dst, src)
 //          ddsktx_memcmp  default: memcmp(ptr1, ptr2, size)
+//          DDSKTX_NO_SIMD Disable SIMD kernels of format conversion functions
+//          DDSKTX_PROFILE_BEGIN(_name), DDSKTX_PROFILE_END(_name)
+//                         Profiler zones around the parsers and the sub-image lookup (default: nothing). _name is an 
+//                         identifier: ddsktx_parse_dds, ddsktx_parse_ktx, ddsktx_parse_ktx2 or ddsktx_get_sub
+//                         Tracy:        BEGIN: TracyCZoneN(_name##_zone, #_name, 1)  END: TracyCZoneEnd(_name##_zone)
+//                         Superluminal: BEGIN: PerformanceAPI_BeginEvent(#_name, NULL, PERFORMANCEAPI_DEFAULT_COLOR)
+//                                       END:   PerformanceAPI_EndEvent()
+//          DDSKTX_PROFILE_COUNTERS 
+//                         Define (for all files that include dds-ktx.h) to enable per-thread counters of parsed files, 
+//                         and sub-images walked and returned by the lookups, see ddsktx_get_profile_counters
 //          
 //      API:
 //          bool ddsktx_parse(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err);
@@ -29,6 +41,51 @@
 //              Returns true if successfully parsed, false if failed with an error message inside ddsktx_error parameter (optional)
 //              After format is parsed, you can read the contents of ddsktx_format and create your GPU texture
 //              To get pointer to mips and slices see ddsktx_get_sub function
+//
+//          ddsktx_result ddsktx_parse_result(ddsktx_texture_info* tc, const void* file_data, size_t size);
+//              Same as ddsktx_parse64, but returns the error code instead of copying an error message
+//              Use ddsktx_error_str to get the message, only when it's needed
+//
+//          bool ddsktx_parse64(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err);
+//              Same as ddsktx_parse, but accepts file data larger than 2GB (for example memory-mapped files)
+//              All offsets and sizes in ddsktx_texture_info and ddsktx_sub_data are 64bit regardless of the API used
+//
+//          bool ddsktx_parse_strict(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err);
+//              Same as ddsktx_parse64, followed by ddsktx_validate. Use it for untrusted files (downloads, mods)
+//
+//          ddsktx_result ddsktx_validate(ddsktx_texture_info* tc, const void* file_data, size_t size);
+//              Checks the whole computed layout against the file once: dimensions and counts (mips can't exceed 
+//              the mip chain, so offset math can't overflow), KTX imageSize fields and paddings, and the end of
+//              every sub-image against the file size. On success, DDSKTX_TEXTURE_FLAG_VALIDATED is set in tc->flags 
+//              and ddsktx_get_sub skips its per-call checks (asserts and KTX imageSize reads) for that texture
+//              Without validation, ddsktx_get_sub returns a NULL buff for sub-images past the end of the file
+//
+//          ddsktx_profile_counters ddsktx_get_profile_counters(bool reset);
+//              Only with DDSKTX_PROFILE_COUNTERS. Returns the counters of the calling thread, and optionally clears them
+//              subs_walked/subs_returned is the cost of ddsktx_get_sub for each returned sub-image, DDS and KTX files
+//              walk the layout to the requested sub-image (use ddsktx_build_subresource_table for many lookups)
+//
+//          bool ddsktx_parse_header(ddsktx_texture_info* tc, const void* header_data, int header_size, 
+//                                   int64_t file_size, int64_t* required_size, ddsktx_error* err);
+//              Parses the texture from the first 'header_size' bytes of the file only (for streaming)
+//              file_size: total size of the file, used to fill data_offset/size_bytes in ddsktx_texture_info
+//              required_size (optional): number of prefix bytes that is needed to parse the header, 
+//                                        this includes DX10 header in DDS and key/value data block in KTX
+//              If the function fails and required_size is larger than header_size, read at least required_size
+//              bytes of the file and call it again. Reading the first 4KB is usually enough
+//              On success, required_size is the start of pixel data (KTX key/value data is not needed for parsing)
+//              Pixel data is never accessed, use ddsktx_build_subresource_table to get file offsets of sub-images
+//
+//          bool ddsktx_parse_reader(ddsktx_texture_info* tc, const ddsktx_reader* reader, ddsktx_error* err);
+//              Same as ddsktx_parse, but reads the file through user callbacks (see ddsktx_reader) 
+//              instead of a memory blob. Only the header parts of the file are read
+//          
+//          int ddsktx_parse_batch(const ddsktx_blob* blobs, int count, ddsktx_texture_info* infos, 
+//                                 ddsktx_result* results);
+//              Parses 'count' memory blobs into 'infos', and writes a compact error code for each one in 'results'
+//              Error messages are not generated. Returns the number of successfully parsed files
+//              The parser has no global state, so the arrays can be split to ranges and parsed on different 
+//              threads at the same time: ddsktx_parse_batch(blobs + first, num, infos + first, results + first)
 //          
 //          void ddsktx_get_sub(const ddsktx_texture_info* tex, ddsktx_sub_data* buff, 
 //                           const void* file_data, int size,
@@ -40,13 +97,204 @@
 //                              if 'flags' have DDSKTX_TEXTURE_FLAG_CUBEMAP bit, then this value represents cube-face-index (0..DDSKTX_CUBE_FACE_COUNT)
 //                              else it represents depth slice index (0..depth)
 //              mip_idx: mip index (0..num_mips-1 in ddsktx_texture_info)
+//
+//          void ddsktx_get_sub64(const ddsktx_texture_info* tex, ddsktx_sub_data* buff, 
+//                                const void* file_data, size_t size,
+//                                int array_idx, int slice_face_idx, int mip_idx);
+//              Same as ddsktx_get_sub, but accepts file data larger than 2GB
+//
+//          bool ddsktx_read_sub(const ddsktx_texture_info* tc, const ddsktx_reader* reader,
+//                               void* dst, int64_t dst_size, ddsktx_sub_data* buff,
+//                               int array_idx, int slice_face_idx, int mip_idx);
+//              Reads sub-image data through the reader callbacks into 'dst' (must be at least size_bytes of the sub-image)
+//              buff->buff will point to 'dst'. Returns false if dst_size is too small or reading fails
+//              To read many sub-images, it's cheaper to build the subresource table and read the offsets directly
+//
+//          int ddsktx_num_subresources(const ddsktx_texture_info* tc);
+//              Returns total number of sub-images (layers * faces * mips * slices) in the texture
+//
+//          bool ddsktx_build_subresource_table(const ddsktx_texture_info* tc, ddsktx_sub_entry* entries, int max_entries);
+//              Calculates offset/size/pitch of all sub-images in one pass and fills the 'entries' array
+//              entries must have at least ddsktx_num_subresources() items
+//              Returns false if 'entries' is smaller than that, or the file data is truncated
+//              Entries are in upload order: for each array layer, for each face, for each mip, for each slice
+//              The table only depends on the texture info, so it can be built once and reused
+//
+//          int ddsktx_sub_index(const ddsktx_texture_info* tc, int array_idx, int slice_face_idx, int mip_idx);
+//              Returns the index of the sub-image in the table built by ddsktx_build_subresource_table
+//
+//          void ddsktx_get_sub_indexed(const ddsktx_texture_info* tc, const ddsktx_sub_entry* table,
+//                                      ddsktx_sub_data* buff, const void* file_data,
+//                                      int array_idx, int slice_face_idx, int mip_idx);
+//              Same as ddsktx_get_sub, but reads the sub-image from the table in O(1), instead of walking the file
+//
+//          int64_t ddsktx_staging_layout(const ddsktx_texture_info* tc, const ddsktx_staging_policy* policy,
+//                                        ddsktx_staging_footprint* footprints, int max_footprints);
+//              Lays out all sub-images in a staging buffer with the row pitch and offset alignments of 'policy'
+//              Returns the total size of the staging buffer, or -1 if 'max_footprints' is smaller than 
+//              ddsktx_num_subresources(). footprints can be NULL to only get the size
+//              Footprints are in the order of the subresource table (see ddsktx_sub_index), which is also the 
+//              D3D12 subresource order. Depth slices of a 3D mip follow each other without extra alignment, 
+//              at row_pitch_bytes*num_rows apart, as D3D12 and Vulkan copies of 3D textures expect
+//              Offsets are aligned to sub_offset_align and rounded up to the block size (or pixel size) of the format
+//
+//          void ddsktx_copy_sub(const ddsktx_sub_data* sub, void* dst, int dst_row_pitch);
+//              Copies the rows of a sub-image to 'dst' with a different row pitch (footprint row_pitch_bytes)
+//              Together with ddsktx_staging_layout, the staging buffer can be filled in one linear pass:
+//                  ddsktx_get_sub(&tc, &sub, data, size, layer, face, mip); 
+//                  ddsktx_copy_sub(&sub, mapped + fp[i].offset, fp[i].row_pitch_bytes);
+//
+//          int ddsktx_get_tile_spans(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub,
+//                                    int x, int y, int width, int height, ddsktx_rect* aligned,
+//                                    ddsktx_file_range* spans, int max_spans);
+//              Calculates the byte spans of the pixel rectangle (a virtual texture tile) in a sub-image that is 
+//              fetched by ddsktx_get_sub or ddsktx_get_sub_indexed, one span per block-row, so only the rows of the 
+//              tile have to be read from the file. The rectangle is clipped to the mip and extended to block 
+//              boundaries, the result goes to 'aligned' (optional). Rows that cover the whole width are merged
+//              Span offsets are relative to the start of the sub-image: add the file offset of the sub-image 
+//              (ddsktx_sub_entry offset, or sub->buff - file_data) to read them from the file
+//              Copying the spans back to back gives the tile with a row pitch of aligned->width/block_width blocks
+//              PVRTC blocks are not stored in rows, so the whole sub-image makes one span (aligned is the whole mip)
+//              Returns the number of spans that is needed, at most 'max_spans' are written ('spans' can be NULL)
+//              Returns 0 if the rectangle is outside the mip
+//
+//          int64_t ddsktx_swizzled_size(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_swizzle swizzle);
+//          bool ddsktx_swizzle_sub(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_swizzle swizzle,
+//                                  void* dst, int64_t dst_size);
+//              Writes a (linear) sub-image from ddsktx_get_sub in a GPU tiled layout, for cooking pre-swizzled 
+//              content or for writing straight into mapped memory of tiled textures on UMA/console targets
+//              The layout is in units of blocks (pixels for uncompressed formats), see ddsktx_swizzle. Padding of the 
+//              layout (to power of two or whole tiles) is cleared to zero. Depth slices are swizzled one by one, as 2D
+//              ddsktx_swizzled_size returns the size of the layout, or -1 if the format is not supported: PVRTC 
+//              (already twiddled) and formats with a block size that is not a power of two (RGB8)
+//              ddsktx_swizzle_sub returns false if the format is not supported or dst_size is too small
+//
+//          int ddsktx_get_mip_ranges(const ddsktx_texture_info* tc, int first_mip, int num_mips,
+//                                    ddsktx_file_range* ranges, int max_ranges);
+//              Calculates the minimal set of contiguous file ranges that contains mips [first_mip, first_mip+num_mips)
+//              of all array layers and faces/slices, for streaming some of the mips (for example the mip tail)
+//              Ranges are sorted by file offset and adjacent ranges are merged. In KTX files, ranges also cover 
+//              the imageSize fields and paddings in between, so the sub-image offsets from subresource table are valid  
+//              Returns the number of ranges that is needed, at most 'max_ranges' are written ('ranges' can be NULL)
+//              KTX files always result in one range, DDS files in one range per layer/face, unless the ranges meet
+//              Not available for supercompressed KTX2 files, use ddsktx_get_level_range for each mip instead
+//
+//          bool ddsktx_get_level_range(const ddsktx_texture_info* tc, const void* file_data, size_t size, int mip_idx,
+//                                      ddsktx_file_range* range, int64_t* uncompressed_size);
+//              KTX2 only: Reads the level index and returns the file range of a mip level (all layers and faces)
+//              file_data can be just the header part of the file (see ddsktx_parse_header)
+//              uncompressed_size (optional): size of the level after it's decoded, see ddsktx_decode_level
+//
+//          bool ddsktx_decode_level(const ddsktx_texture_info* tc, int mip_idx, const void* src, int64_t src_size,
+//                                   void* dst, int64_t dst_size, ddsktx_decode_cb* decode_cb, void* user);
+//              KTX2 only: Decodes a supercompressed mip level, src is the data from ddsktx_get_level_range
+//              The decompression itself (Zstd, ZLIB) is done by the user in decode_cb, the function can be called
+//              from worker threads. For supercompressed files, subresource table offsets are relative to the 
+//              start of each decoded level, so the table can be used with the decoded data as 'file_data'
 //          
+//          void ddsktx_metadata_begin(const ddsktx_texture_info* tc, const void* file_data, size_t size, 
+//                                     ddsktx_metadata_iter* iter);
+//          bool ddsktx_metadata_next(ddsktx_metadata_iter* iter, ddsktx_metadata* kv);
+//              Iterates over the key/value pairs of KTX/KTX2 files (DDS files have no metadata)
+//              file_data can be the whole file or just the header part (metadata block must be inside)
+//              kv->key and kv->value point into file_data, nothing is allocated or copied
+//              Returns false when there are no more pairs, or the rest of the block is malformed
+//              Example:
+//                  ddsktx_metadata_iter iter;
+//                  ddsktx_metadata kv;
+//                  ddsktx_metadata_begin(&tc, file_data, size, &iter);
+//                  while (ddsktx_metadata_next(&iter, &kv)) {
+//                      if (strcmp(kv.key, "KTXorientation") == 0) { ...; break; }
+//                  }
+//
+//          bool ddsktx_metadata_find(const ddsktx_texture_info* tc, const void* file_data, size_t size,
+//                                    const char* key, ddsktx_metadata* kv);
+//              Finds the first pair with the key, returns false if not found
+//
+//          bool ddsktx_write_dds(const ddsktx_texture_info* tc, const void* const* subs, 
+//                                ddsktx_write_cb* write_cb, void* user, ddsktx_error* err);
+//          bool ddsktx_write_ktx(const ddsktx_texture_info* tc, const void* const* subs, 
+//                                ddsktx_write_cb* write_cb, void* user, ddsktx_error* err);
+//              Writes a DDS/KTX file from the texture description and sub-image data
+//              Only format, flags (CUBEMAP, SRGB), width, height, depth, num_layers and num_mips of 'tc' are used
+//              subs: pointers to ddsktx_num_subresources() sub-images, indexed by ddsktx_sub_index
+//                    each one is tightly packed with the size calculated for it's mip (see ddsktx_sub_entry)
+//              Output is passed to 'write_cb' as lists of buffers that should be written one after another (gather)
+//              Sub-image buffers are passed as is and never copied, only headers and paddings are generated
+//              DDS files use the DX10 header if the format has a DXGI code, otherwise the legacy header (no arrays)
+//
+//          ddsktx_convert_op ddsktx_gpu_convert_op(ddsktx_format format);
+//              Returns the conversion that is needed to upload the format to GPU, DDSKTX_CONVERT_NONE if not needed
+//              Currently only RGB8, which has no GPU format, is converted (to RGBA8)
+//
+//          int ddsktx_convert_row_bytes(ddsktx_convert_op op, int width);
+//              Returns the size of one converted row in bytes, the destination rows are tightly packed with this
+//
+//          void ddsktx_convert_row(ddsktx_convert_op op, const void* src, void* dst, int width);
+//              Converts 'width' pixels, src and dst can be the same buffer only if the pixel sizes are equal (swizzles)
+//              Uses SSE2/SSSE3/F16C or NEON when they are enabled by the compiler, define DDSKTX_NO_SIMD to disable
+//
+//          void ddsktx_convert_sub(ddsktx_convert_op op, const ddsktx_sub_data* sub, void* dst, int dst_row_pitch,
+//                                  int first_row, int num_rows);
+//              Converts rows [first_row, first_row+num_rows) of a sub-image into 'dst' (first converted row)
+//              Source rows are read with sub->row_pitch_bytes, so a sub-image can be converted in parts, 
+//              directly into mapped staging memory with it's own row pitch
+//
+//          ddsktx_format ddsktx_block_decode_format(ddsktx_format format);
+//              Returns the format that ddsktx_decode_blocks outputs for a compressed format:
+//              RGBA8 for BC1/BC2/BC3/BC4/BC5/BC7/ETC1/ETC2/ETC2A/ETC2A1/ASTC and RGBA16F for BC6H, 
+//              _DDSKTX_FORMAT_COUNT if there is no decoder
+//
+//          bool ddsktx_decode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, void* dst,
+//                                    int dst_row_pitch, int first_block_row, int num_block_rows);
+//              Decodes BC1-BC7, ETC1/ETC2 and ASTC block rows [first_block_row, first_block_row+num_block_rows) of a 
+//              sub-image that is fetched by ddsktx_get_sub, directly into 'dst' (pixel row first_block_row times the
+//              block height), edges are clipped to sub->width/height
+//              A sub-image has sub->size_bytes/sub->row_pitch_bytes block rows
+//              Block rows are independent, so the image can be split into jobs between threads
+//              BC4/BC5 output missing channels as zero, sRGB data is not converted to linear
+//              ASTC is decoded with the 2D LDR profile: HDR, void-extent HDR and invalid blocks decode to magenta,
+//              as the LDR profile requires. sRGB textures (DDSKTX_TEXTURE_FLAG_SRGB) use the sRGB endpoint expansion
+//              Returns false if the format cannot be decoded
+//
+//          ddsktx_format ddsktx_transcode_format(ddsktx_format format);
+//              Returns the BC format that a format is transcoded to by default: BC1, or BC3 if there is alpha, for ETC 
+//              and BC7 for ASTC. _DDSKTX_FORMAT_COUNT for other formats
+//
+//          bool ddsktx_transcode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, 
+//                                       ddsktx_format dst_format, void* dst, int dst_row_pitch, 
+//                                       int first_block_row, int num_block_rows);
+//              Transcodes block rows of a sub-image to BC1, BC3 or BC7 (dst_format) without an intermediate RGBA image
+//              Any format that ddsktx_decode_blocks decodes to RGBA8 can be the source. Block rows are rows of the BC
+//              format ((height+3)/4 of them), also for ASTC sources, whose blocks are decoded as the BC rows need them
+//              'dst' is the destination block row of first_block_row, pass row pitch of the BC format
+//              ((width+3)/4 * block size) to get the same layout that DDS files have
+//              BC7 is encoded with mode 6 only (one RGBA line per block), which is fast but below offline encoders
+//              Returns false if the source or destination formats are not supported
+//
+//          const char* ddsktx_error_str(ddsktx_result result);
+//              Converts an error code to message string (static string, no need to free)
+//
 //          const char* ddsktx_format_str(ddsktx_format format);
 //              Converts a format enumeration to string
 //
 //          bool ddsktx_format_compressed(ddsktx_format format);
 //              Returns true if format is compressed
 //
+//          int64_t ddsktx_calc_mip_size(ddsktx_format format, int width, int height, int mip_idx, int* row_bytes);
+//              Returns the size of one image (array layer, face or depth slice) of a mip, width/height are the
+//              dimensions of the first mip. Uses the block dimensions of the format (ASTC 5x5...10x5, PVRTC 8x4)
+//              and minimum block counts, the same math that the parsers use for file offsets
+//              row_bytes (can be NULL): returns the size of one row of blocks (or pixels, for uncompressed)
+//
+//      C++11 API (constexpr, works without DDSKTX_IMPLEMENT, so format traits fold into constants):
+//          ddsktx::bpp(format), ddsktx::block_width(format), ddsktx::block_height(format),
+//          ddsktx::block_size(format), ddsktx::min_blocks_x(format), ddsktx::min_blocks_y(format),
+//          ddsktx::has_alpha(format), ddsktx::is_compressed(format), ddsktx::name(format),
+//          ddsktx::mip_size(format, width, height, mip) (same as ddsktx_calc_mip_size)
+//          Example: static_assert(ddsktx::block_size(DDSKTX_FORMAT_BC7) == 16, "");
+//          C++17 wrapper (texture view, subresource iteration, format_traits and visit_format): see dds-ktx.hpp
+//
 //      Example (for 2D textures only): 
 //          int size;
 //          void* dds_data = load_file("test.dds", &size);
@@ -71,10 +319,6 @@
 //                  Added KTX support
 //      1.0.1       Fixed major bugs in KTX parsing
 //      1.1.0       Fixed bugs in get_sub routine, refactored some parts, image-viewer example
-//
-// TODO
-//      Write KTX/DDS
-//      Read KTX metadata. currently it just stores the offset/size to the metadata block
 //
 
  #pragma once
@@ -96,10 +340,79 @@ typedef struct ddsktx_sub_data
     const void* buff;
     int         width;
     int         height;
-    int         size_bytes;
+    int64_t     size_bytes;
     int         row_pitch_bytes;
 } ddsktx_sub_data;
 
+typedef struct ddsktx_sub_entry
+{
+    int64_t     offset;        // offset of sub-image data from the start of the file data
+    int64_t     size_bytes;
+    int         row_pitch_bytes;
+    int         width;
+    int         height;
+} ddsktx_sub_entry;
+
+// Alignment requirements of the GPU copy commands, for laying out a staging (upload) buffer
+typedef struct ddsktx_staging_policy
+{
+    int         row_pitch_align;    // D3D12: 256, Vulkan: optimalBufferCopyRowPitchAlignment (0 = tightly packed)
+    int         sub_offset_align;   // D3D12: 512, Vulkan: optimalBufferCopyOffsetAlignment (0 = no alignment)
+} ddsktx_staging_policy;
+
+// Placement of a sub-image in the staging buffer, rows are block-rows for compressed formats
+typedef struct ddsktx_staging_footprint
+{
+    int64_t     offset;             // offset from the start of the staging buffer
+    int64_t     size_bytes;         // row_pitch_bytes * num_rows
+    int         row_pitch_bytes;    // aligned row pitch
+    int         row_bytes;          // bytes of data in each row (row_pitch_bytes of ddsktx_sub_data)
+    int         num_rows;
+    int         width;
+    int         height;
+} ddsktx_staging_footprint;
+
+typedef struct ddsktx_file_range
+{
+    int64_t     offset;
+    int64_t     size;
+} ddsktx_file_range;
+
+// Pixel rectangle of a mip, see ddsktx_get_tile_spans
+typedef struct ddsktx_rect
+{
+    int         x;
+    int         y;
+    int         width;
+    int         height;
+} ddsktx_rect;
+
+// Tiled layouts of ddsktx_swizzle_sub, elements are blocks (pixels for uncompressed formats)
+typedef enum ddsktx_swizzle
+{
+    DDSKTX_SWIZZLE_MORTON = 0,          // Z-order of the whole image, padded to power of two width and height, 
+                                        // x in the lowest bit. The larger dimension continues linearly when the smaller
+                                        // one runs out of bits
+    DDSKTX_SWIZZLE_64KB_STANDARD,       // D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE 2D tiles (128x128 elements of 
+                                        // 4 bytes, BC1: 128x64 blocks, BC7: 64x64 blocks), tiles in row-major order
+    _DDSKTX_SWIZZLE_COUNT
+} ddsktx_swizzle;
+
+// KTX key/value pair, 'key' is null-terminated, 'value' is not: it can be binary or a string that 
+// includes the null character (value_size counts it). 'value' is not aligned, memcpy binary values
+typedef struct ddsktx_metadata
+{
+    const char* key;
+    const void* value;
+    int         value_size;
+} ddsktx_metadata;
+
+typedef struct ddsktx_metadata_iter
+{
+    const uint8_t* ptr;
+    const uint8_t* end;
+} ddsktx_metadata_iter;
+
 typedef enum ddsktx_format
 {
     DDSKTX_FORMAT_BC1,         // DXT1
@@ -158,12 +471,23 @@ typedef enum ddsktx_texture_flags
     DDSKTX_TEXTURE_FLAG_DDS     = 0x08,       // container was DDS file
     DDSKTX_TEXTURE_FLAG_KTX     = 0x10,       // container was KTX file
     DDSKTX_TEXTURE_FLAG_VOLUME  = 0x20,       // 3D volume
+    DDSKTX_TEXTURE_FLAG_KTX2    = 0x40,       // container was KTX2 file
+    DDSKTX_TEXTURE_FLAG_SIGNED  = 0x80,       // BC6H: signed float variant (SF16), otherwise unsigned (UF16)
+    DDSKTX_TEXTURE_FLAG_VALIDATED = 0x100,    // layout is checked against the file, see ddsktx_validate
 } ddsktx_texture_flags;
 
+typedef enum ddsktx_supercompression
+{
+    DDSKTX_SUPERCOMPRESSION_NONE = 0,
+    DDSKTX_SUPERCOMPRESSION_BASISLZ,
+    DDSKTX_SUPERCOMPRESSION_ZSTD,
+    DDSKTX_SUPERCOMPRESSION_ZLIB
+} ddsktx_supercompression;
+
 typedef struct ddsktx_texture_info
 {
-    int                 data_offset;   // start offset of pixel data
-    int                 size_bytes;
+    int64_t             data_offset;   // start offset of pixel data
+    int64_t             size_bytes;
     ddsktx_format       format;
     unsigned int        flags;         // ddsktx_texture_flags
     int                 width;
@@ -172,8 +496,9 @@ typedef struct ddsktx_texture_info
     int                 num_layers;
     int                 num_mips;
     int                 bpp;
-    int                 metadata_offset; // ktx only
-    int                 metadata_size;   // ktx only
+    int64_t             metadata_offset; // ktx/ktx2 only: key/value data block, see ddsktx_metadata_begin
+    int                 metadata_size;   // ktx/ktx2 only
+    ddsktx_supercompression supercompression;   // ktx2 only
 } ddsktx_texture_info;
 
 typedef enum ddsktx_cube_face
@@ -192,6 +517,75 @@ typedef struct ddsktx_error
     char msg[256];
 } ddsktx_error;
 
+typedef enum ddsktx_result
+{
+    DDSKTX_OK = 0,
+    DDSKTX_ERROR_TRUNCATED,             // file is smaller than the headers (or the pixel data, see ddsktx_validate)
+    DDSKTX_ERROR_UNKNOWN_CONTAINER,     // not a DDS/KTX/KTX2 file
+    DDSKTX_ERROR_INVALID_HEADER,
+    DDSKTX_ERROR_UNSUPPORTED_FORMAT,
+    DDSKTX_ERROR_UNSUPPORTED_FEATURE,   // big-endian, BasisLZ, unknown supercompression
+    DDSKTX_ERROR_INVALID_CUBEMAP,
+    DDSKTX_ERROR_INVALID_METADATA,
+    DDSKTX_ERROR_INVALID_LAYOUT,        // ktx2 level index (or ktx imageSize) does not match the texture
+    _DDSKTX_RESULT_COUNT
+} ddsktx_result;
+
+typedef struct ddsktx_blob
+{
+    const void* data;
+    size_t      size;
+} ddsktx_blob;
+
+// Decodes a supercompressed level of KTX2 file, dst_size is the exact size of the decoded level
+// Returns false if decoding fails
+typedef bool (ddsktx_decode_cb)(ddsktx_supercompression scheme, const void* src, int64_t src_size, 
+                                void* dst, int64_t dst_size, void* user);
+
+// Piece of output for the writers
+typedef struct ddsktx_write_buffer
+{
+    const void* data;
+    int64_t     size;
+} ddsktx_write_buffer;
+
+// Writes 'num_buffs' buffers to the output, in order. The buffers are only valid during the call
+// Returns false if writing fails, which stops the writer
+typedef bool (ddsktx_write_cb)(const ddsktx_write_buffer* buffs, int num_buffs, void* user);
+
+typedef enum ddsktx_convert_op
+{
+    DDSKTX_CONVERT_NONE = 0,
+    DDSKTX_CONVERT_RGB8_TO_RGBA8,           // alpha = 255
+    DDSKTX_CONVERT_BGRA8_TO_RGBA8,
+    DDSKTX_CONVERT_RGBA8_TO_BGRA8,
+    DDSKTX_CONVERT_RGB10A2_TO_RGBA16,       // unorm, bit replicated
+    DDSKTX_CONVERT_R16F_TO_R32F,
+    DDSKTX_CONVERT_RG16F_TO_RG32F,
+    DDSKTX_CONVERT_RGBA16F_TO_RGBA32F,
+    _DDSKTX_CONVERT_COUNT
+} ddsktx_convert_op;
+
+// User I/O callbacks for reading texture files from sources other than a memory blob
+// All the functions that take file_data/size are wrappers over this interface
+typedef struct ddsktx_reader
+{
+    // reads 'size' bytes at 'offset' of the file into 'buff', returns the number of bytes actually read
+    int64_t (*read)(void* user, int64_t offset, void* buff, int64_t size);
+    // returns total size of the file
+    int64_t (*size)(void* user);
+    void*   user;
+} ddsktx_reader;
+
+#ifdef DDSKTX_PROFILE_COUNTERS
+typedef struct ddsktx_profile_counters
+{
+    int64_t num_parsed;       // files parsed (ddsktx_parse*, successful or not)
+    int64_t subs_walked;      // sub-images stepped over by the lookups to reach the returned ones
+    int64_t subs_returned;    // sub-images returned by ddsktx_get_sub/ddsktx_read_sub
+} ddsktx_profile_counters;
+#endif
+
 #ifdef __cplusplus
 #   define ddsktx_default(_v) =_v
 #else
@@ -199,14 +593,261 @@ typedef struct ddsktx_error
 #endif
 
 DDSKTX_API bool ddsktx_parse(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API ddsktx_result ddsktx_parse_result(ddsktx_texture_info* tc, const void* file_data, size_t size);
+DDSKTX_API bool ddsktx_parse64(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API bool ddsktx_parse_strict(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API ddsktx_result ddsktx_validate(ddsktx_texture_info* tc, const void* file_data, size_t size);
+DDSKTX_API bool ddsktx_parse_reader(ddsktx_texture_info* tc, const ddsktx_reader* reader, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API bool ddsktx_parse_header(ddsktx_texture_info* tc, const void* header_data, int header_size, 
+                                    int64_t file_size, int64_t* required_size ddsktx_default(NULL), 
+                                    ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API int  ddsktx_parse_batch(const ddsktx_blob* blobs, int count, ddsktx_texture_info* infos, 
+                                   ddsktx_result* results);
 DDSKTX_API void ddsktx_get_sub(const ddsktx_texture_info* tex, ddsktx_sub_data* buff, 
                          const void* file_data, int size,
                          int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_API void ddsktx_get_sub64(const ddsktx_texture_info* tex, ddsktx_sub_data* buff, 
+                           const void* file_data, size_t size,
+                           int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_API bool ddsktx_read_sub(const ddsktx_texture_info* tc, const ddsktx_reader* reader,
+                                void* dst, int64_t dst_size, ddsktx_sub_data* buff,
+                                int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_API int  ddsktx_num_subresources(const ddsktx_texture_info* tc);
+DDSKTX_API bool ddsktx_build_subresource_table(const ddsktx_texture_info* tc, ddsktx_sub_entry* entries, int max_entries);
+DDSKTX_API int  ddsktx_sub_index(const ddsktx_texture_info* tc, int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_API void ddsktx_get_sub_indexed(const ddsktx_texture_info* tc, const ddsktx_sub_entry* table,
+                                       ddsktx_sub_data* buff, const void* file_data,
+                                       int array_idx, int slice_face_idx, int mip_idx);
+DDSKTX_API int64_t ddsktx_staging_layout(const ddsktx_texture_info* tc, const ddsktx_staging_policy* policy,
+                                         ddsktx_staging_footprint* footprints, int max_footprints);
+DDSKTX_API void ddsktx_copy_sub(const ddsktx_sub_data* sub, void* dst, int dst_row_pitch);
+DDSKTX_API int  ddsktx_get_tile_spans(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub,
+                                      int x, int y, int width, int height, ddsktx_rect* aligned,
+                                      ddsktx_file_range* spans, int max_spans);
+DDSKTX_API int64_t ddsktx_swizzled_size(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, 
+                                        ddsktx_swizzle swizzle);
+DDSKTX_API bool ddsktx_swizzle_sub(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_swizzle swizzle,
+                                   void* dst, int64_t dst_size);
+DDSKTX_API int  ddsktx_get_mip_ranges(const ddsktx_texture_info* tc, int first_mip, int num_mips,
+                                      ddsktx_file_range* ranges, int max_ranges);
+DDSKTX_API bool ddsktx_get_level_range(const ddsktx_texture_info* tc, const void* file_data, size_t size, int mip_idx,
+                                       ddsktx_file_range* range, int64_t* uncompressed_size ddsktx_default(NULL));
+DDSKTX_API bool ddsktx_decode_level(const ddsktx_texture_info* tc, int mip_idx, const void* src, int64_t src_size,
+                                    void* dst, int64_t dst_size, ddsktx_decode_cb* decode_cb, void* user);
+DDSKTX_API void ddsktx_metadata_begin(const ddsktx_texture_info* tc, const void* file_data, size_t size,
+                                      ddsktx_metadata_iter* iter);
+DDSKTX_API bool ddsktx_metadata_next(ddsktx_metadata_iter* iter, ddsktx_metadata* kv);
+DDSKTX_API bool ddsktx_metadata_find(const ddsktx_texture_info* tc, const void* file_data, size_t size,
+                                     const char* key, ddsktx_metadata* kv);
+DDSKTX_API bool ddsktx_write_dds(const ddsktx_texture_info* tc, const void* const* subs, 
+                                 ddsktx_write_cb* write_cb, void* user, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API bool ddsktx_write_ktx(const ddsktx_texture_info* tc, const void* const* subs, 
+                                 ddsktx_write_cb* write_cb, void* user, ddsktx_error* err ddsktx_default(NULL));
+DDSKTX_API ddsktx_convert_op ddsktx_gpu_convert_op(ddsktx_format format);
+DDSKTX_API int  ddsktx_convert_row_bytes(ddsktx_convert_op op, int width);
+DDSKTX_API void ddsktx_convert_row(ddsktx_convert_op op, const void* src, void* dst, int width);
+DDSKTX_API void ddsktx_convert_sub(ddsktx_convert_op op, const ddsktx_sub_data* sub, void* dst, int dst_row_pitch,
+                                   int first_row, int num_rows);
+DDSKTX_API ddsktx_format ddsktx_block_decode_format(ddsktx_format format);
+DDSKTX_API bool ddsktx_decode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, void* dst,
+                                     int dst_row_pitch, int first_block_row, int num_block_rows);
+DDSKTX_API ddsktx_format ddsktx_transcode_format(ddsktx_format format);
+DDSKTX_API bool ddsktx_transcode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub,
+                                        ddsktx_format dst_format, void* dst, int dst_row_pitch,
+                                        int first_block_row, int num_block_rows);
+DDSKTX_API const char* ddsktx_error_str(ddsktx_result result);
 DDSKTX_API const char* ddsktx_format_str(ddsktx_format format);
 DDSKTX_API bool        ddsktx_format_compressed(ddsktx_format format);
+DDSKTX_API int64_t     ddsktx_calc_mip_size(ddsktx_format format, int width, int height, int mip_idx, 
+                                            int* row_bytes ddsktx_default(NULL));
+#ifdef DDSKTX_PROFILE_COUNTERS
+DDSKTX_API ddsktx_profile_counters ddsktx_get_profile_counters(bool reset ddsktx_default(false));
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementation
+#if defined(__cplusplus) && (__cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+#   define DDSKTX__CONSTEXPR 1
+#   define DDSKTX__TRAITS_TABLE static constexpr
+#else
+#   define DDSKTX__TRAITS_TABLE static const
+#endif
+
+// Format traits tables are also visible in C++11 without DDSKTX_IMPLEMENT, for the constexpr API
+#if defined(DDSKTX_IMPLEMENT) || defined(DDSKTX__CONSTEXPR)
+typedef struct ddsktx__block_info
+{
+    uint8_t bpp;
+    uint8_t block_width;
+    uint8_t block_height;
+    uint8_t block_size;
+    uint8_t min_block_x;
+    uint8_t min_block_y;
+    uint8_t depth_bits;
+    uint8_t stencil_bits;
+    uint8_t r_bits;
+    uint8_t g_bits;
+    uint8_t b_bits;
+    uint8_t a_bits;
+    uint8_t encoding;    
+} ddsktx__block_info;
+
+typedef enum ddsktx__encode_type
+{
+    DDSKTX__ENCODE_UNORM,
+    DDSKTX__ENCODE_SNORM,
+    DDSKTX__ENCODE_FLOAT,
+    DDSKTX__ENCODE_INT,
+    DDSKTX__ENCODE_UINT,
+    DDSKTX__ENCODE_COUNT
+} ddsktx__encode_type;
+
+DDSKTX__TRAITS_TABLE ddsktx__block_info k__block_info[] =
+{
+    //  +-------------------------------------------- bits per pixel
+    //  |  +----------------------------------------- block width
+    //  |  |  +-------------------------------------- block height
+    //  |  |  |   +---------------------------------- block size
+    //  |  |  |   |  +------------------------------- min blocks x
+    //  |  |  |   |  |  +---------------------------- min blocks y
+    //  |  |  |   |  |  |   +------------------------ depth bits
+    //  |  |  |   |  |  |   |  +--------------------- stencil bits
+    //  |  |  |   |  |  |   |  |   +---+---+---+----- r, g, b, a bits
+    //  |  |  |   |  |  |   |  |   r   g   b   a  +-- encoding type
+    //  |  |  |   |  |  |   |  |   |   |   |   |  |
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC1
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC2
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC3
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC4
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC5
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // BC6H
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC7
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC1
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2A
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2A1
+    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC12
+    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC14
+    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC12A
+    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC14A
+    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC22
+    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC24
+    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATC
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATCE
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATCI
+    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC4x4
+    {   6, 5, 5, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC5x5
+    {   4, 6, 6, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC6x6
+    {   4, 8, 5, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC8x5
+    {   3, 8, 6, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC8x6
+    {   3, 10, 5, 16, 1, 1, 0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC10x5
+    {   0, 0, 0,  0, 0, 0,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_COUNT) }, // Unknown
+    {   8, 1, 1,  1, 1, 1,  0, 0,  0,  0,  0,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // A8
+    {   8, 1, 1,  1, 1, 1,  0, 0,  8,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // R8
+    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGBA8
+    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_SNORM) }, // RGBA8S
+    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG16
+    {  24, 1, 1,  3, 1, 1,  0, 0,  8,  8,  8,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGB8
+    {  16, 1, 1,  2, 1, 1,  0, 0, 16,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // R16
+    {  32, 1, 1,  4, 1, 1,  0, 0, 32,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // R32F
+    {  16, 1, 1,  2, 1, 1,  0, 0, 16,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // R16F
+    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // RG16F
+    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_SNORM) }, // RG16S
+    {  64, 1, 1,  8, 1, 1,  0, 0, 16, 16, 16, 16, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // RGBA16F
+    {  64, 1, 1,  8, 1, 1,  0, 0, 16, 16, 16, 16, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGBA16
+    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BGRA8
+    {  32, 1, 1,  4, 1, 1,  0, 0, 10, 10, 10,  2, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGB10A2
+    {  32, 1, 1,  4, 1, 1,  0, 0, 11, 11, 10,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG11B10F
+    {  16, 1, 1,  2, 1, 1,  0, 0,  8,  8,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG8
+    {  16, 1, 1,  2, 1, 1,  0, 0,  8,  8,  0,  0, (uint8_t)(DDSKTX__ENCODE_SNORM) }  // RG8S
+};
+
+typedef struct ddsktx__format_info
+{
+    const char* name;
+    bool        has_alpha;
+} ddsktx__format_info;
+
+DDSKTX__TRAITS_TABLE ddsktx__format_info k__formats_info[] = {
+    {"BC1", false},
+    {"BC2", true},
+    {"BC3", true},
+    {"BC4", false},
+    {"BC5", false},
+    {"BC6H", false},
+    {"BC7", true},
+    {"ETC1", false},
+    {"ETC2", false},
+    {"ETC2A", true},
+    {"ETC2A1", true},
+    {"PTC12", false},
+    {"PTC14", false},
+    {"PTC12A", true},
+    {"PTC14A", true},
+    {"PTC22", true},
+    {"PTC24", true},
+    {"ATC", false},
+    {"ATCE", false},
+    {"ATCI", false},
+    {"ASTC4x4", true},
+    {"ASTC5x5", true},
+    {"ASTC6x6", false},
+    {"ASTC8x5", true},
+    {"ASTC8x6", false},
+    {"ASTC10x5", false},
+    {"<unknown>", false},
+    {"A8", true},
+    {"R8", false},
+    {"RGBA8", true},
+    {"RGBA8S", true},
+    {"RG16", false},
+    {"RGB8", false},
+    {"R16", false},
+    {"R32F", false},
+    {"R16F", false},
+    {"RG16F", false},
+    {"RG16S", false},
+    {"RGBA16F", true},
+    {"RGBA16",true},
+    {"BGRA8", true},
+    {"RGB10A2", true},
+    {"RG11B10F", false},
+    {"RG8", false},
+    {"RG8S", false}
+};
+#endif
+
+#ifdef DDSKTX__CONSTEXPR
+namespace ddsktx {
+    static_assert(sizeof(k__block_info)/sizeof(k__block_info[0]) == _DDSKTX_FORMAT_COUNT, "k__block_info mismatch");
+    static_assert(sizeof(k__formats_info)/sizeof(k__formats_info[0]) == _DDSKTX_FORMAT_COUNT, "k__formats_info mismatch");
+
+    constexpr int  bpp(ddsktx_format format)            { return k__block_info[format].bpp; }
+    constexpr int  block_width(ddsktx_format format)    { return k__block_info[format].block_width; }
+    constexpr int  block_height(ddsktx_format format)   { return k__block_info[format].block_height; }
+    constexpr int  block_size(ddsktx_format format)     { return k__block_info[format].block_size; }
+    constexpr int  min_blocks_x(ddsktx_format format)   { return k__block_info[format].min_block_x; }
+    constexpr int  min_blocks_y(ddsktx_format format)   { return k__block_info[format].min_block_y; }
+    constexpr bool has_alpha(ddsktx_format format)      { return k__formats_info[format].has_alpha; }
+    constexpr bool is_compressed(ddsktx_format format)  { return format < _DDSKTX_FORMAT_COMPRESSED; }
+    constexpr const char* name(ddsktx_format format)    { return k__formats_info[format].name; }
+
+    namespace detail {
+        constexpr int mip_dim(int size, int mip)            { return (size >> mip) > 0 ? (size >> mip) : 1; }
+        constexpr int num_blocks(int size, int block_dim, int min_blocks) {
+            return (size + block_dim - 1)/block_dim > min_blocks ? (size + block_dim - 1)/block_dim : min_blocks;
+        }
+    }
+
+    constexpr int64_t mip_size(ddsktx_format format, int width, int height, int mip) {
+        return k__block_info[format].block_size == 0 ? 0 :
+            (int64_t)detail::num_blocks(detail::mip_dim(width, mip), block_width(format), min_blocks_x(format)) *
+            detail::num_blocks(detail::mip_dim(height, mip), block_height(format), min_blocks_y(format)) *
+            block_size(format);
+    }
+}
+#endif
+
 #ifdef DDSKTX_IMPLEMENT
 
 #define stc__makefourcc(_a, _b, _c, _d) ( ( (uint32_t)(_a) | ( (uint32_t)(_b) << 8) | \
@@ -290,6 +931,7 @@ DDSKTX_API bool        ddsktx_format_compressed(ddsktx_format format);
 #define DDSKTX__DDS_FORMAT_B5G5R5A1_UNORM      86
 #define DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM      87
 #define DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM_SRGB 91
+#define DDSKTX__DDS_FORMAT_BC6H_UF16           95
 #define DDSKTX__DDS_FORMAT_BC6H_SF16           96
 #define DDSKTX__DDS_FORMAT_BC7_UNORM           98
 #define DDSKTX__DDS_FORMAT_BC7_UNORM_SRGB      99
@@ -394,6 +1036,34 @@ typedef struct ddsktx__ktx_header
     uint32_t mip_count;
     uint32_t metadata_size;
 } ddsktx__ktx_header;
+
+// https://github.khronos.org/KTX-Specification/
+typedef struct ddsktx__ktx2_header
+{
+    uint8_t  id[8];
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+    uint32_t dfd_offset;
+    uint32_t dfd_size;
+    uint32_t kvd_offset;
+    uint32_t kvd_size;
+    uint64_t sgd_offset;
+    uint64_t sgd_size;
+} ddsktx__ktx2_header;
+
+typedef struct ddsktx__ktx2_level
+{
+    uint64_t offset;
+    uint64_t size;
+    uint64_t uncompressed_size;
+} ddsktx__ktx2_level;
 #pragma pack(pop)
 
 typedef struct ddsktx__dds_translate_fourcc_format
@@ -411,29 +1081,18 @@ typedef struct ddsktx__dds_translate_pixel_format
     ddsktx_format  format;
 } ddsktx__dds_translate_pixel_format;
 
-typedef struct ddsktx__mem_reader
+typedef struct ddsktx__reader
 {
-    const uint8_t* buff;
-    int            total;
-    int            offset;
-} ddsktx__mem_reader;
+    const ddsktx_reader* io;
+    int64_t              total;
+    int64_t              offset;
+} ddsktx__reader;
 
-typedef struct ddsktx__block_info
+typedef struct ddsktx__mem_blob
 {
-    uint8_t bpp;
-    uint8_t block_width;
-    uint8_t block_height;
-    uint8_t block_size;
-    uint8_t min_block_x;
-    uint8_t min_block_y;
-    uint8_t depth_bits;
-    uint8_t stencil_bits;
-    uint8_t r_bits;
-    uint8_t g_bits;
-    uint8_t b_bits;
-    uint8_t a_bits;
-    uint8_t encoding;    
-} ddsktx__block_info;
+    const uint8_t* buff;
+    int64_t        size;
+} ddsktx__mem_blob;
 
 #ifndef ddsktx_memcpy
 #   include <string.h>
@@ -464,82 +1123,117 @@ typedef struct ddsktx__block_info
 #   define ddsktx_memcmp(_ptr1, _ptr2, _num) memcmp((_ptr1), (_ptr2), (_num))
 #endif
 
+#ifndef DDSKTX_PROFILE_BEGIN
+#   define DDSKTX_PROFILE_BEGIN(_name)
+#endif
+
+#ifndef DDSKTX_PROFILE_END
+#   define DDSKTX_PROFILE_END(_name)
+#endif
+
+#ifdef DDSKTX_PROFILE_COUNTERS
+#   if defined(__cplusplus)
+#       define DDSKTX__THREAD_LOCAL thread_local
+#   elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#       define DDSKTX__THREAD_LOCAL _Thread_local
+#   elif defined(_MSC_VER)
+#       define DDSKTX__THREAD_LOCAL __declspec(thread)
+#   else
+#       define DDSKTX__THREAD_LOCAL __thread
+#   endif
+static DDSKTX__THREAD_LOCAL ddsktx_profile_counters ddsktx__counters;
+#   define ddsktx__count(_counter, _n)     (ddsktx__counters._counter += (_n))
+#else
+#   define ddsktx__count(_counter, _n)     ((void)0)
+#endif
+
 #define ddsktx__max(a, b)                  ((a) > (b) ? (a) : (b))
 #define ddsktx__min(a, b)                  ((a) < (b) ? (a) : (b))
+#define ddsktx__clamp(v, lo, hi)           ddsktx__max(lo, ddsktx__min(v, hi))
 #define ddsktx__align_mask(_value, _mask)  (((_value)+(_mask)) & ((~0)&(~(_mask))))
 #define ddsktx__err(_err, _msg)            if (_err)  ddsktx_strcpy(_err->msg, _msg);   return false
 
+// FourCC (or D3DFMT) of legacy DDS headers, shared by the parser and the writer (first match of a format is written)
+#define DDSKTX__DDS_FOURCC_FORMATS(_)                      \
+    _(DDSKTX__DDS_DXT1,                          BC1     ) \
+    _(DDSKTX__DDS_DXT2,                          BC2     ) \
+    _(DDSKTX__DDS_DXT3,                          BC2     ) \
+    _(DDSKTX__DDS_DXT4,                          BC3     ) \
+    _(DDSKTX__DDS_DXT5,                          BC3     ) \
+    _(DDSKTX__DDS_ATI1,                          BC4     ) \
+    _(DDSKTX__DDS_BC4U,                          BC4     ) \
+    _(DDSKTX__DDS_ATI2,                          BC5     ) \
+    _(DDSKTX__DDS_BC5U,                          BC5     ) \
+    _(DDSKTX__DDS_ETC1,                          ETC1    ) \
+    _(DDSKTX__DDS_ETC2,                          ETC2    ) \
+    _(DDSKTX__DDS_ET2A,                          ETC2A   ) \
+    _(DDSKTX__DDS_PTC2,                          PTC12A  ) \
+    _(DDSKTX__DDS_PTC4,                          PTC14A  ) \
+    _(DDSKTX__DDS_ATC,                           ATC     ) \
+    _(DDSKTX__DDS_ATCE,                          ATCE    ) \
+    _(DDSKTX__DDS_ATCI,                          ATCI    ) \
+    _(DDSKTX__DDS_ASTC4x4,                       ASTC4x4 ) \
+    _(DDSKTX__DDS_ASTC5x5,                       ASTC5x5 ) \
+    _(DDSKTX__DDS_ASTC6x6,                       ASTC6x6 ) \
+    _(DDSKTX__DDS_ASTC8x5,                       ASTC8x5 ) \
+    _(DDSKTX__DDS_ASTC8x6,                       ASTC8x6 ) \
+    _(DDSKTX__DDS_ASTC10x5,                      ASTC10x5) \
+    _(DDSKTX__DDS_A16B16G16R16,                  RGBA16  ) \
+    _(DDSKTX__DDS_A16B16G16R16F,                 RGBA16F ) \
+    _(DDSKTX__DDPF_RGB|DDSKTX__DDPF_ALPHAPIXELS, BGRA8   ) \
+    _(DDSKTX__DDPF_INDEXED,                      R8      ) \
+    _(DDSKTX__DDPF_LUMINANCE,                    R8      ) \
+    _(DDSKTX__DDPF_ALPHA,                        R8      ) \
+    _(DDSKTX__DDS_R16F,                          R16F    ) \
+    _(DDSKTX__DDS_R32F,                          R32F    ) \
+    _(DDSKTX__DDS_A8L8,                          RG8     ) \
+    _(DDSKTX__DDS_G16R16,                        RG16    ) \
+    _(DDSKTX__DDS_G16R16F,                       RG16F   ) \
+    _(DDSKTX__DDS_R8G8B8,                        RGB8    ) \
+    _(DDSKTX__DDS_A8R8G8B8,                      BGRA8   ) \
+    _(DDSKTX__DDS_A2B10G10R10,                   RGB10A2 )
+
+#define DDSKTX__DDS_FOURCC_ROW(_fourcc, _fmt)     { _fourcc, DDSKTX_FORMAT_##_fmt, false },
 static const ddsktx__dds_translate_fourcc_format k__translate_dds_fourcc[] = {
-    { DDSKTX__DDS_DXT1,                  DDSKTX_FORMAT_BC1,     false },
-    { DDSKTX__DDS_DXT2,                  DDSKTX_FORMAT_BC2,     false },
-    { DDSKTX__DDS_DXT3,                  DDSKTX_FORMAT_BC2,     false },
-    { DDSKTX__DDS_DXT4,                  DDSKTX_FORMAT_BC3,     false },
-    { DDSKTX__DDS_DXT5,                  DDSKTX_FORMAT_BC3,     false },
-    { DDSKTX__DDS_ATI1,                  DDSKTX_FORMAT_BC4,     false },
-    { DDSKTX__DDS_BC4U,                  DDSKTX_FORMAT_BC4,     false },
-    { DDSKTX__DDS_ATI2,                  DDSKTX_FORMAT_BC5,     false },
-    { DDSKTX__DDS_BC5U,                  DDSKTX_FORMAT_BC5,     false },
-    { DDSKTX__DDS_ETC1,                  DDSKTX_FORMAT_ETC1,     false },
-    { DDSKTX__DDS_ETC2,                  DDSKTX_FORMAT_ETC2,     false },
-    { DDSKTX__DDS_ET2A,                  DDSKTX_FORMAT_ETC2A,    false },
-    { DDSKTX__DDS_PTC2,                  DDSKTX_FORMAT_PTC12A,   false },
-    { DDSKTX__DDS_PTC4,                  DDSKTX_FORMAT_PTC14A,   false },
-    { DDSKTX__DDS_ATC ,                  DDSKTX_FORMAT_ATC,      false },
-    { DDSKTX__DDS_ATCE,                  DDSKTX_FORMAT_ATCE,     false },
-    { DDSKTX__DDS_ATCI,                  DDSKTX_FORMAT_ATCI,     false },
-    { DDSKTX__DDS_ASTC4x4,               DDSKTX_FORMAT_ASTC4x4,  false },
-    { DDSKTX__DDS_ASTC5x5,               DDSKTX_FORMAT_ASTC5x5,  false },
-    { DDSKTX__DDS_ASTC6x6,               DDSKTX_FORMAT_ASTC6x6,  false },
-    { DDSKTX__DDS_ASTC8x5,               DDSKTX_FORMAT_ASTC8x5,  false },
-    { DDSKTX__DDS_ASTC8x6,               DDSKTX_FORMAT_ASTC8x6,  false },
-    { DDSKTX__DDS_ASTC10x5,              DDSKTX_FORMAT_ASTC10x5, false },
-    { DDSKTX__DDS_A16B16G16R16,          DDSKTX_FORMAT_RGBA16,  false },
-    { DDSKTX__DDS_A16B16G16R16F,         DDSKTX_FORMAT_RGBA16F, false },
-    { DDSKTX__DDPF_RGB|DDSKTX__DDPF_ALPHAPIXELS, DDSKTX_FORMAT_BGRA8,   false },
-    { DDSKTX__DDPF_INDEXED,              DDSKTX_FORMAT_R8,      false },
-    { DDSKTX__DDPF_LUMINANCE,            DDSKTX_FORMAT_R8,      false },
-    { DDSKTX__DDPF_ALPHA,                DDSKTX_FORMAT_R8,      false },
-    { DDSKTX__DDS_R16F,                  DDSKTX_FORMAT_R16F,    false },
-    { DDSKTX__DDS_R32F,                  DDSKTX_FORMAT_R32F,    false },
-    { DDSKTX__DDS_A8L8,                  DDSKTX_FORMAT_RG8,     false },
-    { DDSKTX__DDS_G16R16,                DDSKTX_FORMAT_RG16,    false },
-    { DDSKTX__DDS_G16R16F,               DDSKTX_FORMAT_RG16F,   false },
-    { DDSKTX__DDS_R8G8B8,                DDSKTX_FORMAT_RGB8,    false },
-    { DDSKTX__DDS_A8R8G8B8,              DDSKTX_FORMAT_BGRA8,   false },
-    { DDSKTX__DDS_A16B16G16R16,          DDSKTX_FORMAT_RGBA16,  false },
-    { DDSKTX__DDS_A16B16G16R16F,         DDSKTX_FORMAT_RGBA16F, false },
-    { DDSKTX__DDS_A2B10G10R10,           DDSKTX_FORMAT_RGB10A2, false },
+    DDSKTX__DDS_FOURCC_FORMATS(DDSKTX__DDS_FOURCC_ROW)
 };
+#undef DDSKTX__DDS_FOURCC_ROW
 
+// DXGI_FORMAT of DX10 DDS headers
+#define DDSKTX__DXGI_FORMATS(_)                                \
+    _(DDSKTX__DDS_FORMAT_BC1_UNORM,           BC1,      false) \
+    _(DDSKTX__DDS_FORMAT_BC1_UNORM_SRGB,      BC1,      true ) \
+    _(DDSKTX__DDS_FORMAT_BC2_UNORM,           BC2,      false) \
+    _(DDSKTX__DDS_FORMAT_BC2_UNORM_SRGB,      BC2,      true ) \
+    _(DDSKTX__DDS_FORMAT_BC3_UNORM,           BC3,      false) \
+    _(DDSKTX__DDS_FORMAT_BC3_UNORM_SRGB,      BC3,      true ) \
+    _(DDSKTX__DDS_FORMAT_BC4_UNORM,           BC4,      false) \
+    _(DDSKTX__DDS_FORMAT_BC5_UNORM,           BC5,      false) \
+    _(DDSKTX__DDS_FORMAT_BC6H_SF16,           BC6H,     false) \
+    _(DDSKTX__DDS_FORMAT_BC6H_UF16,           BC6H,     false) \
+    _(DDSKTX__DDS_FORMAT_BC7_UNORM,           BC7,      false) \
+    _(DDSKTX__DDS_FORMAT_BC7_UNORM_SRGB,      BC7,      true ) \
+    _(DDSKTX__DDS_FORMAT_R8_UNORM,            R8,       false) \
+    _(DDSKTX__DDS_FORMAT_R16_UNORM,           R16,      false) \
+    _(DDSKTX__DDS_FORMAT_R16_FLOAT,           R16F,     false) \
+    _(DDSKTX__DDS_FORMAT_R32_FLOAT,           R32F,     false) \
+    _(DDSKTX__DDS_FORMAT_R8G8_UNORM,          RG8,      false) \
+    _(DDSKTX__DDS_FORMAT_R16G16_UNORM,        RG16,     false) \
+    _(DDSKTX__DDS_FORMAT_R16G16_FLOAT,        RG16F,    false) \
+    _(DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM,      BGRA8,    false) \
+    _(DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM_SRGB, BGRA8,    true ) \
+    _(DDSKTX__DDS_FORMAT_R8G8B8A8_UNORM,      RGBA8,    false) \
+    _(DDSKTX__DDS_FORMAT_R8G8B8A8_UNORM_SRGB, RGBA8,    true ) \
+    _(DDSKTX__DDS_FORMAT_R16G16B16A16_UNORM,  RGBA16,   false) \
+    _(DDSKTX__DDS_FORMAT_R16G16B16A16_FLOAT,  RGBA16F,  false) \
+    _(DDSKTX__DDS_FORMAT_R10G10B10A2_UNORM,   RGB10A2,  false) \
+    _(DDSKTX__DDS_FORMAT_R11G11B10_FLOAT,     RG11B10F, false)
+
+#define DDSKTX__DXGI_ROW(_dxgi, _fmt, _srgb)      { _dxgi, DDSKTX_FORMAT_##_fmt, _srgb },
 static const ddsktx__dds_translate_fourcc_format k__translate_dxgi[] = {
-    { DDSKTX__DDS_FORMAT_BC1_UNORM,           DDSKTX_FORMAT_BC1,        false },
-    { DDSKTX__DDS_FORMAT_BC1_UNORM_SRGB,      DDSKTX_FORMAT_BC1,        true  },
-    { DDSKTX__DDS_FORMAT_BC2_UNORM,           DDSKTX_FORMAT_BC2,        false },
-    { DDSKTX__DDS_FORMAT_BC2_UNORM_SRGB,      DDSKTX_FORMAT_BC2,        true  },
-    { DDSKTX__DDS_FORMAT_BC3_UNORM,           DDSKTX_FORMAT_BC3,        false },
-    { DDSKTX__DDS_FORMAT_BC3_UNORM_SRGB,      DDSKTX_FORMAT_BC3,        true  },
-    { DDSKTX__DDS_FORMAT_BC4_UNORM,           DDSKTX_FORMAT_BC4,        false },
-    { DDSKTX__DDS_FORMAT_BC5_UNORM,           DDSKTX_FORMAT_BC5,        false },
-    { DDSKTX__DDS_FORMAT_BC6H_SF16,           DDSKTX_FORMAT_BC6H,       false },
-    { DDSKTX__DDS_FORMAT_BC7_UNORM,           DDSKTX_FORMAT_BC7,        false },
-    { DDSKTX__DDS_FORMAT_BC7_UNORM_SRGB,      DDSKTX_FORMAT_BC7,        true  },
-
-    { DDSKTX__DDS_FORMAT_R8_UNORM,            DDSKTX_FORMAT_R8,         false },
-    { DDSKTX__DDS_FORMAT_R16_UNORM,           DDSKTX_FORMAT_R16,        false },
-    { DDSKTX__DDS_FORMAT_R16_FLOAT,           DDSKTX_FORMAT_R16F,       false },
-    { DDSKTX__DDS_FORMAT_R32_FLOAT,           DDSKTX_FORMAT_R32F,       false },
-    { DDSKTX__DDS_FORMAT_R8G8_UNORM,          DDSKTX_FORMAT_RG8,        false },
-    { DDSKTX__DDS_FORMAT_R16G16_UNORM,        DDSKTX_FORMAT_RG16,       false },
-    { DDSKTX__DDS_FORMAT_R16G16_FLOAT,        DDSKTX_FORMAT_RG16F,      false },
-    { DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM,      DDSKTX_FORMAT_BGRA8,      false },
-    { DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM_SRGB, DDSKTX_FORMAT_BGRA8,      true  },
-    { DDSKTX__DDS_FORMAT_R8G8B8A8_UNORM,      DDSKTX_FORMAT_RGBA8,      false },
-    { DDSKTX__DDS_FORMAT_R8G8B8A8_UNORM_SRGB, DDSKTX_FORMAT_RGBA8,      true  },
-    { DDSKTX__DDS_FORMAT_R16G16B16A16_UNORM,  DDSKTX_FORMAT_RGBA16,     false },
-    { DDSKTX__DDS_FORMAT_R16G16B16A16_FLOAT,  DDSKTX_FORMAT_RGBA16F,    false },
-    { DDSKTX__DDS_FORMAT_R10G10B10A2_UNORM,   DDSKTX_FORMAT_RGB10A2,    false },
-    { DDSKTX__DDS_FORMAT_R11G11B10_FLOAT,     DDSKTX_FORMAT_RG11B10F,   false },
+    DDSKTX__DXGI_FORMATS(DDSKTX__DXGI_ROW)
 };
+#undef DDSKTX__DXGI_ROW
 
 static const ddsktx__dds_translate_pixel_format k__translate_dds_pixel[] = {
     {  8, DDSKTX__DDPF_LUMINANCE,            { 0x000000ff, 0x00000000, 0x00000000, 0x00000000 }, DDSKTX_FORMAT_R8      },
@@ -557,75 +1251,27 @@ static const ddsktx__dds_translate_pixel_format k__translate_dds_pixel[] = {
     { 32, DDSKTX__DDPF_BUMPDUDV,             { 0x0000ffff, 0xffff0000, 0x00000000, 0x00000000 }, DDSKTX_FORMAT_RG16S   }
 };
 
-typedef enum ddsktx__encode_type
+// Parser lookups are switches over the codes, compilers emit jump tables for the dense ranges (DXGI for example)
+// and binary searches for the sparse ones (FourCC), instead of a linear scan over the tables
+static ddsktx_format ddsktx__dds_fourcc_format(uint32_t fourcc)
 {
-    DDSKTX__ENCODE_UNORM,
-    DDSKTX__ENCODE_SNORM,
-    DDSKTX__ENCODE_FLOAT,
-    DDSKTX__ENCODE_INT,
-    DDSKTX__ENCODE_UINT,
-    DDSKTX__ENCODE_COUNT
-} ddsktx__encode_type;
+#define DDSKTX__CASE(_fourcc, _fmt)     case _fourcc: return DDSKTX_FORMAT_##_fmt;
+    switch (fourcc) {
+    DDSKTX__DDS_FOURCC_FORMATS(DDSKTX__CASE)
+    default: return _DDSKTX_FORMAT_COUNT;
+    }
+#undef DDSKTX__CASE
+}
 
-static const ddsktx__block_info k__block_info[] =
+static ddsktx_format ddsktx__dxgi_format(uint32_t dxgi, bool* srgb)
 {
-    //  +-------------------------------------------- bits per pixel
-    //  |  +----------------------------------------- block width
-    //  |  |  +-------------------------------------- block height
-    //  |  |  |   +---------------------------------- block size
-    //  |  |  |   |  +------------------------------- min blocks x
-    //  |  |  |   |  |  +---------------------------- min blocks y
-    //  |  |  |   |  |  |   +------------------------ depth bits
-    //  |  |  |   |  |  |   |  +--------------------- stencil bits
-    //  |  |  |   |  |  |   |  |   +---+---+---+----- r, g, b, a bits
-    //  |  |  |   |  |  |   |  |   r   g   b   a  +-- encoding type
-    //  |  |  |   |  |  |   |  |   |   |   |   |  |
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC1
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC2
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC3
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC4
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC5
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // BC6H
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BC7
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC1
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2A
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ETC2A1
-    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC12
-    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC14
-    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC12A
-    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC14A
-    {   2, 8, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC22
-    {   4, 4, 4,  8, 2, 2,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // PTC24
-    {   4, 4, 4,  8, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATC
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATCE
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ATCI
-    {   8, 4, 4, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC4x4
-    {   6, 5, 5, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC5x5
-    {   4, 6, 6, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC6x6
-    {   4, 8, 5, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC8x5
-    {   3, 8, 6, 16, 1, 1,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC8x6
-    {   3, 10, 5, 16, 1, 1, 0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // ASTC10x5
-    {   0, 0, 0,  0, 0, 0,  0, 0,  0,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_COUNT) }, // Unknown
-    {   8, 1, 1,  1, 1, 1,  0, 0,  0,  0,  0,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // A8
-    {   8, 1, 1,  1, 1, 1,  0, 0,  8,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // R8
-    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGBA8
-    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_SNORM) }, // RGBA8S
-    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG16
-    {  24, 1, 1,  3, 1, 1,  0, 0,  8,  8,  8,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGB8
-    {  16, 1, 1,  2, 1, 1,  0, 0, 16,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // R16
-    {  32, 1, 1,  4, 1, 1,  0, 0, 32,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // R32F
-    {  16, 1, 1,  2, 1, 1,  0, 0, 16,  0,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // R16F
-    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // RG16F
-    {  32, 1, 1,  4, 1, 1,  0, 0, 16, 16,  0,  0, (uint8_t)(DDSKTX__ENCODE_SNORM) }, // RG16S
-    {  64, 1, 1,  8, 1, 1,  0, 0, 16, 16, 16, 16, (uint8_t)(DDSKTX__ENCODE_FLOAT) }, // RGBA16F
-    {  64, 1, 1,  8, 1, 1,  0, 0, 16, 16, 16, 16, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGBA16
-    {  32, 1, 1,  4, 1, 1,  0, 0,  8,  8,  8,  8, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // BGRA8
-    {  32, 1, 1,  4, 1, 1,  0, 0, 10, 10, 10,  2, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RGB10A2
-    {  32, 1, 1,  4, 1, 1,  0, 0, 11, 11, 10,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG11B10F
-    {  16, 1, 1,  2, 1, 1,  0, 0,  8,  8,  0,  0, (uint8_t)(DDSKTX__ENCODE_UNORM) }, // RG8
-    {  16, 1, 1,  2, 1, 1,  0, 0,  8,  8,  0,  0, (uint8_t)(DDSKTX__ENCODE_SNORM) }  // RG8S
-};
+#define DDSKTX__CASE(_dxgi, _fmt, _srgb)    case _dxgi: *srgb = _srgb; return DDSKTX_FORMAT_##_fmt;
+    switch (dxgi) {
+    DDSKTX__DXGI_FORMATS(DDSKTX__CASE)
+    default: return _DDSKTX_FORMAT_COUNT;
+    }
+#undef DDSKTX__CASE
+}
 
 // KTX: https://www.khronos.org/opengles/sdk/tools/KTX/file_format_spec/
 #define DDSKTX__KTX_MAGIC       stc__makefourcc(0xAB, 'K', 'T', 'X')
@@ -765,495 +1411,4403 @@ static const ddsktx__block_info k__block_info[] =
 typedef struct ddsktx__ktx_format_info
 {
     uint32_t internal_fmt;
-    uint32_t internal_fmt_srgb;
     uint32_t fmt;
     uint32_t type;    
 } ddsktx__ktx_format_info;
 
-typedef struct ddsktx__ktx_format_info2
-{
-    uint32_t       internal_fmt;
-    ddsktx_format  format;    
-} ddsktx__ktx_format_info2;
+// KTX (GL) formats in ddsktx_format order, compressed formats use the internal format as glFormat and have no glType
+#define DDSKTX__KTX_COMPRESSED_FORMATS(_)                             \
+    _(BC1,      DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT1_EXT           ) \
+    _(BC2,      DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT3_EXT           ) \
+    _(BC3,      DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT5_EXT           ) \
+    _(BC4,      DDSKTX__KTX_COMPRESSED_LUMINANCE_LATC1_EXT          ) \
+    _(BC5,      DDSKTX__KTX_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT    ) \
+    _(BC6H,     DDSKTX__KTX_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB    ) \
+    _(BC7,      DDSKTX__KTX_COMPRESSED_RGBA_BPTC_UNORM_ARB          ) \
+    _(ETC1,     DDSKTX__KTX_ETC1_RGB8_OES                           ) \
+    _(ETC2,     DDSKTX__KTX_COMPRESSED_RGB8_ETC2                    ) \
+    _(ETC2A,    DDSKTX__KTX_COMPRESSED_RGBA8_ETC2_EAC               ) \
+    _(ETC2A1,   DDSKTX__KTX_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2) \
+    _(PTC12,    DDSKTX__KTX_COMPRESSED_RGB_PVRTC_2BPPV1_IMG         ) \
+    _(PTC14,    DDSKTX__KTX_COMPRESSED_RGB_PVRTC_4BPPV1_IMG         ) \
+    _(PTC12A,   DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG        ) \
+    _(PTC14A,   DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG        ) \
+    _(PTC22,    DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG        ) \
+    _(PTC24,    DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG        ) \
+    _(ATC,      DDSKTX__KTX_ATC_RGB_AMD                             ) \
+    _(ATCE,     DDSKTX__KTX_ATC_RGBA_EXPLICIT_ALPHA_AMD             ) \
+    _(ATCI,     DDSKTX__KTX_ATC_RGBA_INTERPOLATED_ALPHA_AMD         ) \
+    _(ASTC4x4,  DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_4x4_KHR         ) \
+    _(ASTC5x5,  DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_5x5_KHR         ) \
+    _(ASTC6x6,  DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_6x6_KHR         ) \
+    _(ASTC8x5,  DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x5_KHR         ) \
+    _(ASTC8x6,  DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x6_KHR         ) \
+    _(ASTC10x5, DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_10x5_KHR        )
+
+#define DDSKTX__KTX_UNCOMPRESSED_FORMATS(_)                                                              \
+    _(A8,       DDSKTX__KTX_ALPHA,          DDSKTX__KTX_ALPHA, DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(R8,       DDSKTX__KTX_R8,             DDSKTX__KTX_RED,   DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(RGBA8,    DDSKTX__KTX_RGBA8,          DDSKTX__KTX_RGBA,  DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(RGBA8S,   DDSKTX__KTX_RGBA8_SNORM,    DDSKTX__KTX_RGBA,  DDSKTX__KTX_BYTE                        ) \
+    _(RG16,     DDSKTX__KTX_RG16,           DDSKTX__KTX_RG,    DDSKTX__KTX_UNSIGNED_SHORT              ) \
+    _(RGB8,     DDSKTX__KTX_RGB8,           DDSKTX__KTX_RGB,   DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(R16,      DDSKTX__KTX_R16,            DDSKTX__KTX_RED,   DDSKTX__KTX_UNSIGNED_SHORT              ) \
+    _(R32F,     DDSKTX__KTX_R32F,           DDSKTX__KTX_RED,   DDSKTX__KTX_FLOAT                       ) \
+    _(R16F,     DDSKTX__KTX_R16F,           DDSKTX__KTX_RED,   DDSKTX__KTX_HALF_FLOAT                  ) \
+    _(RG16F,    DDSKTX__KTX_RG16F,          DDSKTX__KTX_RG,    DDSKTX__KTX_HALF_FLOAT                  ) \
+    _(RG16S,    DDSKTX__KTX_RG16_SNORM,     DDSKTX__KTX_RG,    DDSKTX__KTX_SHORT                       ) \
+    _(RGBA16F,  DDSKTX__KTX_RGBA16F,        DDSKTX__KTX_RGBA,  DDSKTX__KTX_HALF_FLOAT                  ) \
+    _(RGBA16,   DDSKTX__KTX_RGBA16,         DDSKTX__KTX_RGBA,  DDSKTX__KTX_UNSIGNED_SHORT              ) \
+    _(BGRA8,    DDSKTX__KTX_BGRA,           DDSKTX__KTX_BGRA,  DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(RGB10A2,  DDSKTX__KTX_RGB10_A2,       DDSKTX__KTX_RGBA,  DDSKTX__KTX_UNSIGNED_INT_2_10_10_10_REV ) \
+    _(RG11B10F, DDSKTX__KTX_R11F_G11F_B10F, DDSKTX__KTX_RGB,   DDSKTX__KTX_UNSIGNED_INT_10F_11F_11F_REV) \
+    _(RG8,      DDSKTX__KTX_RG8,            DDSKTX__KTX_RG,    DDSKTX__KTX_UNSIGNED_BYTE               ) \
+    _(RG8S,     DDSKTX__KTX_RG8_SNORM,      DDSKTX__KTX_RG,    DDSKTX__KTX_BYTE                        )
+
+// sRGB internal formats, BGRA8 shares SRGB8_ALPHA8 with RGBA8, the parser tells them apart by glFormat
+#define DDSKTX__KTX_SRGB_FORMATS(_)                                    \
+    _(BC1,      DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT      ) \
+    _(BC2,      DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT      ) \
+    _(BC3,      DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT      ) \
+    _(BC7,      DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB     ) \
+    _(ETC2,     DDSKTX__KTX_COMPRESSED_SRGB8_ETC2                    ) \
+    _(ETC2A,    DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC         ) \
+    _(ETC2A1,   DDSKTX__KTX_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2) \
+    _(PTC12,    DDSKTX__KTX_COMPRESSED_SRGB_PVRTC_2BPPV1_EXT         ) \
+    _(PTC14,    DDSKTX__KTX_COMPRESSED_SRGB_PVRTC_4BPPV1_EXT         ) \
+    _(PTC12A,   DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT   ) \
+    _(PTC14A,   DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT   ) \
+    _(ASTC4x4,  DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_4x4_KHR  ) \
+    _(ASTC5x5,  DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_5x5_KHR  ) \
+    _(ASTC6x6,  DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_6x6_KHR  ) \
+    _(ASTC8x5,  DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_8x5_KHR  ) \
+    _(ASTC8x6,  DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_8x6_KHR  ) \
+    _(ASTC10x5, DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_10x5_KHR ) \
+    _(RGBA8,    DDSKTX__KTX_SRGB8_ALPHA8                             ) \
+    _(RGB8,     DDSKTX__KTX_SRGB8                                    )
+
+// unsized (or RGB only) internal formats that are only recognized by the parser
+#define DDSKTX__KTX_ALIAS_FORMATS(_)                             \
+    _(A8,    DDSKTX__KTX_A8                                    ) \
+    _(R8,    DDSKTX__KTX_RED                                   ) \
+    _(RGB8,  DDSKTX__KTX_RGB                                   ) \
+    _(RGBA8, DDSKTX__KTX_RGBA                                  ) \
+    _(BC1,   DDSKTX__KTX_COMPRESSED_RGB_S3TC_DXT1_EXT          ) \
+    _(BC6H,  DDSKTX__KTX_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB)
 
+#define DDSKTX__KTX_COMPRESSED_ROW(_fmt, _internal)                     { _internal, _internal, DDSKTX__KTX_ZERO },
+#define DDSKTX__KTX_UNCOMPRESSED_ROW(_fmt, _internal, _gl_fmt, _type)   { _internal, _gl_fmt, _type },
 static const ddsktx__ktx_format_info k__translate_ktx_fmt[] = {
-        { DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT1_EXT,            DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,        DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT1_EXT,            DDSKTX__KTX_ZERO,                         }, // BC1
-        { DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT3_EXT,            DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,        DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT3_EXT,            DDSKTX__KTX_ZERO,                         }, // BC2
-        { DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT5_EXT,            DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,        DDSKTX__KTX_COMPRESSED_RGBA_S3TC_DXT5_EXT,            DDSKTX__KTX_ZERO,                         }, // BC3
-        { DDSKTX__KTX_COMPRESSED_LUMINANCE_LATC1_EXT,           DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_LUMINANCE_LATC1_EXT,           DDSKTX__KTX_ZERO,                         }, // BC4
-        { DDSKTX__KTX_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT,     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT,     DDSKTX__KTX_ZERO,                         }, // BC5
-        { DDSKTX__KTX_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB,     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB,     DDSKTX__KTX_ZERO,                         }, // BC6H
-        { DDSKTX__KTX_COMPRESSED_RGBA_BPTC_UNORM_ARB,           DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_RGBA_BPTC_UNORM_ARB,           DDSKTX__KTX_ZERO,                         }, // BC7
-        { DDSKTX__KTX_ETC1_RGB8_OES,                            DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ETC1_RGB8_OES,                            DDSKTX__KTX_ZERO,                         }, // ETC1
-        { DDSKTX__KTX_COMPRESSED_RGB8_ETC2,                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_RGB8_ETC2,                     DDSKTX__KTX_ZERO,                         }, // ETC2
-        { DDSKTX__KTX_COMPRESSED_RGBA8_ETC2_EAC,                DDSKTX__KTX_COMPRESSED_SRGB8_ETC2,                      DDSKTX__KTX_COMPRESSED_RGBA8_ETC2_EAC,                DDSKTX__KTX_ZERO,                         }, // ETC2A
-        { DDSKTX__KTX_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, DDSKTX__KTX_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2,  DDSKTX__KTX_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, DDSKTX__KTX_ZERO,                         }, // ETC2A1
-        { DDSKTX__KTX_COMPRESSED_RGB_PVRTC_2BPPV1_IMG,          DDSKTX__KTX_COMPRESSED_SRGB_PVRTC_2BPPV1_EXT,           DDSKTX__KTX_COMPRESSED_RGB_PVRTC_2BPPV1_IMG,          DDSKTX__KTX_ZERO,                         }, // PTC12
-        { DDSKTX__KTX_COMPRESSED_RGB_PVRTC_4BPPV1_IMG,          DDSKTX__KTX_COMPRESSED_SRGB_PVRTC_4BPPV1_EXT,           DDSKTX__KTX_COMPRESSED_RGB_PVRTC_4BPPV1_IMG,          DDSKTX__KTX_ZERO,                         }, // PTC14
-        { DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG,         DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT,     DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG,         DDSKTX__KTX_ZERO,                         }, // PTC12A
-        { DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG,         DDSKTX__KTX_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT,     DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG,         DDSKTX__KTX_ZERO,                         }, // PTC14A
-        { DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG,         DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG,         DDSKTX__KTX_ZERO,                         }, // PTC22
-        { DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG,         DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG,         DDSKTX__KTX_ZERO,                         }, // PTC24
-        { DDSKTX__KTX_ATC_RGB_AMD,                              DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ATC_RGB_AMD,                              DDSKTX__KTX_ZERO,                         }, // ATC
-        { DDSKTX__KTX_ATC_RGBA_EXPLICIT_ALPHA_AMD,              DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ATC_RGBA_EXPLICIT_ALPHA_AMD,              DDSKTX__KTX_ZERO,                         }, // ATCE
-        { DDSKTX__KTX_ATC_RGBA_INTERPOLATED_ALPHA_AMD,          DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ATC_RGBA_INTERPOLATED_ALPHA_AMD,          DDSKTX__KTX_ZERO,                         }, // ATCI
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_4x4_KHR,          DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_4x4_KHR,    DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_4x4_KHR,          DDSKTX__KTX_ZERO,                         }, // ASTC4x4
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_5x5_KHR,          DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_5x5_KHR,    DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_5x5_KHR,          DDSKTX__KTX_ZERO,                         }, // ASTC5x5
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_6x6_KHR,          DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_6x6_KHR,    DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_6x6_KHR,          DDSKTX__KTX_ZERO,                         }, // ASTC6x6
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x5_KHR,          DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_8x5_KHR,    DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x5_KHR,          DDSKTX__KTX_ZERO,                         }, // ASTC8x5
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x6_KHR,          DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_8x6_KHR,    DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_8x6_KHR,          DDSKTX__KTX_ZERO,                         }, // ASTC8x6
-        { DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_10x5_KHR,         DDSKTX__KTX_COMPRESSED_SRGB8_ALPHA8_ADDSKTX_10x5_KHR,   DDSKTX__KTX_COMPRESSED_RGBA_ADDSKTX_10x5_KHR,         DDSKTX__KTX_ZERO,                         }, // ASTC10x5
-        { DDSKTX__KTX_ZERO,                                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ZERO,                                     DDSKTX__KTX_ZERO,                         }, // Unknown
-        { DDSKTX__KTX_ALPHA,                                    DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_ALPHA,                                    DDSKTX__KTX_UNSIGNED_BYTE,                }, // A8
-        { DDSKTX__KTX_R8,                                       DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_UNSIGNED_BYTE,                }, // R8
-        { DDSKTX__KTX_RGBA8,                                    DDSKTX__KTX_SRGB8_ALPHA8,                               DDSKTX__KTX_RGBA,                                     DDSKTX__KTX_UNSIGNED_BYTE,                }, // RGBA8
-        { DDSKTX__KTX_RGBA8_SNORM,                              DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RGBA,                                     DDSKTX__KTX_BYTE,                         }, // RGBA8S
-        { DDSKTX__KTX_RG16,                                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RG,                                       DDSKTX__KTX_UNSIGNED_SHORT,               }, // RG16
-        { DDSKTX__KTX_RGB8,                                     DDSKTX__KTX_SRGB8,                                      DDSKTX__KTX_RGB,                                      DDSKTX__KTX_UNSIGNED_BYTE,                }, // RGB8
-        { DDSKTX__KTX_R16,                                      DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_UNSIGNED_SHORT,               }, // R16
-        { DDSKTX__KTX_R32F,                                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_FLOAT,                        }, // R32F
-        { DDSKTX__KTX_R16F,                                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_HALF_FLOAT,                   }, // R16F
-        { DDSKTX__KTX_RG16F,                                    DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RG,                                       DDSKTX__KTX_FLOAT,                        }, // RG16F
-        { DDSKTX__KTX_RG16_SNORM,                               DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RG,                                       DDSKTX__KTX_SHORT,                        }, // RG16S
-        { DDSKTX__KTX_RGBA16F,                                  DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RGBA,                                     DDSKTX__KTX_HALF_FLOAT,                   }, // RGBA16F
-        { DDSKTX__KTX_RGBA16,                                   DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RGBA,                                     DDSKTX__KTX_UNSIGNED_SHORT,               }, // RGBA16
-        { DDSKTX__KTX_BGRA,                                     DDSKTX__KTX_SRGB8_ALPHA8,                               DDSKTX__KTX_BGRA,                                     DDSKTX__KTX_UNSIGNED_BYTE,                }, // BGRA8
-        { DDSKTX__KTX_RGB10_A2,                                 DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RGBA,                                     DDSKTX__KTX_UNSIGNED_INT_2_10_10_10_REV,  }, // RGB10A2
-        { DDSKTX__KTX_R11F_G11F_B10F,                           DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RGB,                                      DDSKTX__KTX_UNSIGNED_INT_10F_11F_11F_REV, }, // RG11B10F
-        { DDSKTX__KTX_RG8,                                      DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RG,                                       DDSKTX__KTX_UNSIGNED_BYTE,                }, // RG8
-        { DDSKTX__KTX_RG8_SNORM,                                DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RG,                                       DDSKTX__KTX_BYTE,                         }, // RG8S
-        { DDSKTX__KTX_R16I,                                     DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_UNSIGNED_SHORT,               }, // R16I
-        { DDSKTX__KTX_R16UI,                                    DDSKTX__KTX_ZERO,                                       DDSKTX__KTX_RED,                                      DDSKTX__KTX_UNSIGNED_SHORT,               }, // R16UI
+    DDSKTX__KTX_COMPRESSED_FORMATS(DDSKTX__KTX_COMPRESSED_ROW)
+    { DDSKTX__KTX_ZERO, DDSKTX__KTX_ZERO, DDSKTX__KTX_ZERO },     // _DDSKTX_FORMAT_COMPRESSED
+    DDSKTX__KTX_UNCOMPRESSED_FORMATS(DDSKTX__KTX_UNCOMPRESSED_ROW)
 };
+#undef DDSKTX__KTX_COMPRESSED_ROW
+#undef DDSKTX__KTX_UNCOMPRESSED_ROW
 
-static const ddsktx__ktx_format_info2 k__translate_ktx_fmt2[] =
+static ddsktx_format ddsktx__ktx_format(uint32_t internal_fmt, bool* srgb)
 {
-    { DDSKTX__KTX_A8,                           DDSKTX_FORMAT_A8    },
-    { DDSKTX__KTX_RED,                          DDSKTX_FORMAT_R8    },
-    { DDSKTX__KTX_RGB,                          DDSKTX_FORMAT_RGB8  },
-    { DDSKTX__KTX_RGBA,                         DDSKTX_FORMAT_RGBA8 },
-    { DDSKTX__KTX_COMPRESSED_RGB_S3TC_DXT1_EXT, DDSKTX_FORMAT_BC1   },
-};
+#define DDSKTX__CASE(_fmt, _internal)                   case _internal: return DDSKTX_FORMAT_##_fmt;
+#define DDSKTX__CASE_UNCOMPRESSED(_fmt, _internal, _gl_fmt, _type)  case _internal: return DDSKTX_FORMAT_##_fmt;
+#define DDSKTX__CASE_SRGB(_fmt, _internal)              case _internal: *srgb = true; return DDSKTX_FORMAT_##_fmt;
+    *srgb = false;
+    switch (internal_fmt) {
+    DDSKTX__KTX_COMPRESSED_FORMATS(DDSKTX__CASE)
+    DDSKTX__KTX_UNCOMPRESSED_FORMATS(DDSKTX__CASE_UNCOMPRESSED)
+    DDSKTX__KTX_SRGB_FORMATS(DDSKTX__CASE_SRGB)
+    DDSKTX__KTX_ALIAS_FORMATS(DDSKTX__CASE)
+    default: return _DDSKTX_FORMAT_COUNT;
+    }
+#undef DDSKTX__CASE
+#undef DDSKTX__CASE_UNCOMPRESSED
+#undef DDSKTX__CASE_SRGB
+}
 
-typedef struct ddsktx__format_info
+static uint32_t ddsktx__ktx_srgb_internal_fmt(ddsktx_format format)
 {
-    const char* name;
-    bool        has_alpha;
-} ddsktx__format_info;
+#define DDSKTX__CASE(_fmt, _internal)   case DDSKTX_FORMAT_##_fmt: return _internal;
+    switch (format) {
+    DDSKTX__KTX_SRGB_FORMATS(DDSKTX__CASE)
+    case DDSKTX_FORMAT_BGRA8: return DDSKTX__KTX_SRGB8_ALPHA8;
+    default: return DDSKTX__KTX_ZERO;
+    }
+#undef DDSKTX__CASE
+}
 
-static const ddsktx__format_info k__formats_info[] = {
-    {"BC1", false},
-    {"BC2", true},
-    {"BC3", true},
-    {"BC4", false},
-    {"BC5", false},
-    {"BC6H", false},
-    {"BC7", true},
-    {"ETC1", false},
-    {"ETC2", false},
-    {"ETC2A", true},
-    {"ETC2A1", true},
-    {"PTC12", false},
-    {"PTC14", false},
-    {"PTC12A", true},
-    {"PTC14A", true},
-    {"PTC22", true},
-    {"PTC24", true},
-    {"ATC", false},
-    {"ATCE", false},
-    {"ATCI", false},
-    {"ASTC4x4", true},
-    {"ASTC5x5", true},
-    {"ASTC6x6", false},
-    {"ASTC8x5", true},
-    {"ASTC8x6", false},
-    {"ASTC10x5", false},
-    {"<unknown>", false},
-    {"A8", true},
-    {"R8", false},
-    {"RGBA8", true},
-    {"RGBA8S", true},
-    {"RG16", false},
-    {"RGB8", false},
-    {"R16", false},
-    {"R32F", false},
-    {"R16F", false},
-    {"RG16F", false},
-    {"RG16S", false},
-    {"RGBA16F", true},
-    {"RGBA16",true},
-    {"BGRA8", true},
-    {"RGB10A2", true},
-    {"RG11B10F", false},
-    {"RG8", false},
-    {"RG8S", false}
-};
+// KTX2: https://github.khronos.org/KTX-Specification/
+#define DDSKTX__KTX2_HEADER_SIZE 76     // actual header size is 80, but we read 4 bytes for the 'magic'
+
+// Vulkan formats (VkFormat)
+#define DDSKTX__VK_FORMAT_R8_UNORM                  9
+#define DDSKTX__VK_FORMAT_R8_SRGB                   15
+#define DDSKTX__VK_FORMAT_R8G8_UNORM                16
+#define DDSKTX__VK_FORMAT_R8G8_SNORM                17
+#define DDSKTX__VK_FORMAT_R8G8B8_UNORM              23
+#define DDSKTX__VK_FORMAT_R8G8B8_SRGB               29
+#define DDSKTX__VK_FORMAT_R8G8B8A8_UNORM            37
+#define DDSKTX__VK_FORMAT_R8G8B8A8_SNORM            38
+#define DDSKTX__VK_FORMAT_R8G8B8A8_SRGB             43
+#define DDSKTX__VK_FORMAT_B8G8R8A8_UNORM            44
+#define DDSKTX__VK_FORMAT_B8G8R8A8_SRGB             50
+#define DDSKTX__VK_FORMAT_A2B10G10R10_UNORM_PACK32  64
+#define DDSKTX__VK_FORMAT_R16_UNORM                 70
+#define DDSKTX__VK_FORMAT_R16_SFLOAT                76
+#define DDSKTX__VK_FORMAT_R16G16_UNORM              77
+#define DDSKTX__VK_FORMAT_R16G16_SNORM              78
+#define DDSKTX__VK_FORMAT_R16G16_SFLOAT             83
+#define DDSKTX__VK_FORMAT_R16G16B16A16_UNORM        91
+#define DDSKTX__VK_FORMAT_R16G16B16A16_SFLOAT       97
+#define DDSKTX__VK_FORMAT_R32_SFLOAT                100
+#define DDSKTX__VK_FORMAT_B10G11R11_UFLOAT_PACK32   122
+#define DDSKTX__VK_FORMAT_BC1_RGB_UNORM_BLOCK       131
+#define DDSKTX__VK_FORMAT_BC1_RGB_SRGB_BLOCK        132
+#define DDSKTX__VK_FORMAT_BC1_RGBA_UNORM_BLOCK      133
+#define DDSKTX__VK_FORMAT_BC1_RGBA_SRGB_BLOCK       134
+#define DDSKTX__VK_FORMAT_BC2_UNORM_BLOCK           135
+#define DDSKTX__VK_FORMAT_BC2_SRGB_BLOCK            136
+#define DDSKTX__VK_FORMAT_BC3_UNORM_BLOCK           137
+#define DDSKTX__VK_FORMAT_BC3_SRGB_BLOCK            138
+#define DDSKTX__VK_FORMAT_BC4_UNORM_BLOCK           139
+#define DDSKTX__VK_FORMAT_BC5_UNORM_BLOCK           141
+#define DDSKTX__VK_FORMAT_BC6H_UFLOAT_BLOCK         143
+#define DDSKTX__VK_FORMAT_BC6H_SFLOAT_BLOCK         144
+#define DDSKTX__VK_FORMAT_BC7_UNORM_BLOCK           145
+#define DDSKTX__VK_FORMAT_BC7_SRGB_BLOCK            146
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK   147
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK    148
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK 149
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK  150
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK 151
+#define DDSKTX__VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK  152
+#define DDSKTX__VK_FORMAT_ASTC_4x4_UNORM_BLOCK      157
+#define DDSKTX__VK_FORMAT_ASTC_4x4_SRGB_BLOCK       158
+#define DDSKTX__VK_FORMAT_ASTC_5x5_UNORM_BLOCK      161
+#define DDSKTX__VK_FORMAT_ASTC_5x5_SRGB_BLOCK       162
+#define DDSKTX__VK_FORMAT_ASTC_6x6_UNORM_BLOCK      165
+#define DDSKTX__VK_FORMAT_ASTC_6x6_SRGB_BLOCK       166
+#define DDSKTX__VK_FORMAT_ASTC_8x5_UNORM_BLOCK      167
+#define DDSKTX__VK_FORMAT_ASTC_8x5_SRGB_BLOCK       168
+#define DDSKTX__VK_FORMAT_ASTC_8x6_UNORM_BLOCK      169
+#define DDSKTX__VK_FORMAT_ASTC_8x6_SRGB_BLOCK       170
+#define DDSKTX__VK_FORMAT_ASTC_10x5_UNORM_BLOCK     173
+#define DDSKTX__VK_FORMAT_ASTC_10x5_SRGB_BLOCK      174
+#define DDSKTX__VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG 1000054000
+#define DDSKTX__VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG 1000054001
+#define DDSKTX__VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG 1000054002
+#define DDSKTX__VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG 1000054003
+#define DDSKTX__VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG  1000054004
+#define DDSKTX__VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG  1000054005
+#define DDSKTX__VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG  1000054006
+#define DDSKTX__VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG  1000054007
+#define DDSKTX__VK_FORMAT_A8_UNORM_KHR                1000470001
 
+// VkFormat of KTX2 headers
+#define DDSKTX__VK_FORMATS(_)                                         \
+    _(DDSKTX__VK_FORMAT_BC1_RGB_UNORM_BLOCK,         BC1,      false) \
+    _(DDSKTX__VK_FORMAT_BC1_RGB_SRGB_BLOCK,          BC1,      true ) \
+    _(DDSKTX__VK_FORMAT_BC1_RGBA_UNORM_BLOCK,        BC1,      false) \
+    _(DDSKTX__VK_FORMAT_BC1_RGBA_SRGB_BLOCK,         BC1,      true ) \
+    _(DDSKTX__VK_FORMAT_BC2_UNORM_BLOCK,             BC2,      false) \
+    _(DDSKTX__VK_FORMAT_BC2_SRGB_BLOCK,              BC2,      true ) \
+    _(DDSKTX__VK_FORMAT_BC3_UNORM_BLOCK,             BC3,      false) \
+    _(DDSKTX__VK_FORMAT_BC3_SRGB_BLOCK,              BC3,      true ) \
+    _(DDSKTX__VK_FORMAT_BC4_UNORM_BLOCK,             BC4,      false) \
+    _(DDSKTX__VK_FORMAT_BC5_UNORM_BLOCK,             BC5,      false) \
+    _(DDSKTX__VK_FORMAT_BC6H_UFLOAT_BLOCK,           BC6H,     false) \
+    _(DDSKTX__VK_FORMAT_BC6H_SFLOAT_BLOCK,           BC6H,     false) \
+    _(DDSKTX__VK_FORMAT_BC7_UNORM_BLOCK,             BC7,      false) \
+    _(DDSKTX__VK_FORMAT_BC7_SRGB_BLOCK,              BC7,      true ) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,     ETC2,     false) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,      ETC2,     true ) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,   ETC2A1,   false) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK,    ETC2A1,   true ) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,   ETC2A,    false) \
+    _(DDSKTX__VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,    ETC2A,    true ) \
+    _(DDSKTX__VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, PTC12A,   false) \
+    _(DDSKTX__VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG,  PTC12A,   true ) \
+    _(DDSKTX__VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG, PTC14A,   false) \
+    _(DDSKTX__VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG,  PTC14A,   true ) \
+    _(DDSKTX__VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG, PTC22,    false) \
+    _(DDSKTX__VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG,  PTC22,    true ) \
+    _(DDSKTX__VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG, PTC24,    false) \
+    _(DDSKTX__VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG,  PTC24,    true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_4x4_UNORM_BLOCK,        ASTC4x4,  false) \
+    _(DDSKTX__VK_FORMAT_ASTC_4x4_SRGB_BLOCK,         ASTC4x4,  true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_5x5_UNORM_BLOCK,        ASTC5x5,  false) \
+    _(DDSKTX__VK_FORMAT_ASTC_5x5_SRGB_BLOCK,         ASTC5x5,  true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_6x6_UNORM_BLOCK,        ASTC6x6,  false) \
+    _(DDSKTX__VK_FORMAT_ASTC_6x6_SRGB_BLOCK,         ASTC6x6,  true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_8x5_UNORM_BLOCK,        ASTC8x5,  false) \
+    _(DDSKTX__VK_FORMAT_ASTC_8x5_SRGB_BLOCK,         ASTC8x5,  true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_8x6_UNORM_BLOCK,        ASTC8x6,  false) \
+    _(DDSKTX__VK_FORMAT_ASTC_8x6_SRGB_BLOCK,         ASTC8x6,  true ) \
+    _(DDSKTX__VK_FORMAT_ASTC_10x5_UNORM_BLOCK,       ASTC10x5, false) \
+    _(DDSKTX__VK_FORMAT_ASTC_10x5_SRGB_BLOCK,        ASTC10x5, true ) \
+    _(DDSKTX__VK_FORMAT_A8_UNORM_KHR,                A8,       false) \
+    _(DDSKTX__VK_FORMAT_R8_UNORM,                    R8,       false) \
+    _(DDSKTX__VK_FORMAT_R8_SRGB,                     R8,       true ) \
+    _(DDSKTX__VK_FORMAT_R8G8B8A8_UNORM,              RGBA8,    false) \
+    _(DDSKTX__VK_FORMAT_R8G8B8A8_SRGB,               RGBA8,    true ) \
+    _(DDSKTX__VK_FORMAT_R8G8B8A8_SNORM,              RGBA8S,   false) \
+    _(DDSKTX__VK_FORMAT_R16G16_UNORM,                RG16,     false) \
+    _(DDSKTX__VK_FORMAT_R8G8B8_UNORM,                RGB8,     false) \
+    _(DDSKTX__VK_FORMAT_R8G8B8_SRGB,                 RGB8,     true ) \
+    _(DDSKTX__VK_FORMAT_R16_UNORM,                   R16,      false) \
+    _(DDSKTX__VK_FORMAT_R32_SFLOAT,                  R32F,     false) \
+    _(DDSKTX__VK_FORMAT_R16_SFLOAT,                  R16F,     false) \
+    _(DDSKTX__VK_FORMAT_R16G16_SFLOAT,               RG16F,    false) \
+    _(DDSKTX__VK_FORMAT_R16G16_SNORM,                RG16S,    false) \
+    _(DDSKTX__VK_FORMAT_R16G16B16A16_SFLOAT,         RGBA16F,  false) \
+    _(DDSKTX__VK_FORMAT_R16G16B16A16_UNORM,          RGBA16,   false) \
+    _(DDSKTX__VK_FORMAT_B8G8R8A8_UNORM,              BGRA8,    false) \
+    _(DDSKTX__VK_FORMAT_B8G8R8A8_SRGB,               BGRA8,    true ) \
+    _(DDSKTX__VK_FORMAT_A2B10G10R10_UNORM_PACK32,    RGB10A2,  false) \
+    _(DDSKTX__VK_FORMAT_B10G11R11_UFLOAT_PACK32,     RG11B10F, false) \
+    _(DDSKTX__VK_FORMAT_R8G8_UNORM,                  RG8,      false) \
+    _(DDSKTX__VK_FORMAT_R8G8_SNORM,                  RG8S,     false)
 
-static inline int ddsktx__read(ddsktx__mem_reader* reader, void* buff, int size)
+static ddsktx_format ddsktx__vk_format(uint32_t vk_format, bool* srgb)
 {
-    int read_bytes = (reader->offset + size) <= reader->total ? size : (reader->total - reader->offset);
-    ddsktx_memcpy(buff, reader->buff + reader->offset, read_bytes);
-    reader->offset += read_bytes;
-    return read_bytes;
+#define DDSKTX__CASE(_vk, _fmt, _srgb)  case _vk: *srgb = _srgb; return DDSKTX_FORMAT_##_fmt;
+    switch (vk_format) {
+    DDSKTX__VK_FORMATS(DDSKTX__CASE)
+    default: return _DDSKTX_FORMAT_COUNT;
+    }
+#undef DDSKTX__CASE
 }
 
-static bool ddsktx__parse_ktx(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format conversion
+#if defined(DDSKTX_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define DDSKTX__SSE2 1
+#   include <emmintrin.h>
+#   if defined(__SSSE3__) || defined(__AVX__)
+#       define DDSKTX__SSSE3 1
+#       include <tmmintrin.h>
+#   endif
+#   if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#       define DDSKTX__F16C 1
+#       include <immintrin.h>
+#   endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define DDSKTX__NEON 1
+#   include <arm_neon.h>
+#endif
+
+typedef struct ddsktx__convert_info
 {
-    static const uint8_t ktx__id[] = { 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    uint8_t src_bpp;
+    uint8_t dst_bpp;
+} ddsktx__convert_info;
 
-    ddsktx_memset(tc, 0x0, sizeof(ddsktx_texture_info));
+static const ddsktx__convert_info k__convert_info[] = {
+    {  0,   0  },   // NONE
+    { 24,  32  },   // RGB8_TO_RGBA8
+    { 32,  32  },   // BGRA8_TO_RGBA8
+    { 32,  32  },   // RGBA8_TO_BGRA8
+    { 32,  64  },   // RGB10A2_TO_RGBA16
+    { 16,  32  },   // R16F_TO_R32F
+    { 32,  64  },   // RG16F_TO_RG32F
+    { 64,  128 },   // RGBA16F_TO_RGBA32F
+};
 
-    ddsktx__mem_reader r = {(const uint8_t*)file_data, size, sizeof(uint32_t)};
-    ddsktx__ktx_header header;
-    if (ddsktx__read(&r, &header, sizeof(header)) != DDSKTX__KTX_HEADER_SIZE) {
-        ddsktx__err(err, "ktx; header size does not match");
+static void ddsktx__convert_rgb8_rgba8(const uint8_t* src, uint8_t* dst, int width)
+{
+    int x = 0;
+#if DDSKTX__SSSE3
+    // 16 pixels per iteration, the last load reads 4 bytes past the 48 source bytes, so keep 2 pixels extra
+    const __m128i shuf = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    for (; x + 18 <= width; x += 16) {
+        const uint8_t* s = src + x*3;
+        __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s +  0)), shuf);
+        __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 12)), shuf);
+        __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 24)), shuf);
+        __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 36)), shuf);
+        __m128i* d = (__m128i*)(dst + x*4);
+        _mm_storeu_si128(d + 0, _mm_or_si128(p0, alpha));
+        _mm_storeu_si128(d + 1, _mm_or_si128(p1, alpha));
+        _mm_storeu_si128(d + 2, _mm_or_si128(p2, alpha));
+        _mm_storeu_si128(d + 3, _mm_or_si128(p3, alpha));
     }
-
-    if (ddsktx_memcmp(header.id, ktx__id, sizeof(header.id)) != 0) {
-        ddsktx__err(err, "ktx: invalid file header");
+#elif DDSKTX__NEON
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src + x*3);
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgb.val[0];
+        rgba.val[1] = rgb.val[1];
+        rgba.val[2] = rgb.val[2];
+        rgba.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst + x*4, rgba);
     }
-
-    // TODO: support big endian
-    if (header.endianess != 0x04030201) {
-        ddsktx__err(err, "ktx: big-endian format is not supported");
+#endif
+    for (; x < width; x++) {
+        dst[x*4 + 0] = src[x*3 + 0];
+        dst[x*4 + 1] = src[x*3 + 1];
+        dst[x*4 + 2] = src[x*3 + 2];
+        dst[x*4 + 3] = 0xff;
     }
+}
 
-    tc->metadata_offset = r.offset;
-    tc->metadata_size = (int)header.metadata_size;
-    r.offset += (int)header.metadata_size;
-
-    ddsktx_format format = _DDSKTX_FORMAT_COUNT;
+// swaps R and B channels, works in both directions
+static void ddsktx__convert_swizzle_rb(const uint8_t* src, uint8_t* dst, int width)
+{
+    int x = 0;
+#if DDSKTX__SSE2
+    const __m128i mask_ga = _mm_set1_epi32((int)0xff00ff00);
+    const __m128i mask_b = _mm_set1_epi32(0xff);
+    for (; x + 4 <= width; x += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + x*4));
+        __m128i ga = _mm_and_si128(p, mask_ga);
+        __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), mask_b);
+        __m128i b = _mm_slli_epi32(_mm_and_si128(p, mask_b), 16);
+        _mm_storeu_si128((__m128i*)(dst + x*4), _mm_or_si128(ga, _mm_or_si128(r, b)));
+    }
+#elif DDSKTX__NEON
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t p = vld4q_u8(src + x*4);
+        uint8x16_t tmp = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = tmp;
+        vst4q_u8(dst + x*4, p);
+    }
+#endif
+    for (; x < width; x++) {
+        uint8_t r = src[x*4 + 0];
+        dst[x*4 + 0] = src[x*4 + 2];
+        dst[x*4 + 1] = src[x*4 + 1];
+        dst[x*4 + 2] = r;
+        dst[x*4 + 3] = src[x*4 + 3];
+    }
+}
 
-    int count = sizeof(k__translate_ktx_fmt)/sizeof(ddsktx__ktx_format_info);
-    for (int i = 0; i < count; i++) {
-        if (k__translate_ktx_fmt[i].internal_fmt == header.internal_format) {
-            format = (ddsktx_format)i;
-            break;
+// 10bit channels are expanded by bit replication, so 0x3ff becomes 0xffff
+static void ddsktx__convert_rgb10a2_rgba16(const uint8_t* src, uint8_t* dst, int width)
+{
+    int x = 0;
+#if DDSKTX__SSE2
+    const __m128i mask10 = _mm_set1_epi32(0x3ff);
+    for (; x + 4 <= width; x += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + x*4));
+        __m128i r = _mm_and_si128(p, mask10);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(p, 10), mask10);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p, 20), mask10);
+        __m128i a = _mm_srli_epi32(p, 30);
+        r = _mm_or_si128(_mm_slli_epi32(r, 6), _mm_srli_epi32(r, 4));
+        g = _mm_or_si128(_mm_slli_epi32(g, 6), _mm_srli_epi32(g, 4));
+        b = _mm_or_si128(_mm_slli_epi32(b, 6), _mm_srli_epi32(b, 4));
+        a = _mm_mullo_epi16(a, _mm_set1_epi32(0x5555));
+        __m128i rg = _mm_or_si128(r, _mm_slli_epi32(g, 16));
+        __m128i ba = _mm_or_si128(b, _mm_slli_epi32(a, 16));
+        __m128i* d = (__m128i*)(dst + x*8);
+        _mm_storeu_si128(d + 0, _mm_unpacklo_epi32(rg, ba));
+        _mm_storeu_si128(d + 1, _mm_unpackhi_epi32(rg, ba));
+    }
+#elif DDSKTX__NEON
+    const uint32x4_t mask10 = vdupq_n_u32(0x3ff);
+    for (; x + 4 <= width; x += 4) {
+        uint32x4_t p = vld1q_u32((const uint32_t*)(src + x*4));
+        uint16x4x4_t c;
+        c.val[0] = vmovn_u32(vandq_u32(p, mask10));
+        c.val[1] = vmovn_u32(vandq_u32(vshrq_n_u32(p, 10), mask10));
+        c.val[2] = vmovn_u32(vandq_u32(vshrq_n_u32(p, 20), mask10));
+        c.val[3] = vmul_n_u16(vmovn_u32(vshrq_n_u32(p, 30)), 0x5555);
+        for (int i = 0; i < 3; i++) {
+            c.val[i] = vorr_u16(vshl_n_u16(c.val[i], 6), vshr_n_u16(c.val[i], 4));
         }
+        vst4_u16((uint16_t*)(dst + x*8), c);
     }
-
-    if (format == _DDSKTX_FORMAT_COUNT) {
-        count = sizeof(k__translate_ktx_fmt2)/sizeof(ddsktx__ktx_format_info2);
-        for (int i = 0; i < count; i++) {
-            if (k__translate_ktx_fmt2[i].internal_fmt == header.internal_format) {
-                format = (ddsktx_format)k__translate_ktx_fmt2[i].format;
-                break;
-            }
+#endif
+    for (; x < width; x++) {
+        uint32_t p;
+        ddsktx_memcpy(&p, src + x*4, sizeof(p));
+        uint16_t c[4];
+        for (int i = 0; i < 3; i++) {
+            uint32_t v = (p >> (i*10)) & 0x3ff;
+            c[i] = (uint16_t)((v << 6) | (v >> 4));
         }
+        c[3] = (uint16_t)((p >> 30) * 0x5555);
+        ddsktx_memcpy(dst + x*8, c, sizeof(c));
     }
+}
 
-    if (format == _DDSKTX_FORMAT_COUNT) {
-        ddsktx__err(err, "ktx: unsupported format");
-    } 
-
-    if (header.face_count > 1 && header.face_count != DDSKTX_CUBE_FACE_COUNT) {
-        ddsktx__err(err, "ktx: incomplete cubemap");
+static inline uint32_t ddsktx__half_to_float_bits(uint16_t h)
+{
+    // https://fgiesen.wordpress.com/2012/03/28/half-to-float-done-quic/
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    uint32_t o = ((uint32_t)h & 0x7fff) << 13;
+    uint32_t exp = shifted_exp & o;
+    o += (127 - 15) << 23;
+    if (exp == shifted_exp) {
+        o += (128 - 16) << 23;      // Inf/NaN
+    } else if (exp == 0) {
+        union { uint32_t u; float f; } f, magic;
+        magic.u = 113 << 23;
+        f.u = o + (1 << 23);        // denormal
+        f.f -= magic.f;
+        o = f.u;
     }
+    return o | (((uint32_t)h & 0x8000) << 16);
+}
 
-    tc->data_offset = r.offset;
-    tc->size_bytes = r.total - r.offset;
-    tc->format = format;
-    tc->width = (int)header.width;
-    tc->height = (int)header.height;
-    tc->depth = ddsktx__max((int)header.depth, 1);
-    tc->num_layers = ddsktx__max((int)header.array_count, 1);
-    tc->num_mips = ddsktx__max((int)header.mip_count, 1);
-    tc->bpp = k__block_info[format].bpp;
+// converts 'count' half-floats, used for all the 16F formats
+static void ddsktx__convert_half_float(const uint8_t* src, uint8_t* dst, int count)
+{
+    int i = 0;
+#if DDSKTX__F16C
+    // note: hardware conversion quiets signaling NaNs, the other paths keep them as they are
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i*2));
+        _mm256_storeu_ps((float*)(dst + i*4), _mm256_cvtph_ps(h));
+    }
+#elif DDSKTX__SSE2
+    // same as ddsktx__half_to_float_bits, 4 at a time
+    const __m128i mask_nosign = _mm_set1_epi32(0x7fff);
+    const __m128i shifted_exp = _mm_set1_epi32(0x7c00 << 13);
+    const __m128i exp_adjust = _mm_set1_epi32((127 - 15) << 23);
+    const __m128i infnan_adjust = _mm_set1_epi32((128 - 16) << 23);
+    const __m128i denorm_adjust = _mm_set1_epi32(1 << 23);
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src + i*2)), zero);
+        __m128i o = _mm_slli_epi32(_mm_and_si128(h, mask_nosign), 13);
+        __m128i exp = _mm_and_si128(o, shifted_exp);
+        o = _mm_add_epi32(o, exp_adjust);
+        __m128i is_infnan = _mm_cmpeq_epi32(exp, shifted_exp);
+        __m128i is_denorm = _mm_cmpeq_epi32(exp, zero);
+        o = _mm_add_epi32(o, _mm_and_si128(is_infnan, infnan_adjust));
+        __m128 denorm = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, denorm_adjust)), magic);
+        o = _mm_or_si128(_mm_andnot_si128(is_denorm, o), _mm_and_si128(is_denorm, _mm_castps_si128(denorm)));
+        o = _mm_or_si128(o, _mm_slli_epi32(_mm_andnot_si128(mask_nosign, h), 16));
+        _mm_storeu_si128((__m128i*)(dst + i*4), o);
+    }
+#elif DDSKTX__NEON && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16((const uint16_t*)(src + i*2)));
+        vst1q_f32((float*)(dst + i*4), vcvt_f32_f16(h));
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t h;
+        ddsktx_memcpy(&h, src + i*2, sizeof(h));
+        uint32_t f = ddsktx__half_to_float_bits(h);
+        ddsktx_memcpy(dst + i*4, &f, sizeof(f));
+    }
+}
 
-    if (header.face_count == 6)
-        tc->flags |= DDSKTX_TEXTURE_FLAG_CUBEMAP;
-    tc->flags |= k__formats_info[format].has_alpha ? DDSKTX_TEXTURE_FLAG_ALPHA : 0;
-    tc->flags |= DDSKTX_TEXTURE_FLAG_KTX;
+ddsktx_convert_op ddsktx_gpu_convert_op(ddsktx_format format)
+{
+    switch (format) {
+    case DDSKTX_FORMAT_RGB8:    return DDSKTX_CONVERT_RGB8_TO_RGBA8;
+    default:                    return DDSKTX_CONVERT_NONE;
+    }
+}
 
-    return true;
+int ddsktx_convert_row_bytes(ddsktx_convert_op op, int width)
+{
+    ddsktx_assert(op > DDSKTX_CONVERT_NONE && op < _DDSKTX_CONVERT_COUNT);
+    return width * k__convert_info[op].dst_bpp / 8;
 }
 
-static bool ddsktx__parse_dds(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err)
+void ddsktx_convert_row(ddsktx_convert_op op, const void* src, void* dst, int width)
 {
-    ddsktx__mem_reader r = {(const uint8_t*)file_data, size, sizeof(uint32_t)};
-    ddsktx__dds_header header;
-    if (ddsktx__read(&r, &header, sizeof(header)) < DDSKTX__DDS_HEADER_SIZE ||
-        header.size != DDSKTX__DDS_HEADER_SIZE)
-    {
-        ddsktx__err(err, "dds: header size does not match");
+    ddsktx_assert(op > DDSKTX_CONVERT_NONE && op < _DDSKTX_CONVERT_COUNT);
+    ddsktx_assert(src);
+    ddsktx_assert(dst);
+    ddsktx_assert(src != dst || k__convert_info[op].src_bpp == k__convert_info[op].dst_bpp);
+
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+    switch (op) {
+    case DDSKTX_CONVERT_RGB8_TO_RGBA8:      ddsktx__convert_rgb8_rgba8(s, d, width);        break;
+    case DDSKTX_CONVERT_BGRA8_TO_RGBA8:
+    case DDSKTX_CONVERT_RGBA8_TO_BGRA8:     ddsktx__convert_swizzle_rb(s, d, width);        break;
+    case DDSKTX_CONVERT_RGB10A2_TO_RGBA16:  ddsktx__convert_rgb10a2_rgba16(s, d, width);    break;
+    case DDSKTX_CONVERT_R16F_TO_R32F:       ddsktx__convert_half_float(s, d, width);        break;
+    case DDSKTX_CONVERT_RG16F_TO_RG32F:     ddsktx__convert_half_float(s, d, width*2);      break;
+    case DDSKTX_CONVERT_RGBA16F_TO_RGBA32F: ddsktx__convert_half_float(s, d, width*4);      break;
+    default:                                ddsktx_assert(0);                               break;
     }
+}
 
-    uint32_t required_flags = (DDSKTX__DDSD_HEIGHT|DDSKTX__DDSD_WIDTH);
-    if ((header.flags & required_flags) != required_flags) {
-        ddsktx__err(err, "dds: have invalid flags");
+void ddsktx_convert_sub(ddsktx_convert_op op, const ddsktx_sub_data* sub, void* dst, int dst_row_pitch,
+                        int first_row, int num_rows)
+{
+    ddsktx_assert(op > DDSKTX_CONVERT_NONE && op < _DDSKTX_CONVERT_COUNT);
+    ddsktx_assert(sub);
+    ddsktx_assert(first_row >= 0 && num_rows >= 0 && first_row + num_rows <= sub->height);
+    ddsktx_assert(dst_row_pitch >= ddsktx_convert_row_bytes(op, sub->width));
+
+    const uint8_t* src = (const uint8_t*)sub->buff + (int64_t)first_row * sub->row_pitch_bytes;
+    uint8_t* d = (uint8_t*)dst;
+    for (int y = 0; y < num_rows; y++) {
+        ddsktx_convert_row(op, src, d, sub->width);
+        src += sub->row_pitch_bytes;
+        d += dst_row_pitch;
     }
+}
 
-    if (header.pixel_format.size != sizeof(ddsktx__dds_pixel_format)) {
-        ddsktx__err(err, "dds: pixel format header is invalid");
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC1-BC7, ETC1/ETC2 and ASTC block decoding
+// Blocks are decoded one by one into a pixel block on stack (4x4, or the ASTC footprint), then copied (clipped)
+// to destination
+// BC6H/BC7 tables and bit layouts: https://docs.microsoft.com/en-us/windows/win32/direct3d11/bc7-format
+typedef struct ddsktx__bits
+{
+    uint64_t lo;
+    uint64_t hi;
+} ddsktx__bits;
+
+static inline void ddsktx__bits_init(ddsktx__bits* b, const uint8_t* block)
+{
+    b->lo = 0;
+    b->hi = 0;
+    for (int i = 7; i >= 0; i--) {
+        b->lo = (b->lo << 8) | block[i];
+        b->hi = (b->hi << 8) | block[i + 8];
     }
+}
 
-    uint32_t dxgi_format = 0;
-    uint32_t array_size = 1;
-    if (DDSKTX__DDPF_FOURCC == (header.flags & DDSKTX__DDPF_FOURCC) && 
-        header.pixel_format.fourcc == DDSKTX__DDS_DX10)
+static inline int ddsktx__bits_read(ddsktx__bits* b, int count)
+{
+    ddsktx_assert(count > 0 && count < 32);
+    int r = (int)(b->lo & ((1u << count) - 1));
+    b->lo = (b->lo >> count) | (b->hi << (64 - count));
+    b->hi >>= count;
+    return r;
+}
+
+static inline int ddsktx__sign_extend(int v, int bits)
+{
+    int m = 1 << (bits - 1);
+    return (v ^ m) - m;
+}
+
+// 2 subset partitions, one bit per pixel (subset index). BC6H uses the first 32
+static const uint16_t k__bc_partition2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+// 3 subset partitions, two bits per pixel (subset index)
+static const uint32_t k__bc_partition3[64] = {
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+    0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+    0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+    0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+    0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+    0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+    0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254
+};
+
+// anchor pixels (index is stored with one less bit) of the second subset in 2 subset partitions
+static const uint8_t k__bc_anchor2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15,  15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,   2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,   2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2,  15, 15, 15, 15, 15,  2,  2, 15
+};
+
+// anchor pixels of the second and third subsets in 3 subset partitions
+static const uint8_t k__bc_anchor3[2][64] = {
     {
-        ddsktx__dds_header_dxgi dxgi_header;
-        ddsktx__read(&r, &dxgi_header, sizeof(dxgi_header));
-        dxgi_format = dxgi_header.dxgi_format;
-        array_size = dxgi_header.array_size;
+         3,  3, 15, 15,  8,  3, 15, 15,   8,  8,  6,  6,  6,  5,  3,  3,
+         3,  3,  8, 15,  3,  3,  6, 10,   5,  8,  8,  6,  8,  5, 15, 15,
+         8, 15,  3,  5,  6, 10,  8, 15,  15,  3, 15,  5, 15, 15, 15, 15,
+         3, 15,  5,  5,  5,  8,  5, 10,   5, 10,  8, 13, 15, 12,  3,  3
+    },
+    {
+        15,  8,  8,  3, 15, 15,  3,  8,  15, 15, 15, 15, 15, 15, 15,  8,
+        15,  8, 15,  3, 15,  8, 15,  8,   3, 15,  6, 10, 15, 15, 10,  8,
+        15,  3, 15, 10, 10,  8,  9, 10,   6, 15,  8, 15,  3,  6,  6,  8,
+        15,  3, 15, 15, 15, 15, 15, 15,  15, 15, 15, 15,  3, 15, 15,  8
     }
+};
 
-    if ((header.caps1 & DDSKTX__DDSCAPS_TEXTURE) == 0) {
-        ddsktx__err(err, "dds: unsupported caps");
-    }
+static const uint8_t k__bc_weights2[4] = { 0, 21, 43, 64 };
+static const uint8_t k__bc_weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t k__bc_weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
 
-    bool cubemap = (header.caps2 & DDSKTX__DDSCAPS2_CUBEMAP) != 0;
-    if (cubemap && (header.caps2 & DDSKTX__DDSCAPS2_CUBEMAP_ALLSIDES) != DDSKTX__DDSCAPS2_CUBEMAP_ALLSIDES) {
-        ddsktx__err(err, "dds: incomplete cubemap");
-    }
-    bool volume = (header.caps2 & DDSKTX__DDSCAPS2_VOLUME) != 0;
+static inline int ddsktx__bc_interp(int e0, int e1, int index, int index_bits)
+{
+    int w = index_bits == 2 ? k__bc_weights2[index] :
+            (index_bits == 3 ? k__bc_weights3[index] : k__bc_weights4[index]);
+    return ((64 - w)*e0 + w*e1 + 32) >> 6;
+}
+
+static inline uint8_t ddsktx__expand_bits(int v, int bits)
+{
+    return (uint8_t)((v << (8 - bits)) | (v >> (2*bits - 8)));
+}
+
+// color part of BC1/BC2/BC3, 'has_alpha_mode' is only true for BC1, where c0 <= c1 selects 3 colors + transparent
+static void ddsktx__decode_bc1_color(const uint8_t* block, uint8_t* rgba, bool has_alpha_mode)
+{
+    int c0 = block[0] | (block[1] << 8);
+    int c1 = block[2] | (block[3] << 8);
+    uint8_t colors[4][4];
+
+    colors[0][0] = ddsktx__expand_bits((c0 >> 11) & 0x1f, 5);
+    colors[0][1] = ddsktx__expand_bits((c0 >> 5) & 0x3f, 6);
+    colors[0][2] = ddsktx__expand_bits(c0 & 0x1f, 5);
+    colors[1][0] = ddsktx__expand_bits((c1 >> 11) & 0x1f, 5);
+    colors[1][1] = ddsktx__expand_bits((c1 >> 5) & 0x3f, 6);
+    colors[1][2] = ddsktx__expand_bits(c1 & 0x1f, 5);
+    colors[0][3] = colors[1][3] = colors[2][3] = colors[3][3] = 255;
+
+    if (c0 > c1 || !has_alpha_mode) {
+        for (int c = 0; c < 3; c++) {
+            colors[2][c] = (uint8_t)((2*colors[0][c] + colors[1][c] + 1) / 3);
+            colors[3][c] = (uint8_t)((colors[0][c] + 2*colors[1][c] + 1) / 3);
+        }
+    } else {
+        for (int c = 0; c < 3; c++) {
+            colors[2][c] = (uint8_t)((colors[0][c] + colors[1][c] + 1) / 2);
+            colors[3][c] = 0;
+        }
+        colors[3][3] = 0;
+    }
+
+    uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) |
+                       ((uint32_t)block[7] << 24);
+    for (int i = 0; i < 16; i++) {
+        ddsktx_memcpy(rgba + i*4, colors[(indices >> (i*2)) & 3], 4);
+    }
+}
+
+// BC4 block (also alpha of BC3 and channels of BC5), writes into one channel of rgba
+static void ddsktx__decode_bc4_channel(const uint8_t* block, uint8_t* rgba, int channel)
+{
+    int a0 = block[0];
+    int a1 = block[1];
+    uint8_t values[8];
+    values[0] = (uint8_t)a0;
+    values[1] = (uint8_t)a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) {
+            values[i + 1] = (uint8_t)(((7 - i)*a0 + i*a1 + 3) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; i++) {
+            values[i + 1] = (uint8_t)(((5 - i)*a0 + i*a1 + 2) / 5);
+        }
+        values[6] = 0;
+        values[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 7; i >= 2; i--) {
+        indices = (indices << 8) | block[i];
+    }
+    for (int i = 0; i < 16; i++) {
+        rgba[i*4 + channel] = values[(indices >> (i*3)) & 7];
+    }
+}
+
+static void ddsktx__decode_bc2_alpha(const uint8_t* block, uint8_t* rgba)
+{
+    for (int i = 0; i < 16; i++) {
+        rgba[i*4 + 3] = (uint8_t)(((block[i >> 1] >> ((i & 1)*4)) & 0xf) * 17);
+    }
+}
+
+typedef struct ddsktx__bc7_mode
+{
+    uint8_t num_subsets;
+    uint8_t partition_bits;
+    uint8_t rotation_bits;
+    uint8_t index_sel_bits;
+    uint8_t color_bits;
+    uint8_t alpha_bits;
+    uint8_t endpoint_pbits;     // unique p-bit per endpoint
+    uint8_t shared_pbits;       // p-bit shared by endpoints of each subset
+    uint8_t index_bits;
+    uint8_t index2_bits;
+} ddsktx__bc7_mode;
+
+static const ddsktx__bc7_mode k__bc7_modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+static void ddsktx__decode_bc7(const uint8_t* block, uint8_t* rgba)
+{
+    ddsktx__bits bits;
+    ddsktx__bits_init(&bits, block);
+
+    int mode = 0;
+    while (mode < 8 && !ddsktx__bits_read(&bits, 1)) {
+        mode++;
+    }
+    if (mode == 8) {
+        // reserved mode: decodes to transparent black
+        ddsktx_memset(rgba, 0x0, 64);
+        return;
+    }
+
+    const ddsktx__bc7_mode* m = &k__bc7_modes[mode];
+    int partition = m->partition_bits ? ddsktx__bits_read(&bits, m->partition_bits) : 0;
+    int rotation = m->rotation_bits ? ddsktx__bits_read(&bits, m->rotation_bits) : 0;
+    int index_sel = m->index_sel_bits ? ddsktx__bits_read(&bits, m->index_sel_bits) : 0;
+
+    // endpoints: [subset*2 + n][channel]
+    int endpoints[6][4];
+    int num_endpoints = m->num_subsets*2;
+    for (int c = 0; c < 3; c++) {
+        for (int e = 0; e < num_endpoints; e++) {
+            endpoints[e][c] = ddsktx__bits_read(&bits, m->color_bits);
+        }
+    }
+    for (int e = 0; e < num_endpoints; e++) {
+        endpoints[e][3] = m->alpha_bits ? ddsktx__bits_read(&bits, m->alpha_bits) : 255;
+    }
+
+    int color_bits = m->color_bits;
+    int alpha_bits = m->alpha_bits;
+    if (m->endpoint_pbits || m->shared_pbits) {
+        int pbits[6];
+        if (m->endpoint_pbits) {
+            for (int e = 0; e < num_endpoints; e++) {
+                pbits[e] = ddsktx__bits_read(&bits, 1);
+            }
+        } else {
+            for (int s = 0; s < m->num_subsets; s++) {
+                pbits[s*2] = pbits[s*2 + 1] = ddsktx__bits_read(&bits, 1);
+            }
+        }
+
+        for (int e = 0; e < num_endpoints; e++) {
+            for (int c = 0; c < 3; c++) {
+                endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+            }
+            if (alpha_bits) {
+                endpoints[e][3] = (endpoints[e][3] << 1) | pbits[e];
+            }
+        }
+        color_bits++;
+        alpha_bits = alpha_bits ? alpha_bits + 1 : 0;
+    }
+
+    for (int e = 0; e < num_endpoints; e++) {
+        for (int c = 0; c < 3; c++) {
+            endpoints[e][c] = ddsktx__expand_bits(endpoints[e][c], color_bits);
+        }
+        if (alpha_bits) {
+            endpoints[e][3] = ddsktx__expand_bits(endpoints[e][3], alpha_bits);
+        }
+    }
+
+    int anchors[3] = { 0, 0, 0 };
+    if (m->num_subsets == 2) {
+        anchors[1] = k__bc_anchor2[partition];
+    } else if (m->num_subsets == 3) {
+        anchors[1] = k__bc_anchor3[0][partition];
+        anchors[2] = k__bc_anchor3[1][partition];
+    }
+
+    int subsets[16];
+    int indices[16];
+    int indices2[16];
+    for (int i = 0; i < 16; i++) {
+        int s = 0;
+        if (m->num_subsets == 2) {
+            s = (k__bc_partition2[partition] >> i) & 1;
+        } else if (m->num_subsets == 3) {
+            s = (int)(k__bc_partition3[partition] >> (i*2)) & 3;
+        }
+        subsets[i] = s;
+        indices[i] = ddsktx__bits_read(&bits, m->index_bits - (anchors[s] == i ? 1 : 0));
+    }
+    if (m->index2_bits) {
+        for (int i = 0; i < 16; i++) {
+            indices2[i] = ddsktx__bits_read(&bits, m->index2_bits - (i == 0 ? 1 : 0));
+        }
+    }
+
+    for (int i = 0; i < 16; i++) {
+        const int* e0 = endpoints[subsets[i]*2];
+        const int* e1 = endpoints[subsets[i]*2 + 1];
+        int color_index = indices[i];
+        int color_index_bits = m->index_bits;
+        int alpha_index = indices[i];
+        int alpha_index_bits = m->index_bits;
+        if (m->index2_bits) {
+            if (index_sel) {
+                color_index = indices2[i];
+                color_index_bits = m->index2_bits;
+            } else {
+                alpha_index = indices2[i];
+                alpha_index_bits = m->index2_bits;
+            }
+        }
+
+        uint8_t* p = rgba + i*4;
+        for (int c = 0; c < 3; c++) {
+            p[c] = (uint8_t)ddsktx__bc_interp(e0[c], e1[c], color_index, color_index_bits);
+        }
+        p[3] = (uint8_t)ddsktx__bc_interp(e0[3], e1[3], alpha_index, alpha_index_bits);
+
+        if (rotation) {
+            uint8_t tmp = p[3];
+            p[3] = p[rotation - 1];
+            p[rotation - 1] = tmp;
+        }
+    }
+}
+
+// BC6H endpoint fields, in the order of k__bc6h_layout values: channel*4 + endpoint (w, x, y, z)
+enum {
+    DDSKTX__BC6H_RW = 0, DDSKTX__BC6H_RX, DDSKTX__BC6H_RY, DDSKTX__BC6H_RZ,
+    DDSKTX__BC6H_GW, DDSKTX__BC6H_GX, DDSKTX__BC6H_GY, DDSKTX__BC6H_GZ,
+    DDSKTX__BC6H_BW, DDSKTX__BC6H_BX, DDSKTX__BC6H_BY, DDSKTX__BC6H_BZ
+};
+
+typedef struct ddsktx__bc6h_mode
+{
+    uint8_t mode_bits;          // value of the first 2 or 5 bits
+    uint8_t transformed;        // endpoints x, y, z are deltas from w
+    uint8_t num_regions;
+    uint8_t endpoint_bits;
+    uint8_t delta_bits[3];
+} ddsktx__bc6h_mode;
+
+// one run of bits in the block: 'count' bits goes to 'field' starting at bit 'shift' of the field
+typedef struct ddsktx__bc6h_run
+{
+    uint8_t field;
+    uint8_t shift;
+    uint8_t count;              // 0: end of layout
+} ddsktx__bc6h_run;
+
+static const ddsktx__bc6h_mode k__bc6h_modes[14] = {
+    { 0x00, 1, 2, 10, { 5, 5, 5 } },
+    { 0x01, 1, 2,  7, { 6, 6, 6 } },
+    { 0x02, 1, 2, 11, { 5, 4, 4 } },
+    { 0x06, 1, 2, 11, { 4, 5, 4 } },
+    { 0x0a, 1, 2, 11, { 4, 4, 5 } },
+    { 0x0e, 1, 2,  9, { 5, 5, 5 } },
+    { 0x12, 1, 2,  8, { 6, 5, 5 } },
+    { 0x16, 1, 2,  8, { 5, 6, 5 } },
+    { 0x1a, 1, 2,  8, { 5, 5, 6 } },
+    { 0x1e, 0, 2,  6, { 6, 6, 6 } },
+    { 0x03, 0, 1, 10, { 10, 10, 10 } },
+    { 0x07, 1, 1, 11, { 9, 9, 9 } },
+    { 0x0b, 1, 1, 12, { 8, 8, 8 } },
+    { 0x0f, 1, 1, 16, { 4, 4, 4 } }
+};
+
+#define DDSKTX__R(_e, _shift, _count)     { DDSKTX__BC6H_R##_e, _shift, _count }
+#define DDSKTX__G(_e, _shift, _count)     { DDSKTX__BC6H_G##_e, _shift, _count }
+#define DDSKTX__B(_e, _shift, _count)     { DDSKTX__BC6H_B##_e, _shift, _count }
+#define DDSKTX__WWW(_bits)                DDSKTX__R(W, 0, _bits), DDSKTX__G(W, 0, _bits), DDSKTX__B(W, 0, _bits)
+
+// bit layout of each mode after the mode bits, up to partition bits (2 regions) or indices (1 region)
+static const ddsktx__bc6h_run k__bc6h_layout[14][25] = {
+    {   // mode 0
+        DDSKTX__G(Y, 4, 1), DDSKTX__B(Y, 4, 1), DDSKTX__B(Z, 4, 1), DDSKTX__WWW(10),
+        DDSKTX__R(X, 0, 5), DDSKTX__G(Z, 4, 1), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 5), DDSKTX__B(Z, 0, 1),
+        DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 5), DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 5),
+        DDSKTX__B(Z, 2, 1), DDSKTX__R(Z, 0, 5), DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 1
+        DDSKTX__G(Y, 5, 1), DDSKTX__G(Z, 4, 1), DDSKTX__G(Z, 5, 1), DDSKTX__R(W, 0, 7), DDSKTX__B(Z, 0, 1),
+        DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 4, 1), DDSKTX__G(W, 0, 7), DDSKTX__B(Y, 5, 1), DDSKTX__B(Z, 2, 1),
+        DDSKTX__G(Y, 4, 1), DDSKTX__B(W, 0, 7), DDSKTX__B(Z, 3, 1), DDSKTX__B(Z, 5, 1), DDSKTX__B(Z, 4, 1),
+        DDSKTX__R(X, 0, 6), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 6), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 6),
+        DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 6), DDSKTX__R(Z, 0, 6)
+    },
+    {   // mode 2
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 5), DDSKTX__R(W, 10, 1), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 4),
+        DDSKTX__G(W, 10, 1), DDSKTX__B(Z, 0, 1), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 4), DDSKTX__B(W, 10, 1),
+        DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 5), DDSKTX__B(Z, 2, 1), DDSKTX__R(Z, 0, 5),
+        DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 3
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 4), DDSKTX__R(W, 10, 1), DDSKTX__G(Z, 4, 1), DDSKTX__G(Y, 0, 4),
+        DDSKTX__G(X, 0, 5), DDSKTX__G(W, 10, 1), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 4), DDSKTX__B(W, 10, 1),
+        DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 4), DDSKTX__B(Z, 0, 1), DDSKTX__B(Z, 2, 1),
+        DDSKTX__R(Z, 0, 4), DDSKTX__G(Y, 4, 1), DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 4
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 4), DDSKTX__R(W, 10, 1), DDSKTX__B(Y, 4, 1), DDSKTX__G(Y, 0, 4),
+        DDSKTX__G(X, 0, 4), DDSKTX__G(W, 10, 1), DDSKTX__B(Z, 0, 1), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 5),
+        DDSKTX__B(W, 10, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 4), DDSKTX__B(Z, 1, 1), DDSKTX__B(Z, 2, 1),
+        DDSKTX__R(Z, 0, 4), DDSKTX__B(Z, 4, 1), DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 5
+        DDSKTX__R(W, 0, 9), DDSKTX__B(Y, 4, 1), DDSKTX__G(W, 0, 9), DDSKTX__G(Y, 4, 1), DDSKTX__B(W, 0, 9),
+        DDSKTX__B(Z, 4, 1), DDSKTX__R(X, 0, 5), DDSKTX__G(Z, 4, 1), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 5),
+        DDSKTX__B(Z, 0, 1), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 5), DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4),
+        DDSKTX__R(Y, 0, 5), DDSKTX__B(Z, 2, 1), DDSKTX__R(Z, 0, 5), DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 6
+        DDSKTX__R(W, 0, 8), DDSKTX__G(Z, 4, 1), DDSKTX__B(Y, 4, 1), DDSKTX__G(W, 0, 8), DDSKTX__B(Z, 2, 1),
+        DDSKTX__G(Y, 4, 1), DDSKTX__B(W, 0, 8), DDSKTX__B(Z, 3, 1), DDSKTX__B(Z, 4, 1), DDSKTX__R(X, 0, 6),
+        DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 5), DDSKTX__B(Z, 0, 1), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 5),
+        DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 6), DDSKTX__R(Z, 0, 6)
+    },
+    {   // mode 7
+        DDSKTX__R(W, 0, 8), DDSKTX__B(Z, 0, 1), DDSKTX__B(Y, 4, 1), DDSKTX__G(W, 0, 8), DDSKTX__G(Y, 5, 1),
+        DDSKTX__G(Y, 4, 1), DDSKTX__B(W, 0, 8), DDSKTX__G(Z, 5, 1), DDSKTX__B(Z, 4, 1), DDSKTX__R(X, 0, 5),
+        DDSKTX__G(Z, 4, 1), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 6), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 5),
+        DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 5), DDSKTX__B(Z, 2, 1), DDSKTX__R(Z, 0, 5),
+        DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 8
+        DDSKTX__R(W, 0, 8), DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 4, 1), DDSKTX__G(W, 0, 8), DDSKTX__B(Y, 5, 1),
+        DDSKTX__G(Y, 4, 1), DDSKTX__B(W, 0, 8), DDSKTX__B(Z, 5, 1), DDSKTX__B(Z, 4, 1), DDSKTX__R(X, 0, 5),
+        DDSKTX__G(Z, 4, 1), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 5), DDSKTX__B(Z, 0, 1), DDSKTX__G(Z, 0, 4),
+        DDSKTX__B(X, 0, 6), DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 5), DDSKTX__B(Z, 2, 1), DDSKTX__R(Z, 0, 5),
+        DDSKTX__B(Z, 3, 1)
+    },
+    {   // mode 9
+        DDSKTX__R(W, 0, 6), DDSKTX__G(Z, 4, 1), DDSKTX__B(Z, 0, 1), DDSKTX__B(Z, 1, 1), DDSKTX__B(Y, 4, 1),
+        DDSKTX__G(W, 0, 6), DDSKTX__G(Y, 5, 1), DDSKTX__B(Y, 5, 1), DDSKTX__B(Z, 2, 1), DDSKTX__G(Y, 4, 1),
+        DDSKTX__B(W, 0, 6), DDSKTX__G(Z, 5, 1), DDSKTX__B(Z, 3, 1), DDSKTX__B(Z, 5, 1), DDSKTX__B(Z, 4, 1),
+        DDSKTX__R(X, 0, 6), DDSKTX__G(Y, 0, 4), DDSKTX__G(X, 0, 6), DDSKTX__G(Z, 0, 4), DDSKTX__B(X, 0, 6),
+        DDSKTX__B(Y, 0, 4), DDSKTX__R(Y, 0, 6), DDSKTX__R(Z, 0, 6)
+    },
+    {   // mode 10
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 10), DDSKTX__G(X, 0, 10), DDSKTX__B(X, 0, 10)
+    },
+    {   // mode 11
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 9), DDSKTX__R(W, 10, 1), DDSKTX__G(X, 0, 9), DDSKTX__G(W, 10, 1),
+        DDSKTX__B(X, 0, 9), DDSKTX__B(W, 10, 1)
+    },
+    {   // mode 12
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 8), DDSKTX__R(W, 11, 1), DDSKTX__R(W, 10, 1), DDSKTX__G(X, 0, 8),
+        DDSKTX__G(W, 11, 1), DDSKTX__G(W, 10, 1), DDSKTX__B(X, 0, 8), DDSKTX__B(W, 11, 1), DDSKTX__B(W, 10, 1)
+    },
+    {   // mode 13: high bits of 'w' are stored in reverse order
+        DDSKTX__WWW(10), DDSKTX__R(X, 0, 4),
+        DDSKTX__R(W, 15, 1), DDSKTX__R(W, 14, 1), DDSKTX__R(W, 13, 1), DDSKTX__R(W, 12, 1), DDSKTX__R(W, 11, 1),
+        DDSKTX__R(W, 10, 1), DDSKTX__G(X, 0, 4),
+        DDSKTX__G(W, 15, 1), DDSKTX__G(W, 14, 1), DDSKTX__G(W, 13, 1), DDSKTX__G(W, 12, 1), DDSKTX__G(W, 11, 1),
+        DDSKTX__G(W, 10, 1), DDSKTX__B(X, 0, 4),
+        DDSKTX__B(W, 15, 1), DDSKTX__B(W, 14, 1), DDSKTX__B(W, 13, 1), DDSKTX__B(W, 12, 1), DDSKTX__B(W, 11, 1),
+        DDSKTX__B(W, 10, 1)
+    }
+};
+
+#undef DDSKTX__R
+#undef DDSKTX__G
+#undef DDSKTX__B
+#undef DDSKTX__WWW
+
+static inline int ddsktx__bc6h_unquantize(int v, int bits, bool is_signed)
+{
+    if (!is_signed) {
+        if (bits >= 15 || v == 0)
+            return v;
+        if (v == (1 << bits) - 1)
+            return 0xffff;
+        return ((v << 16) + 0x8000) >> bits;
+    } else {
+        if (bits >= 16)
+            return v;
+        bool neg = v < 0;
+        int r;
+        v = neg ? -v : v;
+        if (v == 0)
+            r = 0;
+        else if (v >= (1 << (bits - 1)) - 1)
+            r = 0x7fff;
+        else
+            r = ((v << 15) + 0x4000) >> (bits - 1);
+        return neg ? -r : r;
+    }
+}
+
+// scales interpolated value to half-float range, and returns the half-float bits
+static inline uint16_t ddsktx__bc6h_finish(int v, bool is_signed)
+{
+    if (!is_signed)
+        return (uint16_t)((v * 31) >> 6);
+    return v < 0 ? (uint16_t)(0x8000 | (((-v) * 31) >> 5)) : (uint16_t)((v * 31) >> 5);
+}
+
+static void ddsktx__decode_bc6h(const uint8_t* block, uint16_t* rgba, bool is_signed)
+{
+    ddsktx__bits bits;
+    ddsktx__bits_init(&bits, block);
+
+    int mode_bits = ddsktx__bits_read(&bits, 2);
+    if (mode_bits > 1) {
+        mode_bits |= ddsktx__bits_read(&bits, 3) << 2;
+    }
+
+    int mode = -1;
+    for (int i = 0; i < 14; i++) {
+        if (k__bc6h_modes[i].mode_bits == mode_bits) {
+            mode = i;
+            break;
+        }
+    }
+    if (mode == -1) {
+        // reserved mode: decodes to black
+        for (int i = 0; i < 16; i++) {
+            rgba[i*4] = rgba[i*4 + 1] = rgba[i*4 + 2] = 0;
+            rgba[i*4 + 3] = 0x3c00;
+        }
+        return;
+    }
+
+    const ddsktx__bc6h_mode* m = &k__bc6h_modes[mode];
+    int fields[12] = {0};
+    for (const ddsktx__bc6h_run* run = k__bc6h_layout[mode]; run->count; run++) {
+        fields[run->field] |= ddsktx__bits_read(&bits, run->count) << run->shift;
+    }
+    int partition = m->num_regions == 2 ? ddsktx__bits_read(&bits, 5) : 0;
+
+    // endpoints: [region*2 + n][channel]
+    int endpoints[4][3];
+    int num_endpoints = m->num_regions*2;
+    int endpoint_mask = (1 << m->endpoint_bits) - 1;
+    for (int c = 0; c < 3; c++) {
+        int w = fields[c*4];
+        endpoints[0][c] = is_signed ? ddsktx__sign_extend(w, m->endpoint_bits) : w;
+        for (int e = 1; e < num_endpoints; e++) {
+            int v = fields[c*4 + e];
+            if (m->transformed) {
+                v = (w + ddsktx__sign_extend(v, m->delta_bits[c])) & endpoint_mask;
+            }
+            endpoints[e][c] = is_signed ? ddsktx__sign_extend(v, m->endpoint_bits) : v;
+        }
+        for (int e = 0; e < num_endpoints; e++) {
+            endpoints[e][c] = ddsktx__bc6h_unquantize(endpoints[e][c], m->endpoint_bits, is_signed);
+        }
+    }
+
+    int index_bits = m->num_regions == 2 ? 3 : 4;
+    int anchor = m->num_regions == 2 ? k__bc_anchor2[partition] : 0;
+    for (int i = 0; i < 16; i++) {
+        int region = m->num_regions == 2 ? ((k__bc_partition2[partition] >> i) & 1) : 0;
+        int index = ddsktx__bits_read(&bits, index_bits - ((i == 0 || i == anchor) ? 1 : 0));
+        const int* e0 = endpoints[region*2];
+        const int* e1 = endpoints[region*2 + 1];
+        for (int c = 0; c < 3; c++) {
+            rgba[i*4 + c] = ddsktx__bc6h_finish(ddsktx__bc_interp(e0[c], e1[c], index, index_bits), is_signed);
+        }
+        rgba[i*4 + 3] = 0x3c00;     // 1.0
+    }
+}
+
+// ETC1/ETC2/EAC block decoding: https://www.khronos.org/registry/DataFormat/specs/1.3/dataformat.1.3.html#ETC2
+// blocks are stored big-endian, pixel indices are in column-major order
+static const uint8_t k__etc_modifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+static const uint8_t k__etc_distances[8] = { 3, 6, 11, 16, 20, 23, 27, 32 };
+
+static const int8_t k__eac_modifiers[16][8] = {
+    { -3, -6,  -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 },
+    { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 },
+    { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 },
+    { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 },
+    { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 },
+    { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 },
+    { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+    { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+static inline uint8_t ddsktx__clamp8(int v)
+{
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static inline uint64_t ddsktx__load_be64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static inline int ddsktx__etc_bits(uint64_t v, int lsb, int count)
+{
+    return (int)(v >> lsb) & ((1 << count) - 1);
+}
+
+// T and H modes: every pixel index selects one of the 4 'paint' colors
+static void ddsktx__decode_etc2_paint(uint64_t v, int paint[4][3], uint8_t* rgba, bool opaque)
+{
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int i = x*4 + y;
+            int idx = (ddsktx__etc_bits(v, 16 + i, 1) << 1) | ddsktx__etc_bits(v, i, 1);
+            uint8_t* p = rgba + (y*4 + x)*4;
+            if (!opaque && idx == 2) {
+                p[0] = p[1] = p[2] = p[3] = 0;
+            } else {
+                p[0] = ddsktx__clamp8(paint[idx][0]);
+                p[1] = ddsktx__clamp8(paint[idx][1]);
+                p[2] = ddsktx__clamp8(paint[idx][2]);
+                p[3] = 255;
+            }
+        }
+    }
+}
+
+static void ddsktx__decode_etc2_t(uint64_t v, uint8_t* rgba, bool opaque)
+{
+    int c1[3] = {
+        ((ddsktx__etc_bits(v, 59, 2) << 2) | ddsktx__etc_bits(v, 56, 2)) * 17,
+        ddsktx__etc_bits(v, 52, 4) * 17,
+        ddsktx__etc_bits(v, 48, 4) * 17
+    };
+    int c2[3] = { ddsktx__etc_bits(v, 44, 4) * 17, ddsktx__etc_bits(v, 40, 4) * 17, ddsktx__etc_bits(v, 36, 4) * 17 };
+    int d = k__etc_distances[(ddsktx__etc_bits(v, 34, 2) << 1) | ddsktx__etc_bits(v, 32, 1)];
+
+    int paint[4][3];
+    for (int c = 0; c < 3; c++) {
+        paint[0][c] = c1[c];
+        paint[1][c] = c2[c] + d;
+        paint[2][c] = c2[c];
+        paint[3][c] = c2[c] - d;
+    }
+    ddsktx__decode_etc2_paint(v, paint, rgba, opaque);
+}
+
+static void ddsktx__decode_etc2_h(uint64_t v, uint8_t* rgba, bool opaque)
+{
+    int c1[3] = {
+        ddsktx__etc_bits(v, 59, 4),
+        (ddsktx__etc_bits(v, 56, 3) << 1) | ddsktx__etc_bits(v, 52, 1),
+        (ddsktx__etc_bits(v, 51, 1) << 3) | ddsktx__etc_bits(v, 47, 3)
+    };
+    int c2[3] = { ddsktx__etc_bits(v, 43, 4), ddsktx__etc_bits(v, 39, 4), ddsktx__etc_bits(v, 35, 4) };
+
+    // lowest bit of the distance index is implicit in the order of the base colors
+    int order = ((c1[0] << 8) | (c1[1] << 4) | c1[2]) >= ((c2[0] << 8) | (c2[1] << 4) | c2[2]) ? 1 : 0;
+    int d = k__etc_distances[(ddsktx__etc_bits(v, 34, 1) << 2) | (ddsktx__etc_bits(v, 32, 1) << 1) | order];
+
+    int paint[4][3];
+    for (int c = 0; c < 3; c++) {
+        paint[0][c] = c1[c]*17 + d;
+        paint[1][c] = c1[c]*17 - d;
+        paint[2][c] = c2[c]*17 + d;
+        paint[3][c] = c2[c]*17 - d;
+    }
+    ddsktx__decode_etc2_paint(v, paint, rgba, opaque);
+}
+
+static void ddsktx__decode_etc2_planar(uint64_t v, uint8_t* rgba)
+{
+    int ro = ddsktx__etc_bits(v, 57, 6);
+    int go = (ddsktx__etc_bits(v, 56, 1) << 6) | ddsktx__etc_bits(v, 49, 6);
+    int bo = (ddsktx__etc_bits(v, 48, 1) << 5) | (ddsktx__etc_bits(v, 43, 2) << 3) | ddsktx__etc_bits(v, 39, 3);
+    int rh = (ddsktx__etc_bits(v, 34, 5) << 1) | ddsktx__etc_bits(v, 32, 1);
+    int gh = ddsktx__etc_bits(v, 25, 7);
+    int bh = ddsktx__etc_bits(v, 19, 6);
+    int rv = ddsktx__etc_bits(v, 13, 6);
+    int gv = ddsktx__etc_bits(v, 6, 7);
+    int bv = ddsktx__etc_bits(v, 0, 6);
+
+    int o[3] = { (ro << 2) | (ro >> 4), (go << 1) | (go >> 6), (bo << 2) | (bo >> 4) };
+    int h[3] = { (rh << 2) | (rh >> 4), (gh << 1) | (gh >> 6), (bh << 2) | (bh >> 4) };
+    int vv[3] = { (rv << 2) | (rv >> 4), (gv << 1) | (gv >> 6), (bv << 2) | (bv >> 4) };
+
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            uint8_t* p = rgba + (y*4 + x)*4;
+            for (int c = 0; c < 3; c++) {
+                p[c] = ddsktx__clamp8((x*(h[c] - o[c]) + y*(vv[c] - o[c]) + 4*o[c] + 2) >> 2);
+            }
+            p[3] = 255;
+        }
+    }
+}
+
+// ETC1 and ETC2 RGB, 'punchthrough' is for ETC2 RGB8A1, where the 'diff' bit is the 'opaque' bit instead
+static void ddsktx__decode_etc_color(const uint8_t* block, uint8_t* rgba, bool etc2, bool punchthrough)
+{
+    uint64_t v = ddsktx__load_be64(block);
+    bool diff = punchthrough || ddsktx__etc_bits(v, 33, 1);
+    bool opaque = !punchthrough || ddsktx__etc_bits(v, 33, 1);
+
+    int base[2][3];
+    if (!diff) {
+        for (int c = 0; c < 3; c++) {
+            base[0][c] = ddsktx__etc_bits(v, 60 - c*8, 4) * 17;
+            base[1][c] = ddsktx__etc_bits(v, 56 - c*8, 4) * 17;
+        }
+    } else {
+        int c1[3];
+        int c2[3];
+        for (int c = 0; c < 3; c++) {
+            c1[c] = ddsktx__etc_bits(v, 59 - c*8, 5);
+            c2[c] = c1[c] + ddsktx__sign_extend(ddsktx__etc_bits(v, 56 - c*8, 3), 3);
+        }
+
+        // ETC2 modes are signaled by overflow of the second base color
+        if (etc2) {
+            if (c2[0] < 0 || c2[0] > 31) {
+                ddsktx__decode_etc2_t(v, rgba, opaque);
+                return;
+            } else if (c2[1] < 0 || c2[1] > 31) {
+                ddsktx__decode_etc2_h(v, rgba, opaque);
+                return;
+            } else if (c2[2] < 0 || c2[2] > 31) {
+                ddsktx__decode_etc2_planar(v, rgba);
+                return;
+            }
+        }
+
+        for (int c = 0; c < 3; c++) {
+            base[0][c] = (c1[c] << 3) | (c1[c] >> 2);
+            base[1][c] = ((c2[c] & 0x1f) << 3) | ((c2[c] & 0x1f) >> 2);
+        }
+    }
+
+    int tables[2] = { ddsktx__etc_bits(v, 37, 3), ddsktx__etc_bits(v, 34, 3) };
+    bool flip = ddsktx__etc_bits(v, 32, 1) != 0;
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int i = x*4 + y;
+            int sub = flip ? (y >= 2) : (x >= 2);
+            int idx = (ddsktx__etc_bits(v, 16 + i, 1) << 1) | ddsktx__etc_bits(v, i, 1);
+            uint8_t* p = rgba + (y*4 + x)*4;
+
+            int m = k__etc_modifiers[tables[sub]][idx & 1];
+            m = (idx & 2) ? -m : m;
+            if (!opaque) {
+                // punch-through: index 2 is transparent and index 0 is the base color
+                if (idx == 2) {
+                    p[0] = p[1] = p[2] = p[3] = 0;
+                    continue;
+                }
+                m = idx == 0 ? 0 : m;
+            }
+
+            p[0] = ddsktx__clamp8(base[sub][0] + m);
+            p[1] = ddsktx__clamp8(base[sub][1] + m);
+            p[2] = ddsktx__clamp8(base[sub][2] + m);
+            p[3] = 255;
+        }
+    }
+}
+
+static void ddsktx__decode_eac_alpha(const uint8_t* block, uint8_t* rgba)
+{
+    uint64_t v = ddsktx__load_be64(block);
+    int base = ddsktx__etc_bits(v, 56, 8);
+    int mult = ddsktx__etc_bits(v, 52, 4);
+    const int8_t* modifiers = k__eac_modifiers[ddsktx__etc_bits(v, 48, 4)];
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int idx = ddsktx__etc_bits(v, 45 - (x*4 + y)*3, 3);
+            rgba[(y*4 + x)*4 + 3] = ddsktx__clamp8(base + modifiers[idx]*mult);
+        }
+    }
+}
+
+// ASTC LDR block decoding: https://www.khronos.org/registry/DataFormat/specs/1.3/dataformat.1.3.html#ASTC
+// 2D blocks of the LDR profile: HDR endpoint modes, HDR void-extent blocks and invalid encodings decode to the
+// error color (magenta). Colors are interpolated at 16 bits and the top 8 bits are kept for sRGB
+#define DDSKTX__ASTC_MAX_WEIGHTS 64
+#define DDSKTX__ASTC_MAX_TEXELS  (12*12)
+
+typedef struct ddsktx__astc_quant
+{
+    uint8_t trits;
+    uint8_t quints;
+    uint8_t bits;
+} ddsktx__astc_quant;
+
+// integer sequence encoding of the quantization levels: 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 64, 80,
+// 96, 128, 160, 192, 256. Weights use the first 12, colors use 6 levels and up
+static const ddsktx__astc_quant k__astc_quants[21] = {
+    { 0, 0, 1 }, { 1, 0, 0 }, { 0, 0, 2 }, { 0, 1, 0 }, { 1, 0, 1 }, { 0, 0, 3 }, { 0, 1, 1 },
+    { 1, 0, 2 }, { 0, 0, 4 }, { 0, 1, 2 }, { 1, 0, 3 }, { 0, 0, 5 }, { 0, 1, 3 }, { 1, 0, 4 },
+    { 0, 0, 6 }, { 0, 1, 4 }, { 1, 0, 5 }, { 0, 0, 7 }, { 0, 1, 5 }, { 1, 0, 6 }, { 0, 0, 8 }
+};
+
+#define DDSKTX__ASTC_QUANT_6 4
+
+typedef struct ddsktx__astc_block
+{
+    int     weights_x;
+    int     weights_y;
+    int     weight_quant;
+    bool    dual_plane;
+} ddsktx__astc_block;
+
+// bits [lsb, lsb+count) of the block, zero past 'end'
+static inline int ddsktx__astc_bits(const ddsktx__bits* b, int lsb, int count, int end)
+{
+    count = ddsktx__min(count, end - lsb);
+    if (count <= 0) {
+        return 0;
+    }
+    uint64_t v = lsb >= 64 ? b->hi >> (lsb - 64) : 
+                 ((b->lo >> lsb) | (lsb > 0 ? b->hi << (64 - lsb) : 0));
+    return (int)(v & ((1u << count) - 1));
+}
+
+static inline uint64_t ddsktx__reverse64(uint64_t v)
+{
+    v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+    v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+    v = ((v >> 4) & 0x0f0f0f0f0f0f0f0full) | ((v & 0x0f0f0f0f0f0f0f0full) << 4);
+    v = ((v >> 8) & 0x00ff00ff00ff00ffull) | ((v & 0x00ff00ff00ff00ffull) << 8);
+    v = ((v >> 16) & 0x0000ffff0000ffffull) | ((v & 0x0000ffff0000ffffull) << 16);
+    return (v >> 32) | (v << 32);
+}
+
+// replicates a 'bits' wide value to 'to' bits
+static inline int ddsktx__astc_replicate(int v, int bits, int to)
+{
+    int r = v << (to - bits);
+    for (int shift = to - 2*bits; shift > -bits; shift -= bits) {
+        r |= shift >= 0 ? v << shift : v >> -shift;
+    }
+    return r;
+}
+
+static inline int ddsktx__astc_ise_bits(int quant, int count)
+{
+    const ddsktx__astc_quant* q = &k__astc_quants[quant];
+    return count*q->bits + (q->trits ? (count*8 + 4)/5 : 0) + (q->quints ? (count*7 + 2)/3 : 0);
+}
+
+// decodes 'count' values of an integer sequence that starts at 'lsb', into trit/quint values and low bits
+static void ddsktx__astc_decode_ise(const ddsktx__bits* b, int lsb, int end, int quant, int count, 
+                                    uint8_t* tq, uint8_t* low)
+{
+    const ddsktx__astc_quant* q = &k__astc_quants[quant];
+    int nb = q->bits;
+    int pos = lsb;
+    if (q->trits) {
+        for (int i = 0; i < count; i += 5) {
+            static const uint8_t k_tbits[5] = { 2, 2, 1, 2, 1 };
+            int m[5];
+            int t = 0;
+            int tpos = 0;
+            for (int k = 0; k < 5; k++) {
+                m[k] = ddsktx__astc_bits(b, pos, nb, end);
+                pos += nb;
+                t |= ddsktx__astc_bits(b, pos, k_tbits[k], end) << tpos;
+                pos += k_tbits[k];
+                tpos += k_tbits[k];
+            }
+
+            int c, t0, t1, t2, t3, t4;
+            if (((t >> 2) & 7) == 7) {
+                c = ((t >> 3) & 0x1c) | (t & 3);
+                t4 = t3 = 2;
+            } else {
+                c = t & 0x1f;
+                if (((t >> 5) & 3) == 3) {
+                    t4 = 2;
+                    t3 = (t >> 7) & 1;
+                } else {
+                    t4 = (t >> 7) & 1;
+                    t3 = (t >> 5) & 3;
+                }
+            }
+            if ((c & 3) == 3) {
+                t2 = 2;
+                t1 = (c >> 4) & 1;
+                t0 = (((c >> 3) & 1) << 1) | (((c >> 2) & 1) & ~((c >> 3) & 1));
+            } else if (((c >> 2) & 3) == 3) {
+                t2 = 2;
+                t1 = 2;
+                t0 = c & 3;
+            } else {
+                t2 = (c >> 4) & 1;
+                t1 = (c >> 2) & 3;
+                t0 = (((c >> 1) & 1) << 1) | ((c & 1) & ~((c >> 1) & 1));
+            }
+
+            int trits[5] = { t0, t1, t2, t3, t4 };
+            for (int k = 0; k < 5 && i + k < count; k++) {
+                tq[i + k] = (uint8_t)trits[k];
+                low[i + k] = (uint8_t)m[k];
+            }
+        }
+    } else if (q->quints) {
+        for (int i = 0; i < count; i += 3) {
+            static const uint8_t k_qbits[3] = { 3, 2, 2 };
+            int m[3];
+            int v = 0;
+            int qpos = 0;
+            for (int k = 0; k < 3; k++) {
+                m[k] = ddsktx__astc_bits(b, pos, nb, end);
+                pos += nb;
+                v |= ddsktx__astc_bits(b, pos, k_qbits[k], end) << qpos;
+                pos += k_qbits[k];
+                qpos += k_qbits[k];
+            }
+
+            int q0, q1, q2;
+            if (((v >> 1) & 3) == 3 && ((v >> 5) & 3) == 0) {
+                int q0b = v & 1;
+                q2 = (q0b << 2) | ((((v >> 4) & 1) & ~q0b) << 1) | (((v >> 3) & 1) & ~q0b);
+                q1 = q0 = 4;
+            } else {
+                int c;
+                if (((v >> 1) & 3) == 3) {
+                    q2 = 4;
+                    c = (((v >> 3) & 3) << 3) | ((~(v >> 5) & 3) << 1) | (v & 1);
+                } else {
+                    q2 = (v >> 5) & 3;
+                    c = v & 0x1f;
+                }
+                if ((c & 7) == 5) {
+                    q1 = 4;
+                    q0 = (c >> 3) & 3;
+                } else {
+                    q1 = (c >> 3) & 3;
+                    q0 = c & 7;
+                }
+            }
+
+            int quints[3] = { q0, q1, q2 };
+            for (int k = 0; k < 3 && i + k < count; k++) {
+                tq[i + k] = (uint8_t)quints[k];
+                low[i + k] = (uint8_t)m[k];
+            }
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            tq[i] = 0;
+            low[i] = (uint8_t)ddsktx__astc_bits(b, pos, nb, end);
+            pos += nb;
+        }
+    }
+}
+
+// color values to [0, 255], 'm' is the low bits and 'd' the trit/quint value
+static int ddsktx__astc_unquant_color(int quant, int d, int m)
+{
+    const ddsktx__astc_quant* q = &k__astc_quants[quant];
+    if (!q->trits && !q->quints) {
+        return ddsktx__astc_replicate(m, q->bits, 8);
+    }
+
+    int a = (m & 1) ? 0x1ff : 0;
+    int b = (m >> 1) & 1, c = (m >> 2) & 1, e = (m >> 3) & 1, f = (m >> 4) & 1, g = (m >> 5) & 1;
+    int bb = 0, cc = 0;
+    if (q->trits) {
+        switch (q->bits) {
+        case 1: bb = 0;                                             cc = 204; break;
+        case 2: bb = b*0x116;                                       cc = 93;  break;
+        case 3: bb = c*0x10a + b*0x85;                              cc = 44;  break;
+        case 4: bb = e*0x104 + c*0x82 + b*0x41;                     cc = 22;  break;
+        case 5: bb = f*0x102 + e*0x81 + c*0x40 + b*0x20;            cc = 11;  break;
+        case 6: bb = g*0x101 + f*0x80 + e*0x40 + c*0x20 + b*0x10;   cc = 5;   break;
+        }
+    } else {
+        switch (q->bits) {
+        case 1: bb = 0;                                             cc = 113; break;
+        case 2: bb = b*0x10c;                                       cc = 54;  break;
+        case 3: bb = c*0x105 + b*0x82;                              cc = 26;  break;
+        case 4: bb = e*0x102 + c*0x81 + b*0x40;                     cc = 13;  break;
+        case 5: bb = f*0x101 + e*0x80 + c*0x40 + b*0x20;            cc = 6;   break;
+        }
+    }
+    int t = (d*cc + bb) ^ a;
+    return (a & 0x80) | (t >> 2);
+}
+
+// weights to [0, 64]
+static int ddsktx__astc_unquant_weight(int quant, int d, int m)
+{
+    const ddsktx__astc_quant* q = &k__astc_quants[quant];
+    int t;
+    if (!q->trits && !q->quints) {
+        t = ddsktx__astc_replicate(m, q->bits, 6);
+    } else if (q->bits == 0) {
+        static const uint8_t k_trits[3] = { 0, 32, 63 };
+        static const uint8_t k_quints[5] = { 0, 16, 32, 47, 63 };
+        t = q->trits ? k_trits[d] : k_quints[d];
+    } else {
+        int a = (m & 1) ? 0x7f : 0;
+        int b = (m >> 1) & 1, c = (m >> 2) & 1;
+        int bb = 0, cc = 0;
+        if (q->trits) {
+            switch (q->bits) {
+            case 1: bb = 0;                 cc = 50; break;
+            case 2: bb = b*0x45;            cc = 23; break;
+            case 3: bb = c*0x42 + b*0x21;   cc = 11; break;
+            }
+        } else {
+            switch (q->bits) {
+            case 1: bb = 0;                 cc = 28; break;
+            case 2: bb = b*0x42;            cc = 13; break;
+            }
+        }
+        t = (d*cc + bb) ^ a;
+        t = (a & 0x20) | (t >> 2);
+    }
+    return t > 32 ? t + 1 : t;
+}
+
+static bool ddsktx__astc_block_mode(int mode, ddsktx__astc_block* bm)
+{
+    int r = (mode >> 4) & 1;
+    int h = (mode >> 9) & 1;
+    int d = (mode >> 10) & 1;
+    int a = (mode >> 5) & 3;
+    int x, y;
+
+    if (mode & 3) {
+        r |= (mode & 3) << 1;
+        int b = (mode >> 7) & 3;
+        switch ((mode >> 2) & 3) {
+        case 0:     x = b + 4;  y = a + 2;  break;
+        case 1:     x = b + 8;  y = a + 2;  break;
+        case 2:     x = a + 2;  y = b + 8;  break;
+        default:
+            b &= 1;
+            if (mode & 0x100) {
+                x = b + 2;
+                y = a + 2;
+            } else {
+                x = a + 2;
+                y = b + 6;
+            }
+            break;
+        }
+    } else {
+        r |= ((mode >> 2) & 3) << 1;
+        if (((mode >> 2) & 3) == 0) {
+            return false;
+        }
+        int b = (mode >> 9) & 3;
+        switch ((mode >> 7) & 3) {
+        case 0:     x = 12;     y = a + 2;  break;
+        case 1:     x = a + 2;  y = 12;     break;
+        case 2:     x = a + 6;  y = b + 6;  d = 0;  h = 0;  break;
+        default:
+            if (((mode >> 5) & 3) == 0) {
+                x = 6;
+                y = 10;
+            } else if (((mode >> 5) & 3) == 1) {
+                x = 10;
+                y = 6;
+            } else {
+                return false;
+            }
+            break;
+        }
+    }
+
+    bm->weights_x = x;
+    bm->weights_y = y;
+    bm->weight_quant = r - 2 + h*6;
+    bm->dual_plane = d != 0;
+    return true;
+}
+
+static uint32_t ddsktx__astc_hash52(uint32_t v)
+{
+    v ^= v >> 15;
+    v *= 0xeede0891;
+    v ^= v >> 5;
+    v += v << 16;
+    v ^= v >> 7;
+    v ^= v >> 3;
+    v ^= v << 6;
+    v ^= v >> 17;
+    return v;
+}
+
+static int ddsktx__astc_partition(int seed, int x, int y, int num_partitions, bool small_block)
+{
+    if (small_block) {
+        x <<= 1;
+        y <<= 1;
+    }
+    seed += (num_partitions - 1) * 1024;
+    uint32_t rnum = ddsktx__astc_hash52((uint32_t)seed);
+    uint8_t s[8];
+    for (int i = 0; i < 8; i++) {
+        s[i] = (uint8_t)((rnum >> (i*4)) & 0xf);
+        s[i] = (uint8_t)(s[i]*s[i]);
+    }
+
+    int sh1, sh2;
+    if (seed & 1) {
+        sh1 = (seed & 2) ? 4 : 5;
+        sh2 = num_partitions == 3 ? 6 : 5;
+    } else {
+        sh1 = num_partitions == 3 ? 6 : 5;
+        sh2 = (seed & 2) ? 4 : 5;
+    }
+    for (int i = 0; i < 8; i++) {
+        s[i] >>= (i & 1) ? sh2 : sh1;
+    }
+
+    // z is always zero for 2D blocks, so seeds 9-12 drop out
+    int a = (s[0]*x + s[1]*y + (int)(rnum >> 14)) & 0x3f;
+    int b = (s[2]*x + s[3]*y + (int)(rnum >> 10)) & 0x3f;
+    int c = (s[4]*x + s[5]*y + (int)(rnum >> 6)) & 0x3f;
+    int d = (s[6]*x + s[7]*y + (int)(rnum >> 2)) & 0x3f;
+    d = num_partitions < 4 ? 0 : d;
+    c = num_partitions < 3 ? 0 : c;
+
+    if (a >= b && a >= c && a >= d) 
+        return 0;
+    else if (b >= c && b >= d) 
+        return 1;
+    else if (c >= d) 
+        return 2;
+    else 
+        return 3;
+}
+
+static inline void ddsktx__astc_bit_transfer(int* a, int* b)
+{
+    *b = (*b >> 1) | (*a & 0x80);
+    *a = (*a >> 1) & 0x3f;
+    *a = (*a & 0x20) ? *a - 0x40 : *a;
+}
+
+static inline void ddsktx__astc_rgba(int* e, int r, int g, int b, int a)
+{
+    e[0] = r;
+    e[1] = g;
+    e[2] = b;
+    e[3] = a;
+}
+
+static inline void ddsktx__astc_blue_contract(int* e, int r, int g, int b, int a)
+{
+    ddsktx__astc_rgba(e, (r + b) >> 1, (g + b) >> 1, b, a);
+}
+
+// LDR color endpoint modes, returns false for HDR modes
+static bool ddsktx__astc_endpoints(int cem, const int* cv, int* e0, int* e1)
+{
+    int v[8];
+    ddsktx_memcpy(v, cv, sizeof(int)*((cem >> 2) + 1)*2);
+    switch (cem) {
+    case 0:     // luminance
+        ddsktx__astc_rgba(e0, v[0], v[0], v[0], 255);
+        ddsktx__astc_rgba(e1, v[1], v[1], v[1], 255);
+        break;
+    case 1: {   // luminance, base + offset
+        int l0 = (v[0] >> 2) | (v[1] & 0xc0);
+        int l1 = ddsktx__min(l0 + (v[1] & 0x3f), 255);
+        ddsktx__astc_rgba(e0, l0, l0, l0, 255);
+        ddsktx__astc_rgba(e1, l1, l1, l1, 255);
+        break;
+    }
+    case 4:     // luminance + alpha
+        ddsktx__astc_rgba(e0, v[0], v[0], v[0], v[2]);
+        ddsktx__astc_rgba(e1, v[1], v[1], v[1], v[3]);
+        break;
+    case 5:     // luminance + alpha, base + offset
+        ddsktx__astc_bit_transfer(&v[1], &v[0]);
+        ddsktx__astc_bit_transfer(&v[3], &v[2]);
+        ddsktx__astc_rgba(e0, v[0], v[0], v[0], v[2]);
+        ddsktx__astc_rgba(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+        break;
+    case 6:     // rgb, base + scale
+        ddsktx__astc_rgba(e0, (v[0]*v[3]) >> 8, (v[1]*v[3]) >> 8, (v[2]*v[3]) >> 8, 255);
+        ddsktx__astc_rgba(e1, v[0], v[1], v[2], 255);
+        break;
+    case 8:     // rgb
+    case 12:    // rgba
+        if (cem == 8) {
+            v[6] = v[7] = 255;
+        }
+        if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+            ddsktx__astc_rgba(e0, v[0], v[2], v[4], v[6]);
+            ddsktx__astc_rgba(e1, v[1], v[3], v[5], v[7]);
+        } else {
+            ddsktx__astc_blue_contract(e0, v[1], v[3], v[5], v[7]);
+            ddsktx__astc_blue_contract(e1, v[0], v[2], v[4], v[6]);
+        }
+        break;
+    case 9:     // rgb, base + offset
+    case 13:    // rgba, base + offset
+        if (cem == 9) {
+            v[6] = 255;
+            v[7] = 0;
+        } else {
+            ddsktx__astc_bit_transfer(&v[7], &v[6]);
+        }
+        ddsktx__astc_bit_transfer(&v[1], &v[0]);
+        ddsktx__astc_bit_transfer(&v[3], &v[2]);
+        ddsktx__astc_bit_transfer(&v[5], &v[4]);
+        if (v[1] + v[3] + v[5] >= 0) {
+            ddsktx__astc_rgba(e0, v[0], v[2], v[4], v[6]);
+            ddsktx__astc_rgba(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+        } else {
+            ddsktx__astc_blue_contract(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+            ddsktx__astc_blue_contract(e1, v[0], v[2], v[4], v[6]);
+        }
+        break;
+    case 10:    // rgb, base + scale, two alphas
+        ddsktx__astc_rgba(e0, (v[0]*v[3]) >> 8, (v[1]*v[3]) >> 8, (v[2]*v[3]) >> 8, v[4]);
+        ddsktx__astc_rgba(e1, v[0], v[1], v[2], v[5]);
+        break;
+    default:
+        return false;
+    }
+
+    for (int c = 0; c < 4; c++) {
+        e0[c] = ddsktx__clamp8(e0[c]);
+        e1[c] = ddsktx__clamp8(e1[c]);
+    }
+    return true;
+}
+
+// 8 bits from a UNORM16 color: top bits for sRGB, rounded for linear
+static inline uint8_t ddsktx__astc_unorm8(int c, bool srgb)
+{
+    return (uint8_t)(srgb ? (c >> 8) : (c*255 + 32767) / 65535);
+}
+
+static void ddsktx__astc_error(uint8_t* rgba, int num_texels)
+{
+    for (int i = 0; i < num_texels; i++) {
+        rgba[i*4 + 0] = 255;
+        rgba[i*4 + 1] = 0;
+        rgba[i*4 + 2] = 255;
+        rgba[i*4 + 3] = 255;
+    }
+}
+
+static void ddsktx__decode_astc(const uint8_t* block, int bw, int bh, bool srgb, uint8_t* rgba)
+{
+    ddsktx__bits bits;
+    ddsktx__bits_init(&bits, block);
+    int num_texels = bw*bh;
+
+    int mode = ddsktx__astc_bits(&bits, 0, 11, 128);
+    if ((mode & 0x1ff) == 0x1fc) {
+        // void-extent: constant color, the extent is only an optimization hint
+        int s0 = ddsktx__astc_bits(&bits, 12, 13, 128);
+        int s1 = ddsktx__astc_bits(&bits, 25, 13, 128);
+        int t0 = ddsktx__astc_bits(&bits, 38, 13, 128);
+        int t1 = ddsktx__astc_bits(&bits, 51, 13, 128);
+        bool all_ones = (s0 & s1 & t0 & t1) == 0x1fff;
+        if ((mode & 0x200) || ddsktx__astc_bits(&bits, 10, 2, 128) != 3 || (!all_ones && (s0 >= s1 || t0 >= t1))) {
+            ddsktx__astc_error(rgba, num_texels);
+            return;
+        }
+        uint8_t color[4];
+        for (int c = 0; c < 4; c++) {
+            color[c] = ddsktx__astc_unorm8(ddsktx__astc_bits(&bits, 64 + c*16, 16, 128), srgb);
+        }
+        for (int i = 0; i < num_texels; i++) {
+            ddsktx_memcpy(rgba + i*4, color, 4);
+        }
+        return;
+    }
+
+    ddsktx__astc_block bm;
+    if (!ddsktx__astc_block_mode(mode, &bm) || bm.weights_x > bw || bm.weights_y > bh) {
+        ddsktx__astc_error(rgba, num_texels);
+        return;
+    }
+    int num_planes = bm.dual_plane ? 2 : 1;
+    int num_weights = bm.weights_x * bm.weights_y * num_planes;
+    int weight_bits = ddsktx__astc_ise_bits(bm.weight_quant, num_weights);
+    int num_partitions = ddsktx__astc_bits(&bits, 11, 2, 128) + 1;
+    if (num_weights > DDSKTX__ASTC_MAX_WEIGHTS || weight_bits < 24 || weight_bits > 96 ||
+        (bm.dual_plane && num_partitions == 4)) 
+    {
+        ddsktx__astc_error(rgba, num_texels);
+        return;
+    }
+
+    // color endpoint modes, extra bits of multi-partition blocks are stored below the weights
+    int cems[4];
+    int partition_seed = 0;
+    int color_start = 17;
+    int below_weights = 128 - weight_bits;
+    if (num_partitions == 1) {
+        cems[0] = ddsktx__astc_bits(&bits, 13, 4, 128);
+    } else {
+        partition_seed = ddsktx__astc_bits(&bits, 13, 10, 128);
+        color_start = 29;
+        int cem = ddsktx__astc_bits(&bits, 23, 6, 128);
+        if ((cem & 3) == 0) {
+            for (int p = 0; p < num_partitions; p++) {
+                cems[p] = cem >> 2;
+            }
+        } else {
+            int extra_bits = num_partitions*3 - 4;
+            below_weights -= extra_bits;
+            cem |= ddsktx__astc_bits(&bits, below_weights, extra_bits, 128) << 6;
+            int base_class = (cem & 3) - 1;
+            for (int p = 0; p < num_partitions; p++) {
+                cems[p] = ((((cem >> (2 + p)) & 1) + base_class) << 2) | ((cem >> (2 + num_partitions + p*2)) & 3);
+            }
+        }
+    }
+    int plane2_component = -1;
+    if (bm.dual_plane) {
+        below_weights -= 2;
+        plane2_component = ddsktx__astc_bits(&bits, below_weights, 2, 128);
+    }
+
+    // endpoints use the highest color quantization that fits in the remaining bits
+    int num_values = 0;
+    for (int p = 0; p < num_partitions; p++) {
+        num_values += ((cems[p] >> 2) + 1)*2;
+    }
+    int color_quant = 20;
+    while (color_quant >= DDSKTX__ASTC_QUANT_6 && 
+           ddsktx__astc_ise_bits(color_quant, num_values) > below_weights - color_start) 
+    {
+        color_quant--;
+    }
+    if (num_values > 18 || color_quant < DDSKTX__ASTC_QUANT_6) {
+        ddsktx__astc_error(rgba, num_texels);
+        return;
+    }
+
+    uint8_t tq[DDSKTX__ASTC_MAX_WEIGHTS];
+    uint8_t low[DDSKTX__ASTC_MAX_WEIGHTS];
+    int endpoints[4][2][4];
+    ddsktx__astc_decode_ise(&bits, color_start, below_weights, color_quant, num_values, tq, low);
+    for (int p = 0, first = 0; p < num_partitions; p++) {
+        int values[8];
+        int count = ((cems[p] >> 2) + 1)*2;
+        for (int i = 0; i < count; i++) {
+            values[i] = ddsktx__astc_unquant_color(color_quant, tq[first + i], low[first + i]);
+        }
+        first += count;
+        if (!ddsktx__astc_endpoints(cems[p], values, endpoints[p][0], endpoints[p][1])) {
+            ddsktx__astc_error(rgba, num_texels);
+            return;
+        }
+    }
+
+    // weights are stored from the top of the block down, in reversed bit order
+    ddsktx__bits rbits;
+    rbits.lo = ddsktx__reverse64(bits.hi);
+    rbits.hi = ddsktx__reverse64(bits.lo);
+    ddsktx__astc_decode_ise(&rbits, 0, weight_bits, bm.weight_quant, num_weights, tq, low);
+
+    // weight grids of each plane, padded for the infill reads past the last row and column
+    uint8_t grid[2][DDSKTX__ASTC_MAX_WEIGHTS + 16];
+    ddsktx_memset(grid, 0x0, sizeof(grid));
+    for (int i = 0; i < num_weights; i++) {
+        grid[i % num_planes][i / num_planes] = (uint8_t)ddsktx__astc_unquant_weight(bm.weight_quant, tq[i], low[i]);
+    }
+
+    int ds = (1024 + bw/2) / (bw - 1);
+    int dt = (1024 + bh/2) / (bh - 1);
+    bool small_block = num_texels < 31;
+    for (int y = 0; y < bh; y++) {
+        for (int x = 0; x < bw; x++) {
+            int gs = (ds*x*(bm.weights_x - 1) + 32) >> 6;
+            int gt = (dt*y*(bm.weights_y - 1) + 32) >> 6;
+            int fs = gs & 0xf;
+            int ft = gt & 0xf;
+            int v0 = (gs >> 4) + (gt >> 4)*bm.weights_x;
+            int w11 = (fs*ft + 8) >> 4;
+            int w10 = ft - w11;
+            int w01 = fs - w11;
+            int w00 = 16 - fs - ft + w11;
+
+            int weights[2];
+            for (int k = 0; k < num_planes; k++) {
+                const uint8_t* g = grid[k];
+                weights[k] = (g[v0]*w00 + g[v0 + 1]*w01 + g[v0 + bm.weights_x]*w10 + 
+                              g[v0 + bm.weights_x + 1]*w11 + 8) >> 4;
+            }
+
+            int p = num_partitions > 1 ? ddsktx__astc_partition(partition_seed, x, y, num_partitions, small_block) : 0;
+            uint8_t* texel = rgba + (y*bw + x)*4;
+            for (int c = 0; c < 4; c++) {
+                int w = weights[c == plane2_component ? 1 : 0];
+                int c0 = srgb ? (endpoints[p][0][c] << 8) | 0x80 : endpoints[p][0][c]*257;
+                int c1 = srgb ? (endpoints[p][1][c] << 8) | 0x80 : endpoints[p][1][c]*257;
+                texel[c] = ddsktx__astc_unorm8((c0*(64 - w) + c1*w + 32) >> 6, srgb);
+            }
+        }
+    }
+}
+
+// decodes a single block into pixels of the format that ddsktx_block_decode_format returns, 4x4 or the block
+// footprint of ASTC formats. 'flags' are DDSKTX_TEXTURE_FLAG_SIGNED (BC6H) and DDSKTX_TEXTURE_FLAG_SRGB (ASTC)
+static void ddsktx__decode_block(ddsktx_format format, unsigned int flags, const uint8_t* block, void* pixels)
+{
+    uint8_t* rgba = (uint8_t*)pixels;
+    bool is_signed = (flags & DDSKTX_TEXTURE_FLAG_SIGNED) != 0;
+    switch (format) {
+    case DDSKTX_FORMAT_BC1:
+        ddsktx__decode_bc1_color(block, rgba, true);
+        break;
+    case DDSKTX_FORMAT_BC2:
+        ddsktx__decode_bc1_color(block + 8, rgba, false);
+        ddsktx__decode_bc2_alpha(block, rgba);
+        break;
+    case DDSKTX_FORMAT_BC3:
+        ddsktx__decode_bc1_color(block + 8, rgba, false);
+        ddsktx__decode_bc4_channel(block, rgba, 3);
+        break;
+    case DDSKTX_FORMAT_BC4:
+    case DDSKTX_FORMAT_BC5:
+        for (int i = 0; i < 16; i++) {
+            rgba[i*4 + 1] = rgba[i*4 + 2] = 0;
+            rgba[i*4 + 3] = 255;
+        }
+        ddsktx__decode_bc4_channel(block, rgba, 0);
+        if (format == DDSKTX_FORMAT_BC5) {
+            ddsktx__decode_bc4_channel(block + 8, rgba, 1);
+        }
+        break;
+    case DDSKTX_FORMAT_BC6H:
+        ddsktx__decode_bc6h(block, (uint16_t*)pixels, is_signed);
+        break;
+    case DDSKTX_FORMAT_BC7:
+        ddsktx__decode_bc7(block, rgba);
+        break;
+    case DDSKTX_FORMAT_ETC1:
+    case DDSKTX_FORMAT_ETC2:
+    case DDSKTX_FORMAT_ETC2A1:
+        ddsktx__decode_etc_color(block, rgba, format != DDSKTX_FORMAT_ETC1, format == DDSKTX_FORMAT_ETC2A1);
+        break;
+    case DDSKTX_FORMAT_ETC2A:
+        ddsktx__decode_etc_color(block + 8, rgba, true, false);
+        ddsktx__decode_eac_alpha(block, rgba);
+        break;
+    case DDSKTX_FORMAT_ASTC4x4:
+    case DDSKTX_FORMAT_ASTC5x5:
+    case DDSKTX_FORMAT_ASTC6x6:
+    case DDSKTX_FORMAT_ASTC8x5:
+    case DDSKTX_FORMAT_ASTC8x6:
+    case DDSKTX_FORMAT_ASTC10x5:
+        ddsktx__decode_astc(block, k__block_info[format].block_width, k__block_info[format].block_height,
+                            (flags & DDSKTX_TEXTURE_FLAG_SRGB) != 0, rgba);
+        break;
+    default:
+        ddsktx_assert(0);
+        break;
+    }
+}
+
+ddsktx_format ddsktx_block_decode_format(ddsktx_format format)
+{
+    switch (format) {
+    case DDSKTX_FORMAT_BC1:
+    case DDSKTX_FORMAT_BC2:
+    case DDSKTX_FORMAT_BC3:
+    case DDSKTX_FORMAT_BC4:
+    case DDSKTX_FORMAT_BC5:
+    case DDSKTX_FORMAT_BC7:
+    case DDSKTX_FORMAT_ETC1:
+    case DDSKTX_FORMAT_ETC2:
+    case DDSKTX_FORMAT_ETC2A:
+    case DDSKTX_FORMAT_ETC2A1:
+    case DDSKTX_FORMAT_ASTC4x4:
+    case DDSKTX_FORMAT_ASTC5x5:
+    case DDSKTX_FORMAT_ASTC6x6:
+    case DDSKTX_FORMAT_ASTC8x5:
+    case DDSKTX_FORMAT_ASTC8x6:
+    case DDSKTX_FORMAT_ASTC10x5: return DDSKTX_FORMAT_RGBA8;
+    case DDSKTX_FORMAT_BC6H:    return DDSKTX_FORMAT_RGBA16F;
+    default:                    return _DDSKTX_FORMAT_COUNT;
+    }
+}
+
+bool ddsktx_decode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, void* dst, int dst_row_pitch,
+                          int first_block_row, int num_block_rows)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub);
+    ddsktx_assert(dst);
+
+    ddsktx_format dst_format = ddsktx_block_decode_format(tc->format);
+    if (dst_format == _DDSKTX_FORMAT_COUNT) {
+        return false;
+    }
+
+    const ddsktx__block_info* binfo = &k__block_info[tc->format];
+    int bw = binfo->block_width;
+    int bh = binfo->block_height;
+    int pixel_bytes = k__block_info[dst_format].bpp / 8;
+    int num_blocks_x = (sub->width + bw - 1) / bw;
+    ddsktx_assert(first_block_row >= 0 && num_block_rows >= 0);
+    ddsktx_assert(first_block_row + num_block_rows <= (sub->height + bh - 1) / bh);
+    ddsktx_assert(dst_row_pitch >= sub->width * pixel_bytes);
+
+    uint64_t pixels[DDSKTX__ASTC_MAX_TEXELS/2];     // 4x4 block of RGBA8 or RGBA16F, or an ASTC block of RGBA8
+    for (int by = 0; by < num_block_rows; by++) {
+        const uint8_t* block = (const uint8_t*)sub->buff + (int64_t)(first_block_row + by) * sub->row_pitch_bytes;
+        uint8_t* dst_row = (uint8_t*)dst + (int64_t)by * bh * dst_row_pitch;
+        int num_rows = ddsktx__min(bh, sub->height - (first_block_row + by)*bh);
+
+        for (int bx = 0; bx < num_blocks_x; bx++) {
+            ddsktx__decode_block(tc->format, tc->flags, block, pixels);
+            block += binfo->block_size;
+
+            int num_cols = ddsktx__min(bw, sub->width - bx*bw);
+            const uint8_t* src = (const uint8_t*)pixels;
+            uint8_t* d = dst_row + bx*bw*pixel_bytes;
+            for (int y = 0; y < num_rows; y++) {
+                ddsktx_memcpy(d, src, num_cols*pixel_bytes);
+                src += bw*pixel_bytes;
+                d += dst_row_pitch;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC1/BC3/BC7 block encoding, used for transcoding
+// Fast bounding-box encoders (endpoints are the inset min/max of the block), meant for load-time conversion
+static inline int ddsktx__color_dist(const uint8_t* a, const uint8_t* b)
+{
+    int dr = a[0] - b[0];
+    int dg = a[1] - b[1];
+    int db = a[2] - b[2];
+    return dr*dr + dg*dg + db*db;
+}
+
+static inline int ddsktx__pack565(const int* rgb)
+{
+    return (((rgb[0]*31 + 127)/255) << 11) | (((rgb[1]*63 + 127)/255) << 5) | ((rgb[2]*31 + 127)/255);
+}
+
+static void ddsktx__encode_bc1_color(const uint8_t* rgba, uint8_t* block)
+{
+    int mn[3] = { 255, 255, 255 };
+    int mx[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mn[c] = ddsktx__min(mn[c], (int)rgba[i*4 + c]);
+            mx[c] = ddsktx__max(mx[c], (int)rgba[i*4 + c]);
+        }
+    }
+
+    // inset the bounding box a bit, extremes are usually outliers
+    int ref = 0;
+    for (int c = 0; c < 3; c++) {
+        int inset = (mx[c] - mn[c]) >> 4;
+        mn[c] += inset;
+        mx[c] -= inset;
+        ref = (mx[c] - mn[c]) > (mx[ref] - mn[ref]) ? c : ref;
+    }
+
+    // pick the box diagonal that follows the colors: flip the channels that go against the widest channel
+    int mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += rgba[i*4 + c];
+        }
+    }
+    for (int c = 0; c < 3; c++) {
+        if (c == ref) 
+            continue;
+        int cov = 0;
+        for (int i = 0; i < 16; i++) {
+            cov += (rgba[i*4 + c]*16 - mean[c]) * (rgba[i*4 + ref]*16 - mean[ref]) / 256;
+        }
+        if (cov < 0) {
+            int tmp = mn[c];
+            mn[c] = mx[c];
+            mx[c] = tmp;
+        }
+    }
+
+    int c0 = ddsktx__pack565(mx);
+    int c1 = ddsktx__pack565(mn);
+    if (c0 < c1) {
+        int tmp = c0;
+        c0 = c1;
+        c1 = tmp;
+    }
+    uint32_t indices = 0;
+
+    // c0 > c1 selects 4 color mode, if they are equal, all indices stay at zero
+    if (c0 != c1) {
+        uint8_t colors[4][3];
+        colors[0][0] = ddsktx__expand_bits((c0 >> 11) & 0x1f, 5);
+        colors[0][1] = ddsktx__expand_bits((c0 >> 5) & 0x3f, 6);
+        colors[0][2] = ddsktx__expand_bits(c0 & 0x1f, 5);
+        colors[1][0] = ddsktx__expand_bits((c1 >> 11) & 0x1f, 5);
+        colors[1][1] = ddsktx__expand_bits((c1 >> 5) & 0x3f, 6);
+        colors[1][2] = ddsktx__expand_bits(c1 & 0x1f, 5);
+        for (int c = 0; c < 3; c++) {
+            colors[2][c] = (uint8_t)((2*colors[0][c] + colors[1][c] + 1) / 3);
+            colors[3][c] = (uint8_t)((colors[0][c] + 2*colors[1][c] + 1) / 3);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int best_dist = ddsktx__color_dist(rgba + i*4, colors[0]);
+            for (int k = 1; k < 4; k++) {
+                int dist = ddsktx__color_dist(rgba + i*4, colors[k]);
+                if (dist < best_dist) {
+                    best = k;
+                    best_dist = dist;
+                }
+            }
+            indices |= (uint32_t)best << (i*2);
+        }
+    }
+
+    block[0] = (uint8_t)c0;
+    block[1] = (uint8_t)(c0 >> 8);
+    block[2] = (uint8_t)c1;
+    block[3] = (uint8_t)(c1 >> 8);
+    block[4] = (uint8_t)indices;
+    block[5] = (uint8_t)(indices >> 8);
+    block[6] = (uint8_t)(indices >> 16);
+    block[7] = (uint8_t)(indices >> 24);
+}
+
+// BC4 block from one channel of rgba, always in 8 value mode (a0 > a1)
+static void ddsktx__encode_bc4_channel(const uint8_t* rgba, int channel, uint8_t* block)
+{
+    int mn = 255;
+    int mx = 0;
+    for (int i = 0; i < 16; i++) {
+        mn = ddsktx__min(mn, (int)rgba[i*4 + channel]);
+        mx = ddsktx__max(mx, (int)rgba[i*4 + channel]);
+    }
+
+    uint64_t indices = 0;
+    if (mx != mn) {
+        int values[8];
+        values[0] = mx;
+        values[1] = mn;
+        for (int i = 1; i < 7; i++) {
+            values[i + 1] = ((7 - i)*mx + i*mn + 3) / 7;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int v = rgba[i*4 + channel];
+            int best = 0;
+            int best_dist = 256;
+            for (int k = 0; k < 8; k++) {
+                int dist = v > values[k] ? v - values[k] : values[k] - v;
+                if (dist < best_dist) {
+                    best = k;
+                    best_dist = dist;
+                }
+            }
+            indices |= (uint64_t)best << (i*3);
+        }
+    }
+
+    block[0] = (uint8_t)mx;
+    block[1] = (uint8_t)mn;
+    for (int i = 0; i < 6; i++) {
+        block[2 + i] = (uint8_t)(indices >> (i*8));
+    }
+}
+
+// BC7 mode 6 block: one RGBA line with 7.7.7.7 endpoints, a p-bit per endpoint and 16 4-bit indices
+// Endpoints are the inset bounding box of the block along the diagonal that follows the colors,
+// indices are projected on the line and refined against the neighbouring palette entries
+static inline void ddsktx__bits_write(uint8_t* block, int* pos, int value, int count)
+{
+    for (int i = 0; i < count; i++, (*pos)++) {
+        block[*pos >> 3] |= (uint8_t)(((value >> i) & 1) << (*pos & 7));
+    }
+}
+
+// 7 bit endpoint and p-bit closest to the 8 bit color
+static int ddsktx__bc7_quantize(const int* color, int* q)
+{
+    int best_err = 0x7fffffff;
+    int best_p = 0;
+    for (int p = 0; p < 2; p++) {
+        int err = 0;
+        int pq[4];
+        for (int c = 0; c < 4; c++) {
+            pq[c] = ddsktx__clamp(((color[c] - p + 1) >> 1), 0, 127);
+            int d = ((pq[c] << 1) | p) - color[c];
+            err += d*d;
+        }
+        if (err < best_err) {
+            best_err = err;
+            best_p = p;
+            ddsktx_memcpy(q, pq, sizeof(pq));
+        }
+    }
+    return best_p;
+}
+
+static inline int ddsktx__rgba_dist(const uint8_t* a, const int* b)
+{
+    int dr = a[0] - b[0];
+    int dg = a[1] - b[1];
+    int db = a[2] - b[2];
+    int da = a[3] - b[3];
+    return dr*dr + dg*dg + db*db + da*da;
+}
+
+static void ddsktx__encode_bc7(const uint8_t* rgba, uint8_t* block)
+{
+    int mn[4] = { 255, 255, 255, 255 };
+    int mx[4] = { 0, 0, 0, 0 };
+    int mean[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            mn[c] = ddsktx__min(mn[c], (int)rgba[i*4 + c]);
+            mx[c] = ddsktx__max(mx[c], (int)rgba[i*4 + c]);
+            mean[c] += rgba[i*4 + c];
+        }
+    }
+
+    int ref = 0;
+    for (int c = 0; c < 4; c++) {
+        int inset = (mx[c] - mn[c]) >> 5;
+        mn[c] += inset;
+        mx[c] -= inset;
+        ref = (mx[c] - mn[c]) > (mx[ref] - mn[ref]) ? c : ref;
+    }
+    for (int c = 0; c < 4; c++) {
+        if (c == ref) 
+            continue;
+        int cov = 0;
+        for (int i = 0; i < 16; i++) {
+            cov += (rgba[i*4 + c]*16 - mean[c]) * (rgba[i*4 + ref]*16 - mean[ref]) / 256;
+        }
+        if (cov < 0) {
+            int tmp = mn[c];
+            mn[c] = mx[c];
+            mx[c] = tmp;
+        }
+    }
+
+    int q[2][4];
+    int p[2];
+    p[0] = ddsktx__bc7_quantize(mn, q[0]);
+    p[1] = ddsktx__bc7_quantize(mx, q[1]);
+
+    int palette[16][4];
+    int e0[4];
+    int e1[4];
+    int dir[4];
+    int dir_len = 0;
+    for (int c = 0; c < 4; c++) {
+        e0[c] = (q[0][c] << 1) | p[0];
+        e1[c] = (q[1][c] << 1) | p[1];
+        dir[c] = e1[c] - e0[c];
+        dir_len += dir[c]*dir[c];
+        for (int k = 0; k < 16; k++) {
+            palette[k][c] = ddsktx__bc_interp(e0[c], e1[c], k, 4);
+        }
+    }
+
+    int indices[16];
+    for (int i = 0; i < 16; i++) {
+        const uint8_t* px = rgba + i*4;
+        int index = 0;
+        if (dir_len > 0) {
+            int dot = 0;
+            for (int c = 0; c < 4; c++) {
+                dot += (px[c] - e0[c])*dir[c];
+            }
+            index = ddsktx__clamp((dot*15 + dir_len/2) / dir_len, 0, 15);
+            int best_dist = ddsktx__rgba_dist(px, palette[index]);
+            for (int k = ddsktx__max(index - 1, 0); k <= ddsktx__min(index + 1, 15); k++) {
+                int dist = ddsktx__rgba_dist(px, palette[k]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    index = k;
+                }
+            }
+        }
+        indices[i] = index;
+    }
+
+    // the first index is stored with 3 bits, its top bit must be zero
+    if (indices[0] & 8) {
+        for (int c = 0; c < 4; c++) {
+            int tmp = q[0][c];
+            q[0][c] = q[1][c];
+            q[1][c] = tmp;
+        }
+        int tmp = p[0];
+        p[0] = p[1];
+        p[1] = tmp;
+        for (int i = 0; i < 16; i++) {
+            indices[i] = 15 - indices[i];
+        }
+    }
+
+    ddsktx_memset(block, 0x0, 16);
+    int pos = 0;
+    ddsktx__bits_write(block, &pos, 1 << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        ddsktx__bits_write(block, &pos, q[0][c], 7);
+        ddsktx__bits_write(block, &pos, q[1][c], 7);
+    }
+    ddsktx__bits_write(block, &pos, p[0], 1);
+    ddsktx__bits_write(block, &pos, p[1], 1);
+    ddsktx__bits_write(block, &pos, indices[0], 3);
+    for (int i = 1; i < 16; i++) {
+        ddsktx__bits_write(block, &pos, indices[i], 4);
+    }
+}
+
+ddsktx_format ddsktx_transcode_format(ddsktx_format format)
+{
+    switch (format) {
+    case DDSKTX_FORMAT_ETC1:
+    case DDSKTX_FORMAT_ETC2:    return DDSKTX_FORMAT_BC1;
+    case DDSKTX_FORMAT_ETC2A:
+    case DDSKTX_FORMAT_ETC2A1:  return DDSKTX_FORMAT_BC3;
+    case DDSKTX_FORMAT_ASTC4x4:
+    case DDSKTX_FORMAT_ASTC5x5:
+    case DDSKTX_FORMAT_ASTC6x6:
+    case DDSKTX_FORMAT_ASTC8x5:
+    case DDSKTX_FORMAT_ASTC8x6:
+    case DDSKTX_FORMAT_ASTC10x5: return DDSKTX_FORMAT_BC7;
+    default:                    return _DDSKTX_FORMAT_COUNT;
+    }
+}
+
+// encodes 4x4 RGBA8 pixels to a BC1, BC3 or BC7 block
+static void ddsktx__encode_block(ddsktx_format format, const uint8_t* pixels, uint8_t* block)
+{
+    switch (format) {
+    case DDSKTX_FORMAT_BC1:
+        ddsktx__encode_bc1_color(pixels, block);
+        break;
+    case DDSKTX_FORMAT_BC3:
+        ddsktx__encode_bc4_channel(pixels, 3, block);
+        ddsktx__encode_bc1_color(pixels, block + 8);
+        break;
+    case DDSKTX_FORMAT_BC7:
+        ddsktx__encode_bc7(pixels, block);
+        break;
+    default:
+        ddsktx_assert(0);
+        break;
+    }
+}
+
+bool ddsktx_transcode_blocks(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_format dst_format,
+                             void* dst, int dst_row_pitch, int first_block_row, int num_block_rows)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub);
+    ddsktx_assert(dst);
+
+    if (ddsktx_block_decode_format(tc->format) != DDSKTX_FORMAT_RGBA8 ||
+        (dst_format != DDSKTX_FORMAT_BC1 && dst_format != DDSKTX_FORMAT_BC3 && dst_format != DDSKTX_FORMAT_BC7))
+    {
+        return false;
+    }
+
+    const ddsktx__block_info* src_info = &k__block_info[tc->format];
+    int src_block_size = src_info->block_size;
+    int dst_block_size = k__block_info[dst_format].block_size;
+    int num_blocks_x = (sub->width + 3) / 4;
+    ddsktx_assert(first_block_row >= 0 && num_block_rows >= 0);
+    ddsktx_assert(first_block_row + num_block_rows <= (sub->height + 3) / 4);
+    ddsktx_assert(dst_row_pitch >= num_blocks_x * dst_block_size);
+
+    uint8_t pixels[64];
+    if (src_info->block_width == 4 && src_info->block_height == 4) {
+        // decoded blocks include the pixels outside of the image, so edge blocks are encoded as they are
+        for (int by = 0; by < num_block_rows; by++) {
+            const uint8_t* src = (const uint8_t*)sub->buff + (int64_t)(first_block_row + by) * sub->row_pitch_bytes;
+            uint8_t* d = (uint8_t*)dst + (int64_t)by * dst_row_pitch;
+            for (int bx = 0; bx < num_blocks_x; bx++) {
+                ddsktx__decode_block(tc->format, tc->flags, src, pixels);
+                ddsktx__encode_block(dst_format, pixels, d);
+                src += src_block_size;
+                d += dst_block_size;
+            }
+        }
+        return true;
+    }
+
+    // larger ASTC footprints: 4x4 blocks are gathered from the (up to 4) source blocks that they overlap, which
+    // are decoded into a small cache. Pixels outside of the image repeat the last row and column
+    int bw = src_info->block_width;
+    int bh = src_info->block_height;
+    uint32_t cache[4][DDSKTX__ASTC_MAX_TEXELS];
+    int cache_x[4] = { -1, -1, -1, -1 };
+    int cache_y[4] = { -1, -1, -1, -1 };
+    for (int by = 0; by < num_block_rows; by++) {
+        uint8_t* d = (uint8_t*)dst + (int64_t)by * dst_row_pitch;
+        for (int bx = 0; bx < num_blocks_x; bx++) {
+            for (int i = 0; i < 16; i++) {
+                int x = ddsktx__min(bx*4 + (i & 3), sub->width - 1);
+                int y = ddsktx__min((first_block_row + by)*4 + (i >> 2), sub->height - 1);
+                int sx = x / bw;
+                int sy = y / bh;
+                int slot = (sx & 1) | ((sy & 1) << 1);
+                if (cache_x[slot] != sx || cache_y[slot] != sy) {
+                    const uint8_t* src = (const uint8_t*)sub->buff + (int64_t)sy * sub->row_pitch_bytes + 
+                                         (int64_t)sx * src_block_size;
+                    ddsktx__decode_block(tc->format, tc->flags, src, cache[slot]);
+                    cache_x[slot] = sx;
+                    cache_y[slot] = sy;
+                }
+                ddsktx_memcpy(pixels + i*4, &cache[slot][(y - sy*bh)*bw + (x - sx*bw)], 4);
+            }
+            ddsktx__encode_block(dst_format, pixels, d);
+            d += dst_block_size;
+        }
+    }
+
+    return true;
+}
+
+
+static inline int ddsktx__read(ddsktx__reader* reader, void* buff, int size)
+{
+    int read_bytes = (reader->offset + size) <= reader->total ? size : (int)(reader->total - reader->offset);
+    if (read_bytes > 0) {
+        read_bytes = (int)reader->io->read(reader->io->user, reader->offset, buff, read_bytes);
+        reader->offset += read_bytes;
+    }
+    return read_bytes;
+}
+
+static int64_t ddsktx__mem_read(void* user, int64_t offset, void* buff, int64_t size)
+{
+    const ddsktx__mem_blob* blob = (const ddsktx__mem_blob*)user;
+    if (offset >= blob->size) {
+        return 0;
+    }
+    int64_t read_bytes = ddsktx__min(size, blob->size - offset);
+    ddsktx_memcpy(buff, blob->buff + offset, (size_t)read_bytes);
+    return read_bytes;
+}
+
+static int64_t ddsktx__mem_size(void* user)
+{
+    return ((const ddsktx__mem_blob*)user)->size;
+}
+
+// 'r.total' is the amount of available data (can be only the header part of the file), 
+// 'file_size' is the size of the whole file. 'required' receives the size of the header that must be available
+static ddsktx_result ddsktx__parse_ktx(ddsktx_texture_info* tc, ddsktx__reader r, int64_t file_size,
+                                       int64_t* required)
+{
+    static const uint8_t ktx__id[] = { 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    ddsktx_memset(tc, 0x0, sizeof(ddsktx_texture_info));
+
+    r.offset = sizeof(uint32_t);
+    ddsktx__ktx_header header;
+    if (required) {
+        *required = r.offset + DDSKTX__KTX_HEADER_SIZE;
+    }
+    if (ddsktx__read(&r, &header, sizeof(header)) != DDSKTX__KTX_HEADER_SIZE) {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+
+    if (ddsktx_memcmp(header.id, ktx__id, sizeof(header.id)) != 0) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    // TODO: support big endian
+    if (header.endianess != 0x04030201) {
+        return DDSKTX_ERROR_UNSUPPORTED_FEATURE;
+    }
+
+    tc->metadata_offset = r.offset;
+    tc->metadata_size = (int)header.metadata_size;
+    r.offset += header.metadata_size;
+    if (required) {
+        *required = r.offset;
+    }
+    if (r.offset > file_size) {
+        return DDSKTX_ERROR_INVALID_METADATA;
+    }
+
+    bool srgb;
+    ddsktx_format format = ddsktx__ktx_format(header.internal_format, &srgb);
+    if (format == _DDSKTX_FORMAT_COUNT) {
+        return DDSKTX_ERROR_UNSUPPORTED_FORMAT;
+    } 
+    if (format == DDSKTX_FORMAT_RGBA8 && srgb && header.format == DDSKTX__KTX_BGRA) {
+        format = DDSKTX_FORMAT_BGRA8;
+    }
+
+    if (header.face_count > 1 && header.face_count != DDSKTX_CUBE_FACE_COUNT) {
+        return DDSKTX_ERROR_INVALID_CUBEMAP;
+    }
+
+    tc->data_offset = r.offset;
+    tc->size_bytes = file_size - r.offset;
+    tc->format = format;
+    tc->width = (int)header.width;
+    tc->height = (int)header.height;
+    tc->depth = ddsktx__max((int)header.depth, 1);
+    tc->num_layers = ddsktx__max((int)header.array_count, 1);
+    tc->num_mips = ddsktx__max((int)header.mip_count, 1);
+    tc->bpp = k__block_info[format].bpp;
+
+    if (header.face_count == 6)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_CUBEMAP;
+    if (srgb)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SRGB;
+    if (header.internal_format == DDSKTX__KTX_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SIGNED;
+    tc->flags |= k__formats_info[format].has_alpha ? DDSKTX_TEXTURE_FLAG_ALPHA : 0;
+    tc->flags |= DDSKTX_TEXTURE_FLAG_KTX;
+
+    return DDSKTX_OK;
+}
+
+
+static ddsktx_result ddsktx__parse_dds(ddsktx_texture_info* tc, ddsktx__reader r, int64_t file_size,
+                                       int64_t* required)
+{
+    r.offset = sizeof(uint32_t);
+    ddsktx__dds_header header;
+    if (required) {
+        *required = r.offset + DDSKTX__DDS_HEADER_SIZE;
+    }
+    if (ddsktx__read(&r, &header, sizeof(header)) < DDSKTX__DDS_HEADER_SIZE ||
+        header.size != DDSKTX__DDS_HEADER_SIZE)
+    {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+
+    uint32_t required_flags = (DDSKTX__DDSD_HEIGHT|DDSKTX__DDSD_WIDTH);
+    if ((header.flags & required_flags) != required_flags) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    if (header.pixel_format.size != sizeof(ddsktx__dds_pixel_format)) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    uint32_t dxgi_format = 0;
+    uint32_t array_size = 1;
+    if (DDSKTX__DDPF_FOURCC == (header.flags & DDSKTX__DDPF_FOURCC) && 
+        header.pixel_format.fourcc == DDSKTX__DDS_DX10)
+    {
+        ddsktx__dds_header_dxgi dxgi_header;
+        if (required) {
+            *required += sizeof(dxgi_header);
+        }
+        if (ddsktx__read(&r, &dxgi_header, sizeof(dxgi_header)) != sizeof(dxgi_header)) {
+            return DDSKTX_ERROR_TRUNCATED;
+        }
+        dxgi_format = dxgi_header.dxgi_format;
+        array_size = dxgi_header.array_size;
+    }
+
+    if ((header.caps1 & DDSKTX__DDSCAPS_TEXTURE) == 0) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    bool cubemap = (header.caps2 & DDSKTX__DDSCAPS2_CUBEMAP) != 0;
+    if (cubemap && (header.caps2 & DDSKTX__DDSCAPS2_CUBEMAP_ALLSIDES) != DDSKTX__DDSCAPS2_CUBEMAP_ALLSIDES) {
+        return DDSKTX_ERROR_INVALID_CUBEMAP;
+    }
+    bool volume = (header.caps2 & DDSKTX__DDSCAPS2_VOLUME) != 0;
 
     ddsktx_format format = _DDSKTX_FORMAT_COUNT;
     bool has_alpha = (header.pixel_format.flags & DDSKTX__DDPF_ALPHA) != 0;
     bool srgb = false;
 
-    if (dxgi_format == 0) {
-        if ((header.pixel_format.flags & DDSKTX__DDPF_FOURCC) == DDSKTX__DDPF_FOURCC) {
-            int count = sizeof(k__translate_dds_fourcc)/sizeof(ddsktx__dds_translate_fourcc_format);
-            for (int i = 0; i < count; i++) {
-                if (k__translate_dds_fourcc[i].dds_format == header.pixel_format.fourcc) {
-                    format = k__translate_dds_fourcc[i].format;
-                    break;
-                }
-            }
+    if (dxgi_format == 0) {
+        if ((header.pixel_format.flags & DDSKTX__DDPF_FOURCC) == DDSKTX__DDPF_FOURCC) {
+            format = ddsktx__dds_fourcc_format(header.pixel_format.fourcc);
+        } else {
+            int count = sizeof(k__translate_dds_pixel)/sizeof(ddsktx__dds_translate_pixel_format);
+            for (int i = 0; i < count; i++) {
+                const ddsktx__dds_translate_pixel_format* f = &k__translate_dds_pixel[i];
+                if (f->bit_count == header.pixel_format.rgb_bit_count &&
+                    f->flags == header.pixel_format.flags &&
+                    f->bit_mask[0] == header.pixel_format.bit_mask[0] &&
+                    f->bit_mask[1] == header.pixel_format.bit_mask[1] &&
+                    f->bit_mask[2] == header.pixel_format.bit_mask[2] &&
+                    f->bit_mask[3] == header.pixel_format.bit_mask[3])
+                {
+                    format = f->format;
+                    break;
+                }
+            }
+        }
+    } else {
+        format = ddsktx__dxgi_format(dxgi_format, &srgb);
+    }
+
+    if (format == _DDSKTX_FORMAT_COUNT) {
+        return DDSKTX_ERROR_UNSUPPORTED_FORMAT;
+    }
+
+    ddsktx_memset(tc, 0x0, sizeof(ddsktx_texture_info));
+    tc->data_offset = r.offset;
+    tc->size_bytes = file_size - r.offset;
+    tc->format = format;
+    tc->width = (int)header.width;
+    tc->height = (int)header.height;
+    tc->depth = ddsktx__max(1, (int)header.depth);
+    tc->num_layers = ddsktx__max(1, (int)array_size);
+    tc->num_mips = (header.caps1 & DDSKTX__DDSCAPS_MIPMAP) ? (int)header.mip_count : 1;
+    tc->bpp = k__block_info[format].bpp;
+    if (has_alpha || k__formats_info[format].has_alpha)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_ALPHA;
+    if (cubemap)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_CUBEMAP;
+    if (volume)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_VOLUME;
+    if (srgb) 
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SRGB;
+    if (dxgi_format == DDSKTX__DDS_FORMAT_BC6H_SF16)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SIGNED;
+    tc->flags |= DDSKTX_TEXTURE_FLAG_DDS;
+
+    return DDSKTX_OK;
+}   
+
+static inline int ddsktx__num_blocks(int size, int block_dim, int min_blocks)
+{
+    int num_blocks = (size + block_dim - 1) / block_dim;
+    return num_blocks > min_blocks ? num_blocks : min_blocks;
+}
+
+// one layout rule for all formats: uncompressed formats are 1x1 'blocks' of bpp/8 bytes, compressed formats use
+// their own block dimensions (ASTC, PVRTC are not 4x4), so DDS, KTX, KTX2 and the subresource table agree
+static inline void ddsktx__calc_mip(ddsktx_format format, int width, int height, int* row_bytes, int64_t* mip_size)
+{
+    const ddsktx__block_info* binfo = &k__block_info[format];
+    if (width <= 0 || height <= 0 || binfo->block_size == 0) {
+        *row_bytes = 0;
+        *mip_size = 0;
+        return;
+    }
+
+    *row_bytes = ddsktx__num_blocks(width, binfo->block_width, binfo->min_block_x) * (int)binfo->block_size;
+    *mip_size = (int64_t)*row_bytes * ddsktx__num_blocks(height, binfo->block_height, binfo->min_block_y);
+}
+
+static inline void ddsktx__faces_slices(const ddsktx_texture_info* tc, int* num_faces, int* num_slices)
+{
+    ddsktx_assert(!((tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) && tc->depth > 1) && "textures must be either Cube or 3D");
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
+        *num_faces = DDSKTX_CUBE_FACE_COUNT;
+        *num_slices = 1;
+    } else {
+        *num_faces = 1;
+        *num_slices = tc->depth;
+    }
+}
+
+// size of all the images (layers, faces, slices) in a mip level. KTX2 stores each level in one piece
+static inline int64_t ddsktx__ktx2_level_size(const ddsktx_texture_info* tc, int mip_idx, int* row_bytes, 
+                                              int64_t* mip_size)
+{
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    ddsktx__calc_mip(tc->format, ddsktx__max(1, tc->width >> mip_idx), ddsktx__max(1, tc->height >> mip_idx), 
+                     row_bytes, mip_size);
+    return *mip_size * tc->num_layers * num_faces * num_slices;
+}
+
+// KTX2 levels are stored from the smallest mip to the largest one. Each level starts at lcm(texel_block_size, 4)
+// alignment, so for non-supercompressed files, level offsets can be calculated without reading the level index
+static int64_t ddsktx__ktx2_level_offset(const ddsktx_texture_info* tc, int mip_idx, int64_t* level_size)
+{
+    ddsktx_assert(tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE);
+
+    const ddsktx__block_info* binfo = &k__block_info[tc->format];
+    const int64_t block_size = tc->format < _DDSKTX_FORMAT_COMPRESSED ? binfo->block_size : ddsktx__max(1, binfo->bpp / 8);
+    int64_t align = block_size;
+    while (align % 4 != 0) {
+        align += block_size;
+    }
+
+    int64_t offset = tc->data_offset;
+    for (int mip = tc->num_mips - 1; mip >= mip_idx; mip--) {
+        int row_bytes;
+        int64_t mip_size;
+        int64_t size = ddsktx__ktx2_level_size(tc, mip, &row_bytes, &mip_size);
+        offset = ((offset + align - 1) / align) * align;    // mip-padding
+        if (mip == mip_idx) {
+            *level_size = size;
+            break;
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+// large enough for any real texture, small enough that row and mip sizes fit in int/int64 for all formats
+#define DDSKTX__MAX_DIMENSION (1 << 20)
+
+// header limits of ddsktx_validate, also used by the KTX2 parser, which calculates level sizes from the header
+static ddsktx_result ddsktx__check_header(const ddsktx_texture_info* tc)
+{
+    ddsktx_format format = tc->format;
+    if (format < 0 || format >= _DDSKTX_FORMAT_COUNT || format == _DDSKTX_FORMAT_COMPRESSED) {
+        return DDSKTX_ERROR_UNSUPPORTED_FORMAT;
+    }
+
+    if (tc->width < 1 || tc->width > DDSKTX__MAX_DIMENSION || tc->height < 1 || tc->height > DDSKTX__MAX_DIMENSION ||
+        tc->depth < 1 || tc->depth > DDSKTX__MAX_DIMENSION || tc->num_layers < 1 || tc->num_mips < 1) 
+    {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+    if ((tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) && tc->depth > 1) {
+        return DDSKTX_ERROR_INVALID_CUBEMAP;
+    }
+
+    int max_mips = 1;
+    for (int dim = ddsktx__max(tc->width, tc->height); dim > 1; dim >>= 1) {
+        max_mips++;
+    }
+    if (tc->num_mips > max_mips) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    // the first mip of all the images must fit in int64, KTX2 levels are that large
+    int num_faces, num_slices;
+    int row_bytes;
+    int64_t mip_size;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    ddsktx__calc_mip(format, tc->width, tc->height, &row_bytes, &mip_size);
+    int64_t num_images = (int64_t)tc->num_layers * num_faces * num_slices;
+    if (num_images * tc->num_mips > INT32_MAX || (mip_size > 0 && num_images > INT64_MAX / mip_size)) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+    return DDSKTX_OK;
+}
+
+static ddsktx_result ddsktx__parse_ktx2(ddsktx_texture_info* tc, ddsktx__reader r, int64_t file_size,
+                                        int64_t* required)
+{
+    static const uint8_t ktx2__id[] = { 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    ddsktx_memset(tc, 0x0, sizeof(ddsktx_texture_info));
+
+    r.offset = sizeof(uint32_t);
+    ddsktx__ktx2_header header;
+    if (required) {
+        *required = r.offset + DDSKTX__KTX2_HEADER_SIZE;
+    }
+    if (ddsktx__read(&r, &header, sizeof(header)) != DDSKTX__KTX2_HEADER_SIZE) {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+
+    if (ddsktx_memcmp(header.id, ktx2__id, sizeof(header.id)) != 0) {
+        return DDSKTX_ERROR_INVALID_HEADER;
+    }
+
+    if (header.supercompression_scheme == DDSKTX_SUPERCOMPRESSION_BASISLZ) {
+        return DDSKTX_ERROR_UNSUPPORTED_FEATURE;
+    }
+    if (header.supercompression_scheme > DDSKTX_SUPERCOMPRESSION_ZLIB) {
+        return DDSKTX_ERROR_UNSUPPORTED_FEATURE;
+    }
+
+    bool srgb;
+    ddsktx_format format = ddsktx__vk_format(header.vk_format, &srgb);
+
+    if (format == _DDSKTX_FORMAT_COUNT) {
+        return DDSKTX_ERROR_UNSUPPORTED_FORMAT;
+    }
+
+    if (header.face_count > 1 && header.face_count != DDSKTX_CUBE_FACE_COUNT) {
+        return DDSKTX_ERROR_INVALID_CUBEMAP;
+    }
+
+    if (header.face_count == DDSKTX_CUBE_FACE_COUNT && header.depth > 1) {
+        return DDSKTX_ERROR_INVALID_CUBEMAP;
+    }
+
+    if ((uint64_t)header.kvd_offset + header.kvd_size > (uint64_t)file_size) {
+        return DDSKTX_ERROR_INVALID_METADATA;
+    }
+
+    tc->format = format;
+    tc->width = ddsktx__max((int)header.width, 1);
+    tc->height = ddsktx__max((int)header.height, 1);
+    tc->depth = ddsktx__max((int)header.depth, 1);
+    tc->num_layers = ddsktx__max((int)header.layer_count, 1);
+    tc->num_mips = ddsktx__max((int)header.level_count, 1);
+    tc->bpp = k__block_info[format].bpp;
+    tc->metadata_offset = header.kvd_offset;
+    tc->metadata_size = (int)header.kvd_size;
+    tc->supercompression = (ddsktx_supercompression)header.supercompression_scheme;
+
+    if (header.face_count == DDSKTX_CUBE_FACE_COUNT)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_CUBEMAP;
+    if (header.depth > 1)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_VOLUME;
+    if (srgb)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SRGB;
+    if (header.vk_format == DDSKTX__VK_FORMAT_BC6H_SFLOAT_BLOCK)
+        tc->flags |= DDSKTX_TEXTURE_FLAG_SIGNED;
+    tc->flags |= k__formats_info[format].has_alpha ? DDSKTX_TEXTURE_FLAG_ALPHA : 0;
+    tc->flags |= DDSKTX_TEXTURE_FLAG_KTX2;
+
+    // level sizes are calculated from the header, so a level count above the mip chain would shift past the width
+    ddsktx_result result = ddsktx__check_header(tc);
+    if (result != DDSKTX_OK) {
+        return result;
+    }
+
+    // level index comes right after the header
+    const int64_t level_index_offset = r.offset;
+    if (required) {
+        *required = level_index_offset + tc->num_mips * (int64_t)sizeof(ddsktx__ktx2_level);
+    }
+
+    // the smallest level is the first one in the file
+    ddsktx__ktx2_level level;
+    r.offset = level_index_offset + (tc->num_mips - 1) * (int64_t)sizeof(ddsktx__ktx2_level);
+    if (ddsktx__read(&r, &level, sizeof(level)) != sizeof(level)) {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+    tc->data_offset = (int64_t)level.offset;
+    tc->size_bytes = file_size - tc->data_offset;
+    if (level.offset > (uint64_t)file_size) {
+        return DDSKTX_ERROR_INVALID_LAYOUT;
+    }
+
+    r.offset = level_index_offset;
+    for (int mip = 0; mip < tc->num_mips; mip++) {
+        if (ddsktx__read(&r, &level, sizeof(level)) != sizeof(level)) {
+            return DDSKTX_ERROR_TRUNCATED;
+        }
+
+        if (level.offset > (uint64_t)file_size || level.size > (uint64_t)file_size - level.offset) {
+            return DDSKTX_ERROR_INVALID_LAYOUT;
+        }
+
+        int row_bytes;
+        int64_t mip_size;
+        int64_t level_size = ddsktx__ktx2_level_size(tc, mip, &row_bytes, &mip_size);
+        if (tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE) {
+            int64_t calc_size;
+            if ((int64_t)level.offset != ddsktx__ktx2_level_offset(tc, mip, &calc_size) || 
+                (int64_t)level.size != level_size) 
+            {
+                return DDSKTX_ERROR_INVALID_LAYOUT;
+            }
+        } else if ((int64_t)level.uncompressed_size != level_size) {
+            return DDSKTX_ERROR_INVALID_LAYOUT;
+        }
+    }
+
+    return DDSKTX_OK;
+}
+
+// walks the texture layout until it reaches the requested sub-image, fills the sub_data (except 'buff') 
+// and returns it's offset in the file
+static int64_t ddsktx__find_sub(const ddsktx_texture_info* tc, ddsktx_sub_data* sub_data, ddsktx__reader r,
+                                int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub_data);
+    ddsktx_assert(array_idx < tc->num_layers);
+    ddsktx_assert(!((tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= DDSKTX_CUBE_FACE_COUNT)) && "invalid cube-face index");
+    ddsktx_assert(!(!(tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= tc->depth)) && "invalid depth-slice index");
+    ddsktx_assert(mip_idx < tc->num_mips);
+
+    // the layout of validated textures is already checked against the file 
+    const bool validated = (tc->flags & DDSKTX_TEXTURE_FLAG_VALIDATED) != 0;
+    r.offset = tc->data_offset;
+    ddsktx_format format = tc->format;
+
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    int slice_idx, face_idx;
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
+        slice_idx = 0;
+        face_idx = slice_face_idx;
+    } else {
+        slice_idx = slice_face_idx;
+        face_idx = 0;
+    }    
+
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_DDS) {
+        for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
+            for (int face = 0; face < num_faces; face++) {
+                int width = tc->width;
+                int height = tc->height;
+
+                for (int mip = 0, mip_count = tc->num_mips; mip < mip_count; mip++) {
+                    int row_bytes;
+                    int64_t mip_size;
+                    ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+                   
+                    for (int slice = 0; slice < num_slices; slice++) {
+                        if (layer == array_idx && mip == mip_idx && 
+                            slice == slice_idx && face_idx == face) 
+                        {
+                            sub_data->buff = NULL;
+                            sub_data->width = width;
+                            sub_data->height = height;
+                            sub_data->size_bytes = mip_size;
+                            sub_data->row_pitch_bytes = row_bytes;
+                            return r.offset;
+                        }
+
+                        r.offset += mip_size;
+                        ddsktx__count(subs_walked, 1);
+                        ddsktx_assert((validated || r.offset <= r.total) && "texture buffer overflow");
+                    } // foreach slice
+
+                    width >>= 1;
+                    height >>= 1;
+
+                    if (width == 0) {
+                        width = 1;
+                    }
+                    if (height == 0) {
+                        height = 1;
+                    }
+                }   // foreach mip
+            }   // foreach face
+        } // foreach array-item
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX) {
+        int width = tc->width;
+        int height = tc->height;
+
+        for (int mip = 0, c = tc->num_mips; mip < c; mip++) {
+            int row_bytes;
+            int64_t mip_size;
+            ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+            if (validated) {
+                r.offset += (int64_t)sizeof(uint32_t);
+            } else {
+                uint32_t image_size = 0;
+                ddsktx__read(&r, &image_size, sizeof(image_size)); 
+                // imageSize covers the whole mip, except for non-array cubemaps where it's the size of one face 
+                ddsktx_assert((int64_t)image_size == ((num_faces > 1 && tc->num_layers == 1) ? mip_size : 
+                              (mip_size*tc->num_layers*num_faces*num_slices)) && "image size mismatch");
+            }
+
+            for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
+                for (int face = 0; face < num_faces; face++) {
+                    for (int slice = 0; slice < num_slices; slice++) {
+                        if (layer == array_idx && mip == mip_idx &&
+                            slice == slice_idx && face_idx == face) 
+                        {
+                            sub_data->buff = NULL;
+                            sub_data->width = width;
+                            sub_data->height = height;
+                            sub_data->size_bytes = mip_size;
+                            sub_data->row_pitch_bytes = row_bytes;
+                            return r.offset;
+                        }
+
+                        r.offset += mip_size;
+                        ddsktx__count(subs_walked, 1);
+                        ddsktx_assert((validated || r.offset <= r.total) && "texture buffer overflow");
+                    }   // foreach slice
+
+                    
+                    r.offset = ddsktx__align_mask(r.offset, 3); // cube-padding
+                }   // foreach face
+            }   // foreach array-item
+
+            width >>= 1;
+            height >>= 1;
+
+            if (width == 0) {
+                width = 1;
+            }
+            if (height == 0) {
+                height = 1;
+            }
+            
+            r.offset = ddsktx__align_mask(r.offset, 3); // mip-padding
+        }   // foreach mip     
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX2) {
+        ddsktx_assert(tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE && 
+                      "supercompressed levels must be decoded first, see ddsktx_decode_level");
+        // KTX2 levels are tightly packed: layer -> face -> slice
+        int row_bytes;
+        int64_t mip_size, level_size;
+        r.offset = ddsktx__ktx2_level_offset(tc, mip_idx, &level_size);
+        ddsktx__ktx2_level_size(tc, mip_idx, &row_bytes, &mip_size);
+        r.offset += mip_size * ((array_idx*num_faces + face_idx)*num_slices + slice_idx);
+        ddsktx_assert((validated || r.offset + mip_size <= r.total) && "texture buffer overflow");
+
+        sub_data->buff = NULL;
+        sub_data->width = ddsktx__max(1, tc->width >> mip_idx);
+        sub_data->height = ddsktx__max(1, tc->height >> mip_idx);
+        sub_data->size_bytes = mip_size;
+        sub_data->row_pitch_bytes = row_bytes;
+        return r.offset;
+    } else {
+        ddsktx_assert(0 && "invalid file format");
+    }
+
+    return -1;
+}
+
+// checks the layout of the parsed texture against the file in one pass, sub-image sizes only grow the offset 
+// (at least 1 byte each), and every step is checked against the file size, so this is bounded by the file size
+static ddsktx_result ddsktx__validate(const ddsktx_texture_info* tc, ddsktx__reader r)
+{
+    ddsktx_result result = ddsktx__check_header(tc);
+    if (result != DDSKTX_OK) {
+        return result;
+    }
+
+    ddsktx_format format = tc->format;
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    if (tc->data_offset < 0 || tc->data_offset > r.total) {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+
+    int64_t offset = tc->data_offset;
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_DDS) {
+        for (int layer = 0; layer < tc->num_layers; layer++) {
+            for (int face = 0; face < num_faces; face++) {
+                int width = tc->width;
+                int height = tc->height;
+                for (int mip = 0; mip < tc->num_mips; mip++) {
+                    int row_bytes;
+                    int64_t mip_size;
+                    ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+                    offset += mip_size * num_slices;
+                    if (offset > r.total) {
+                        return DDSKTX_ERROR_TRUNCATED;
+                    }
+
+                    width = ddsktx__max(1, width >> 1);
+                    height = ddsktx__max(1, height >> 1);
+                }
+            }
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX) {
+        int width = tc->width;
+        int height = tc->height;
+        for (int mip = 0; mip < tc->num_mips; mip++) {
+            int row_bytes;
+            int64_t mip_size;
+            ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+            uint32_t image_size;
+            r.offset = offset;
+            if (ddsktx__read(&r, &image_size, sizeof(image_size)) != sizeof(image_size)) {
+                return DDSKTX_ERROR_TRUNCATED;
+            }
+            // imageSize covers the whole mip, except for non-array cubemaps where it's the size of one face 
+            int64_t expected_size = (num_faces > 1 && tc->num_layers == 1) ? mip_size : 
+                                    (mip_size*tc->num_layers*num_faces*num_slices);
+            if ((int64_t)image_size != expected_size) {
+                return DDSKTX_ERROR_INVALID_LAYOUT;
+            }
+
+            offset += (int64_t)sizeof(uint32_t);
+            for (int layer = 0; layer < tc->num_layers; layer++) {
+                for (int face = 0; face < num_faces; face++) {
+                    offset += mip_size * num_slices;
+                    // the padding after the last image is not required to be in the file
+                    if (offset > r.total) {
+                        return DDSKTX_ERROR_TRUNCATED;
+                    }
+                    offset = ddsktx__align_mask(offset, 3); // cube-padding
+                }
+            }
+            offset = ddsktx__align_mask(offset, 3);     // mip-padding
+
+            width = ddsktx__max(1, width >> 1);
+            height = ddsktx__max(1, height >> 1);
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX2) {
+        // the parser already checks the level index against the layout and the file size, 
+        // levels are stored from the smallest mip, so the first mip is the last one in the file
+        if (tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE) {
+            int64_t level_size;
+            int64_t level_offset = ddsktx__ktx2_level_offset(tc, 0, &level_size);
+            if (level_offset + level_size > r.total) {
+                return DDSKTX_ERROR_TRUNCATED;
+            }
+        }
+    } else {
+        return DDSKTX_ERROR_UNKNOWN_CONTAINER;
+    }
+
+    return DDSKTX_OK;
+}
+
+ddsktx_result ddsktx_validate(ddsktx_texture_info* tc, const void* file_data, size_t size)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(file_data);
+    ddsktx_assert(size > 0);
+
+    ddsktx__mem_blob blob = { (const uint8_t*)file_data, (int64_t)size };
+    ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+    ddsktx__reader r = { &io, blob.size, 0 };
+
+    tc->flags &= ~(unsigned int)DDSKTX_TEXTURE_FLAG_VALIDATED;
+    ddsktx_result result = ddsktx__validate(tc, r);
+    if (result == DDSKTX_OK) {
+        tc->flags |= DDSKTX_TEXTURE_FLAG_VALIDATED;
+    }
+    return result;
+}
+
+void ddsktx_get_sub64(const ddsktx_texture_info* tc, ddsktx_sub_data* sub_data, 
+                   const void* file_data, size_t size,
+                   int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(file_data);
+    ddsktx_assert(size > 0);
+
+    ddsktx__mem_blob blob = { (const uint8_t*)file_data, (int64_t)size };
+    ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+    ddsktx__reader r = { &io, blob.size, 0 };
+
+    DDSKTX_PROFILE_BEGIN(ddsktx_get_sub);
+    int64_t offset = ddsktx__find_sub(tc, sub_data, r, array_idx, slice_face_idx, mip_idx);
+    bool in_range = offset >= 0 && 
+        ((tc->flags & DDSKTX_TEXTURE_FLAG_VALIDATED) || offset + sub_data->size_bytes <= blob.size);
+    sub_data->buff = in_range ? (blob.buff + offset) : NULL;
+    ddsktx__count(subs_returned, in_range ? 1 : 0);
+    DDSKTX_PROFILE_END(ddsktx_get_sub);
+}
+
+bool ddsktx_read_sub(const ddsktx_texture_info* tc, const ddsktx_reader* reader,
+                     void* dst, int64_t dst_size, ddsktx_sub_data* sub_data,
+                     int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(reader);
+    ddsktx_assert(dst);
+
+    ddsktx__reader r = { reader, reader->size(reader->user), 0 };
+    DDSKTX_PROFILE_BEGIN(ddsktx_get_sub);
+    int64_t offset = ddsktx__find_sub(tc, sub_data, r, array_idx, slice_face_idx, mip_idx);
+    DDSKTX_PROFILE_END(ddsktx_get_sub);
+    if (offset < 0 || dst_size < sub_data->size_bytes || offset + sub_data->size_bytes > r.total) {
+        return false;
+    }
+
+    if (reader->read(reader->user, offset, dst, sub_data->size_bytes) != sub_data->size_bytes) {
+        return false;
+    }
+    sub_data->buff = dst;
+    ddsktx__count(subs_returned, 1);
+    return true;
+}
+
+
+int ddsktx_num_subresources(const ddsktx_texture_info* tc)
+{
+    ddsktx_assert(tc);
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    return tc->num_layers * num_faces * tc->num_mips * num_slices;
+}
+
+int ddsktx_sub_index(const ddsktx_texture_info* tc, int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(array_idx < tc->num_layers);
+    ddsktx_assert(!((tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= DDSKTX_CUBE_FACE_COUNT)) && "invalid cube-face index");
+    ddsktx_assert(!(!(tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= tc->depth)) && "invalid depth-slice index");
+    ddsktx_assert(mip_idx < tc->num_mips);
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    int face_idx = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? slice_face_idx : 0;
+    int slice_idx = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? 0 : slice_face_idx;
+
+    return ((array_idx*num_faces + face_idx)*tc->num_mips + mip_idx)*num_slices + slice_idx;
+}
+
+bool ddsktx_build_subresource_table(const ddsktx_texture_info* tc, ddsktx_sub_entry* entries, int max_entries)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(entries);
+
+    ddsktx_format format = tc->format;
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+
+    if (max_entries < ddsktx_num_subresources(tc)) {
+        return false;
+    }
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    const int num_layers = tc->num_layers;
+    const int num_mips = tc->num_mips;
+    int64_t offset = tc->data_offset;
+
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_DDS) {
+        // DDS is stored in the same order as the table, so just fill the entries linearly
+        ddsktx_sub_entry* e = entries;
+        for (int layer = 0; layer < num_layers; layer++) {
+            for (int face = 0; face < num_faces; face++) {
+                int width = tc->width;
+                int height = tc->height;
+
+                for (int mip = 0; mip < num_mips; mip++) {
+                    int row_bytes;
+                    int64_t mip_size;
+                    ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+                    for (int slice = 0; slice < num_slices; slice++, e++) {
+                        e->offset = offset;
+                        e->size_bytes = mip_size;
+                        e->row_pitch_bytes = row_bytes;
+                        e->width = width;
+                        e->height = height;
+                        offset += mip_size;
+                    }
+
+                    width = ddsktx__max(1, width >> 1);
+                    height = ddsktx__max(1, height >> 1);
+                }
+            }
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX) {
+        int width = tc->width;
+        int height = tc->height;
+
+        for (int mip = 0; mip < num_mips; mip++) {
+            int row_bytes;
+            int64_t mip_size;
+            ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+            offset += (int64_t)sizeof(uint32_t);    // image_size
+            for (int layer = 0; layer < num_layers; layer++) {
+                for (int face = 0; face < num_faces; face++) {
+                    ddsktx_sub_entry* e = &entries[((layer*num_faces + face)*num_mips + mip)*num_slices];
+                    for (int slice = 0; slice < num_slices; slice++, e++) {
+                        e->offset = offset;
+                        e->size_bytes = mip_size;
+                        e->row_pitch_bytes = row_bytes;
+                        e->width = width;
+                        e->height = height;
+                        offset += mip_size;
+                    }
+                    offset = ddsktx__align_mask(offset, 3); // cube-padding
+                }
+            }
+
+            width = ddsktx__max(1, width >> 1);
+            height = ddsktx__max(1, height >> 1);
+            offset = ddsktx__align_mask(offset, 3); // mip-padding
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX2) {
+        // for supercompressed files, offsets are relative to the start of each decoded level
+        const bool supercompressed = tc->supercompression != DDSKTX_SUPERCOMPRESSION_NONE;
+        for (int mip = 0; mip < num_mips; mip++) {
+            int row_bytes;
+            int64_t mip_size, level_size;
+            int64_t level_offset = supercompressed ? 0 : ddsktx__ktx2_level_offset(tc, mip, &level_size);
+            int64_t level_end = level_offset + ddsktx__ktx2_level_size(tc, mip, &row_bytes, &mip_size);
+            int width = ddsktx__max(1, tc->width >> mip);
+            int height = ddsktx__max(1, tc->height >> mip);
+
+            for (int layer = 0; layer < num_layers; layer++) {
+                for (int face = 0; face < num_faces; face++) {
+                    ddsktx_sub_entry* e = &entries[((layer*num_faces + face)*num_mips + mip)*num_slices];
+                    for (int slice = 0; slice < num_slices; slice++, e++) {
+                        e->offset = level_offset;
+                        e->size_bytes = mip_size;
+                        e->row_pitch_bytes = row_bytes;
+                        e->width = width;
+                        e->height = height;
+                        level_offset += mip_size;
+                    }
+                }
+            }
+
+            if (!supercompressed) {
+                offset = ddsktx__max(offset, level_end);
+            }
+        }
+    } else {
+        ddsktx_assert(0 && "invalid file format");
+        return false;
+    }
+
+    // truncated file
+    if (offset > tc->data_offset + tc->size_bytes) {
+        return false;
+    }
+    return true;
+}
+
+void ddsktx_get_sub_indexed(const ddsktx_texture_info* tc, const ddsktx_sub_entry* table,
+                            ddsktx_sub_data* sub_data, const void* file_data,
+                            int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(table);
+    ddsktx_assert(sub_data);
+    ddsktx_assert(file_data);
+
+    const ddsktx_sub_entry* e = &table[ddsktx_sub_index(tc, array_idx, slice_face_idx, mip_idx)];
+    sub_data->buff = (const uint8_t*)file_data + e->offset;
+    sub_data->width = e->width;
+    sub_data->height = e->height;
+    sub_data->size_bytes = e->size_bytes;
+    sub_data->row_pitch_bytes = e->row_pitch_bytes;
+}
+
+static inline int64_t ddsktx__align_up(int64_t value, int64_t alignment)
+{
+    return alignment > 1 ? ((value + alignment - 1) / alignment) * alignment : value;
+}
+
+int64_t ddsktx_staging_layout(const ddsktx_texture_info* tc, const ddsktx_staging_policy* policy,
+                              ddsktx_staging_footprint* footprints, int max_footprints)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(policy);
+
+    ddsktx_format format = tc->format;
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+
+    if (footprints && max_footprints < ddsktx_num_subresources(tc)) {
+        return -1;
+    }
+
+    // copies start at whole blocks (pixels), Vulkan requires the offset to be a multiple of the texel block size
+    const ddsktx__block_info* binfo = &k__block_info[format];
+    int64_t block_bytes = format < _DDSKTX_FORMAT_COMPRESSED ? binfo->block_size : ddsktx__max(1, binfo->bpp/8);
+    int64_t offset_align = ddsktx__max((int64_t)policy->sub_offset_align, 1);
+    if (offset_align % block_bytes != 0) {
+        offset_align *= block_bytes;
+    }
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    int64_t offset = 0;
+    ddsktx_staging_footprint* fp = footprints;
+    for (int layer = 0; layer < tc->num_layers; layer++) {
+        for (int face = 0; face < num_faces; face++) {
+            int width = tc->width;
+            int height = tc->height;
+
+            for (int mip = 0; mip < tc->num_mips; mip++) {
+                int row_bytes;
+                int64_t mip_size;
+                ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+                int row_pitch = (int)ddsktx__align_up(row_bytes, policy->row_pitch_align);
+                int num_rows = (int)(mip_size / row_bytes);
+                int64_t slice_size = (int64_t)row_pitch * num_rows;
+
+                offset = ddsktx__align_up(offset, offset_align);
+                for (int slice = 0; slice < num_slices; slice++) {
+                    if (fp) {
+                        fp->offset = offset;
+                        fp->size_bytes = slice_size;
+                        fp->row_pitch_bytes = row_pitch;
+                        fp->row_bytes = row_bytes;
+                        fp->num_rows = num_rows;
+                        fp->width = width;
+                        fp->height = height;
+                        fp++;
+                    }
+                    offset += slice_size;
+                }
+
+                width = ddsktx__max(1, width >> 1);
+                height = ddsktx__max(1, height >> 1);
+            }
+        }
+    }
+
+    return offset;
+}
+
+void ddsktx_copy_sub(const ddsktx_sub_data* sub, void* dst, int dst_row_pitch)
+{
+    ddsktx_assert(sub);
+    ddsktx_assert(dst);
+    ddsktx_assert(dst_row_pitch >= sub->row_pitch_bytes);
+
+    const uint8_t* src = (const uint8_t*)sub->buff;
+    if (dst_row_pitch == sub->row_pitch_bytes) {
+        ddsktx_memcpy(dst, src, (size_t)sub->size_bytes);
+        return;
+    }
+
+    int num_rows = (int)(sub->size_bytes / sub->row_pitch_bytes);
+    uint8_t* d = (uint8_t*)dst;
+    for (int y = 0; y < num_rows; y++) {
+        ddsktx_memcpy(d, src, (size_t)sub->row_pitch_bytes);
+        src += sub->row_pitch_bytes;
+        d += dst_row_pitch;
+    }
+}
+
+// appends [offset, offset+size) to the ranges, merges it with the last one if they are adjacent
+static inline void ddsktx__add_range(ddsktx_file_range* ranges, int max_ranges, int* num_ranges, 
+                                     int64_t* range_end, int64_t offset, int64_t size)
+{
+    if (*num_ranges > 0 && *range_end == offset) {
+        if (*num_ranges <= max_ranges) {
+            ranges[*num_ranges - 1].size += size;
+        }
+    } else {
+        if (*num_ranges < max_ranges) {
+            ranges[*num_ranges].offset = offset;
+            ranges[*num_ranges].size = size;
+        }
+        ++(*num_ranges);
+    }
+    *range_end = offset + size;
+}
+
+int ddsktx_get_tile_spans(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub,
+                          int x, int y, int width, int height, ddsktx_rect* aligned,
+                          ddsktx_file_range* spans, int max_spans)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub);
+    ddsktx_assert(spans || max_spans == 0);
+
+    ddsktx_format format = tc->format;
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+
+    // clip to the mip
+    int x1 = ddsktx__min(x + width, sub->width);
+    int y1 = ddsktx__min(y + height, sub->height);
+    x = ddsktx__max(x, 0);
+    y = ddsktx__max(y, 0);
+    if (x >= x1 || y >= y1 || sub->row_pitch_bytes <= 0) {
+        return 0;
+    }
+
+    const ddsktx__block_info* binfo = &k__block_info[format];
+    int num_spans = 0;
+    int64_t range_end = 0;
+    if (format >= DDSKTX_FORMAT_PTC12 && format <= DDSKTX_FORMAT_PTC24) {
+        if (aligned) {
+            aligned->x = 0;
+            aligned->y = 0;
+            aligned->width = sub->width;
+            aligned->height = sub->height;
+        }
+        ddsktx__add_range(spans, max_spans, &num_spans, &range_end, 0, sub->size_bytes);
+        return num_spans;
+    }
+
+    // padding blocks of small mips (min_block_x/y) are outside sub->width/height, they are never included
+    const int bw = binfo->block_width;
+    const int bh = binfo->block_height;
+    const int bx0 = x / bw;
+    const int by0 = y / bh;
+    const int bx1 = (x1 + bw - 1) / bw;
+    const int by1 = (y1 + bh - 1) / bh;
+    if (aligned) {
+        aligned->x = bx0*bw;
+        aligned->y = by0*bh;
+        aligned->width = (bx1 - bx0)*bw;
+        aligned->height = (by1 - by0)*bh;
+    }
+
+    const int64_t pitch = sub->row_pitch_bytes;
+    const int64_t span_size = (int64_t)(bx1 - bx0)*binfo->block_size;
+    for (int by = by0; by < by1; by++) {
+        ddsktx__add_range(spans, max_spans, &num_spans, &range_end, 
+                          by*pitch + (int64_t)bx0*binfo->block_size, span_size);
+    }
+    return num_spans;
+}
+
+// Address bits of the 64KB standard swizzle tiles, from bit 0: '0' is a byte inside the element, X/Y are the next bit
+// of the element x/y coordinate. One pattern per element size (1, 2, 4, 8, 16 bytes), the same as the D3D12 spec
+static const char* k__swizzle_64kb_standard[5] = {
+    "XXXXYYYYXYXYXYXY",     // 256x256
+    "0XXXYYYXYXYXYXYX",     // 256x128
+    "00XXYYXYXYXYXYXY",     // 128x128
+    "000XYYXXYXYXYXYX",     // 128x64
+    "0000YXYXXYXYXYXY"      // 64x64
+};
+
+typedef struct ddsktx__swizzle_layout
+{
+    uint64_t    x_mask;         // address bits (in bytes, inside a tile) of the element x coordinate
+    uint64_t    y_mask;
+    int         tile_shift_x;   // log2 of tile width/height in elements
+    int         tile_shift_y;
+    int         tiles_x;
+    int         tiles_y;
+    int64_t     tile_size;
+    int         blocks_x;
+    int         blocks_y;
+    int         elem_size;
+    int         run;            // number of elements that are contiguous in x
+} ddsktx__swizzle_layout;
+
+static inline int ddsktx__log2(uint32_t n)
+{
+    int r = 0;
+    while ((1u << r) < n) {
+        r++;
+    }
+    return r;
+}
+
+// spreads the bits of 'value' to the set bits of 'mask' (pdep)
+static inline uint64_t ddsktx__deposit_bits(uint64_t value, uint64_t mask)
+{
+    uint64_t r = 0;
+    for (uint64_t bit = 1; mask; bit <<= 1) {
+        uint64_t lowest = mask & (~mask + 1);
+        if (value & bit) {
+            r |= lowest;
+        }
+        mask ^= lowest;
+    }
+    return r;
+}
+
+static bool ddsktx__swizzle_layout_init(ddsktx__swizzle_layout* l, const ddsktx_texture_info* tc, 
+                                        const ddsktx_sub_data* sub, ddsktx_swizzle swizzle)
+{
+    ddsktx_format format = tc->format;
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+    ddsktx_assert(swizzle < _DDSKTX_SWIZZLE_COUNT);
+
+    const int elem_size = k__block_info[format].block_size;
+    const int elem_shift = ddsktx__log2((uint32_t)elem_size);
+    if ((format >= DDSKTX_FORMAT_PTC12 && format <= DDSKTX_FORMAT_PTC24) || (1 << elem_shift) != elem_size || 
+        elem_shift > 4 || sub->row_pitch_bytes <= 0) {
+        return false;
+    }
+
+    ddsktx_memset(l, 0x0, sizeof(ddsktx__swizzle_layout));
+    l->elem_size = elem_size;
+    l->blocks_x = sub->row_pitch_bytes / elem_size;
+    l->blocks_y = (int)(sub->size_bytes / sub->row_pitch_bytes);
+
+    if (swizzle == DDSKTX_SWIZZLE_MORTON) {
+        int bits_x = ddsktx__log2((uint32_t)l->blocks_x);
+        int bits_y = ddsktx__log2((uint32_t)l->blocks_y);
+        int bit = elem_shift;
+        for (int i = 0; i < bits_x || i < bits_y; i++) {
+            if (i < bits_x) {
+                l->x_mask |= 1ull << bit++;
+            }
+            if (i < bits_y) {
+                l->y_mask |= 1ull << bit++;
+            }
+        }
+        l->tile_shift_x = bits_x;
+        l->tile_shift_y = bits_y;
+        l->tile_size = 1ll << bit;
+    } else {
+        const char* pattern = k__swizzle_64kb_standard[elem_shift];
+        for (int bit = 0; bit < 16; bit++) {
+            if (pattern[bit] == 'X') {
+                l->x_mask |= 1ull << bit;
+                l->tile_shift_x++;
+            } else if (pattern[bit] == 'Y') {
+                l->y_mask |= 1ull << bit;
+                l->tile_shift_y++;
+            }
+        }
+        l->tile_size = 1 << 16;
+    }
+
+    l->tiles_x = (l->blocks_x + (1 << l->tile_shift_x) - 1) >> l->tile_shift_x;
+    l->tiles_y = (l->blocks_y + (1 << l->tile_shift_y) - 1) >> l->tile_shift_y;
+
+    // x bits that follow the element bytes directly are runs of elements that can be copied at once 
+    l->run = 1;
+    while (l->x_mask & ((uint64_t)l->elem_size*l->run)) {
+        l->run <<= 1;
+    }
+    return true;
+}
+
+int64_t ddsktx_swizzled_size(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_swizzle swizzle)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub);
+
+    ddsktx__swizzle_layout l;
+    if (!ddsktx__swizzle_layout_init(&l, tc, sub, swizzle)) {
+        return -1;
+    }
+    return l.tile_size * l.tiles_x * l.tiles_y;
+}
+
+bool ddsktx_swizzle_sub(const ddsktx_texture_info* tc, const ddsktx_sub_data* sub, ddsktx_swizzle swizzle,
+                        void* dst, int64_t dst_size)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(sub);
+    ddsktx_assert(sub->buff);
+    ddsktx_assert(dst);
+
+    ddsktx__swizzle_layout l;
+    if (!ddsktx__swizzle_layout_init(&l, tc, sub, swizzle)) {
+        return false;
+    }
+    int64_t size = l.tile_size * l.tiles_x * l.tiles_y;
+    if (dst_size < size) {
+        return false;
+    }
+    if (((int64_t)l.tiles_x << l.tile_shift_x) != l.blocks_x || ((int64_t)l.tiles_y << l.tile_shift_y) != l.blocks_y) {
+        ddsktx_memset(dst, 0x0, (size_t)size);
+    }
+
+    // the address of an element is tile offset + deposit(x) + deposit(y), deposited coordinates are incremented 
+    // without the bit loop: filling the holes of the mask with ones carries the addition over to the next bit
+    // runs are 16 bytes for the standard swizzle, so the inner copy is one vector load/store
+    const uint8_t* src = (const uint8_t*)sub->buff;
+    uint8_t* d = (uint8_t*)dst;
+    const int tile_w = 1 << l.tile_shift_x;
+    const int run_bytes = l.run * l.elem_size;
+    const uint64_t run_step = ddsktx__deposit_bits((uint64_t)l.run, l.x_mask);
+    for (int by = 0; by < l.blocks_y; by++) {
+        const uint8_t* row = src + (int64_t)by * sub->row_pitch_bytes;
+        uint8_t* tile_row = d + (int64_t)(by >> l.tile_shift_y) * l.tiles_x * l.tile_size;
+        uint64_t dy = ddsktx__deposit_bits((uint64_t)(by & ((1 << l.tile_shift_y) - 1)), l.y_mask);
+
+        for (int tx = 0; tx < l.tiles_x; tx++) {
+            uint8_t* tile = tile_row + tx * l.tile_size + dy;
+            int num = ddsktx__min(tile_w, l.blocks_x - tx*tile_w);
+            const uint8_t* s = row + (int64_t)tx * tile_w * l.elem_size;
+            uint64_t dx = 0;
+            int x = 0;
+            if (run_bytes == 16) {
+                for (; x + l.run <= num; x += l.run) {
+                    ddsktx_memcpy(tile + dx, s, 16);
+                    s += 16;
+                    dx = ((dx | ~l.x_mask) + run_step) & l.x_mask;
+                }
+            }
+            for (; x < num; x += l.run) {
+                int n = ddsktx__min(l.run, num - x);
+                ddsktx_memcpy(tile + dx, s, (size_t)(n * l.elem_size));
+                s += run_bytes;
+                dx = ((dx | ~l.x_mask) + run_step) & l.x_mask;
+            }
+        }
+    }
+    return true;
+}
+
+void ddsktx_get_sub(const ddsktx_texture_info* tc, ddsktx_sub_data* sub_data, 
+                 const void* file_data, int size,
+                 int array_idx, int slice_face_idx, int mip_idx)
+{
+    ddsktx_assert(size > 0);
+    ddsktx_get_sub64(tc, sub_data, file_data, (size_t)size, array_idx, slice_face_idx, mip_idx);
+}
+
+static ddsktx_result ddsktx__parse(ddsktx_texture_info* tc, const ddsktx_reader* io, int64_t size, 
+                                   int64_t file_size, int64_t* required)
+{
+    ddsktx__reader r = {io, size, 0};
+    
+    // Read file flag and determine the file type
+    uint32_t file_flag = 0;
+    if (required) {
+        *required = sizeof(file_flag);
+    }
+    if (ddsktx__read(&r, &file_flag, sizeof(file_flag)) != sizeof(file_flag)) {
+        return DDSKTX_ERROR_TRUNCATED;
+    }
+
+    ddsktx__count(num_parsed, 1);
+    ddsktx_result result;
+    switch (file_flag) {
+    case DDSKTX__DDS_MAGIC: {
+        DDSKTX_PROFILE_BEGIN(ddsktx_parse_dds);
+        result = ddsktx__parse_dds(tc, r, file_size, required);
+        DDSKTX_PROFILE_END(ddsktx_parse_dds);
+        break;
+    }
+    case DDSKTX__KTX_MAGIC: {
+        // KTX and KTX2 identifiers share the first 4 bytes, peek the version to tell them apart
+        // if the peek fails, the KTX parser reports the truncated header
+        uint8_t version[3] = {0};
+        ddsktx__reader peek = r;
+        ddsktx__read(&peek, version, sizeof(version));
+        if (version[0] == 0x20 && version[1] == 0x32 && version[2] == 0x30) {
+            DDSKTX_PROFILE_BEGIN(ddsktx_parse_ktx2);
+            result = ddsktx__parse_ktx2(tc, r, file_size, required);
+            DDSKTX_PROFILE_END(ddsktx_parse_ktx2);
+        } else {
+            DDSKTX_PROFILE_BEGIN(ddsktx_parse_ktx);
+            result = ddsktx__parse_ktx(tc, r, file_size, required);
+            DDSKTX_PROFILE_END(ddsktx_parse_ktx);
+        }
+        break;
+    }
+    default:
+        result = DDSKTX_ERROR_UNKNOWN_CONTAINER;
+        break;
+    }
+    return result;
+}
+
+int ddsktx_get_mip_ranges(const ddsktx_texture_info* tc, int first_mip, int num_mips,
+                          ddsktx_file_range* ranges, int max_ranges)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(first_mip >= 0 && num_mips > 0 && first_mip + num_mips <= tc->num_mips);
+    ddsktx_assert(ranges || max_ranges == 0);
+
+    ddsktx_format format = tc->format;
+    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
+
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    const int end_mip = first_mip + num_mips;
+    int64_t offset = tc->data_offset;
+    int64_t range_end = 0;
+    int num_ranges = 0;
+
+    if (tc->flags & DDSKTX_TEXTURE_FLAG_DDS) {
+        for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
+            for (int face = 0; face < num_faces; face++) {
+                int width = tc->width;
+                int height = tc->height;
+
+                for (int mip = 0, mip_count = tc->num_mips; mip < mip_count; mip++) {
+                    int row_bytes;
+                    int64_t mip_size;
+                    ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+                    mip_size *= num_slices;
+
+                    if (mip >= first_mip && mip < end_mip) {
+                        ddsktx__add_range(ranges, max_ranges, &num_ranges, &range_end, offset, mip_size);
+                    }
+                    offset += mip_size;
+
+                    width = ddsktx__max(1, width >> 1);
+                    height = ddsktx__max(1, height >> 1);
+                }
+            }
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX) {
+        int width = tc->width;
+        int height = tc->height;
+
+        for (int mip = 0; mip < end_mip; mip++) {
+            int row_bytes;
+            int64_t mip_size;
+            ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+            // all layers and faces of each mip are stored together, with the image_size and paddings
+            int64_t start = offset;
+            offset += (int64_t)sizeof(uint32_t);
+            for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
+                for (int face = 0; face < num_faces; face++) {
+                    offset += mip_size * num_slices;
+                    offset = ddsktx__align_mask(offset, 3); // cube-padding
+                }
+            }
+            offset = ddsktx__align_mask(offset, 3); // mip-padding
+
+            if (mip >= first_mip) {
+                ddsktx__add_range(ranges, max_ranges, &num_ranges, &range_end, start, offset - start);
+            }
+
+            width = ddsktx__max(1, width >> 1);
+            height = ddsktx__max(1, height >> 1);
+        }
+    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX2) {
+        ddsktx_assert(tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE && 
+                      "use ddsktx_get_level_range for supercompressed files");
+        // levels are stored from the smallest to the largest, the ranges include the mip-padding in between
+        for (int mip = end_mip - 1; mip >= first_mip; mip--) {
+            int64_t level_size;
+            int64_t start = ddsktx__ktx2_level_offset(tc, mip, &level_size);
+            int64_t end = start + level_size;
+            if (mip > first_mip) {
+                end = ddsktx__ktx2_level_offset(tc, mip - 1, &level_size);
+            }
+            ddsktx__add_range(ranges, max_ranges, &num_ranges, &range_end, start, end - start);
+        }
+    } else {
+        ddsktx_assert(0 && "invalid file format");
+    }
+
+    return num_ranges;
+}
+
+bool ddsktx_get_level_range(const ddsktx_texture_info* tc, const void* file_data, size_t size, int mip_idx,
+                            ddsktx_file_range* range, int64_t* uncompressed_size)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(file_data);
+    ddsktx_assert(range);
+    ddsktx_assert(mip_idx >= 0 && mip_idx < tc->num_mips);
+
+    if (!(tc->flags & DDSKTX_TEXTURE_FLAG_KTX2)) {
+        return false;
+    }
+
+    ddsktx__mem_blob blob = { (const uint8_t*)file_data, (int64_t)size };
+    ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+    ddsktx__reader r = { &io, blob.size, 
+                         (int64_t)sizeof(uint32_t) + DDSKTX__KTX2_HEADER_SIZE + mip_idx*(int64_t)sizeof(ddsktx__ktx2_level) };
+
+    ddsktx__ktx2_level level;
+    if (ddsktx__read(&r, &level, sizeof(level)) != sizeof(level)) {
+        return false;
+    }
+
+    range->offset = (int64_t)level.offset;
+    range->size = (int64_t)level.size;
+    if (uncompressed_size) {
+        *uncompressed_size = level.uncompressed_size != 0 ? (int64_t)level.uncompressed_size : (int64_t)level.size;
+    }
+    return true;
+}
+
+bool ddsktx_decode_level(const ddsktx_texture_info* tc, int mip_idx, const void* src, int64_t src_size,
+                         void* dst, int64_t dst_size, ddsktx_decode_cb* decode_cb, void* user)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(src);
+    ddsktx_assert(dst);
+    ddsktx_assert(mip_idx >= 0 && mip_idx < tc->num_mips);
+
+    int row_bytes;
+    int64_t mip_size;
+    int64_t level_size = ddsktx__ktx2_level_size(tc, mip_idx, &row_bytes, &mip_size); 
+    if (!(tc->flags & DDSKTX_TEXTURE_FLAG_KTX2) || dst_size < level_size) {
+        return false;
+    }
+
+    if (tc->supercompression == DDSKTX_SUPERCOMPRESSION_NONE) {
+        if (src_size < level_size) {
+            return false;
+        }
+        ddsktx_memcpy(dst, src, (size_t)level_size);
+        return true;
+    }
+
+    ddsktx_assert(decode_cb);
+    return decode_cb(tc->supercompression, src, src_size, dst, level_size, user);
+}
+
+// error messages are only copied on the public bool API, the parsers just return the code
+static inline bool ddsktx__result(ddsktx_result result, ddsktx_error* err)
+{
+    if (result != DDSKTX_OK && err) {
+        ddsktx_strcpy(err->msg, ddsktx_error_str(result));
+    }
+    return result == DDSKTX_OK;
+}
+
+ddsktx_result ddsktx_parse_result(ddsktx_texture_info* tc, const void* file_data, size_t size)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(file_data);
+    ddsktx_assert(size > 0);
+
+    ddsktx__mem_blob blob = { (const uint8_t*)file_data, (int64_t)size };
+    ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+    return ddsktx__parse(tc, &io, blob.size, blob.size, NULL);
+}
+
+bool ddsktx_parse64(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err)
+{
+    return ddsktx__result(ddsktx_parse_result(tc, file_data, size), err);
+}
+
+bool ddsktx_parse_strict(ddsktx_texture_info* tc, const void* file_data, size_t size, ddsktx_error* err)
+{
+    ddsktx_result result = ddsktx_parse_result(tc, file_data, size);
+    if (result == DDSKTX_OK) {
+        result = ddsktx_validate(tc, file_data, size);
+    }
+    return ddsktx__result(result, err);
+}
+
+bool ddsktx_parse_reader(ddsktx_texture_info* tc, const ddsktx_reader* reader, ddsktx_error* err)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(reader);
+    ddsktx_assert(reader->read);
+    ddsktx_assert(reader->size);
+
+    int64_t size = reader->size(reader->user);
+    return ddsktx__result(ddsktx__parse(tc, reader, size, size, NULL), err);
+}
+
+bool ddsktx_parse_header(ddsktx_texture_info* tc, const void* header_data, int header_size, 
+                         int64_t file_size, int64_t* required_size, ddsktx_error* err)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(header_data);
+    ddsktx_assert(header_size > 0);
+    ddsktx_assert(file_size >= header_size);
+
+    ddsktx__mem_blob blob = { (const uint8_t*)header_data, header_size };
+    ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+    return ddsktx__result(ddsktx__parse(tc, &io, blob.size, file_size, required_size), err);
+}
+
+bool ddsktx_parse(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err)
+{
+    ddsktx_assert(size > 0);
+    return ddsktx_parse64(tc, file_data, (size_t)size, err);
+}
+
+int ddsktx_parse_batch(const ddsktx_blob* blobs, int count, ddsktx_texture_info* infos, ddsktx_result* results)
+{
+    ddsktx_assert(count == 0 || (blobs && infos && results));
+
+    int num_parsed = 0;
+    for (int i = 0; i < count; i++) {
+        ddsktx__mem_blob blob = { (const uint8_t*)blobs[i].data, (int64_t)blobs[i].size };
+        ddsktx_reader io = { ddsktx__mem_read, ddsktx__mem_size, &blob };
+        if (blob.buff && blob.size > 0) {
+            results[i] = ddsktx__parse(&infos[i], &io, blob.size, blob.size, NULL);
         } else {
-            int count = sizeof(k__translate_dds_pixel)/sizeof(ddsktx__dds_translate_pixel_format);
-            for (int i = 0; i < count; i++) {
-                const ddsktx__dds_translate_pixel_format* f = &k__translate_dds_pixel[i];
-                if (f->bit_count == header.pixel_format.rgb_bit_count &&
-                    f->flags == header.pixel_format.flags &&
-                    f->bit_mask[0] == header.pixel_format.bit_mask[0] &&
-                    f->bit_mask[1] == header.pixel_format.bit_mask[1] &&
-                    f->bit_mask[2] == header.pixel_format.bit_mask[2] &&
-                    f->bit_mask[3] == header.pixel_format.bit_mask[3])
-                {
-                    format = f->format;
-                    break;
-                }
-            }
-        }
-    } else {
-        int count = sizeof(k__translate_dxgi)/sizeof(ddsktx__dds_translate_fourcc_format);
-        for (int i = 0; i < count; i++) {
-            if (k__translate_dxgi[i].dds_format == dxgi_format) {
-                format = k__translate_dxgi[i].format;
-                srgb = k__translate_dxgi[i].srgb;
-                break;
-            }
+            results[i] = DDSKTX_ERROR_TRUNCATED;
         }
+        num_parsed += results[i] == DDSKTX_OK ? 1 : 0;
     }
+    return num_parsed;
+}
 
-    if (format == _DDSKTX_FORMAT_COUNT) {
-        ddsktx__err(err, "dds: unknown format");
+void ddsktx_metadata_begin(const ddsktx_texture_info* tc, const void* file_data, size_t size,
+                           ddsktx_metadata_iter* iter)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(file_data || size == 0);
+    ddsktx_assert(iter);
+
+    const uint8_t* data = (const uint8_t*)file_data;
+    int64_t start = ddsktx__min(tc->metadata_offset, (int64_t)size);
+    int64_t end = ddsktx__min(tc->metadata_offset + tc->metadata_size, (int64_t)size);
+    iter->ptr = data + start;
+    iter->end = data + end;
+}
+
+bool ddsktx_metadata_next(ddsktx_metadata_iter* iter, ddsktx_metadata* kv)
+{
+    ddsktx_assert(iter);
+    ddsktx_assert(kv);
+
+    // each pair: uint32_t key_and_value_size, key (null-terminated), value, padding to 4 bytes
+    if (iter->end - iter->ptr < (ptrdiff_t)sizeof(uint32_t)) {
+        return false;
     }
 
-    ddsktx_memset(tc, 0x0, sizeof(ddsktx_texture_info));
-    tc->data_offset = r.offset;
-    tc->size_bytes = r.total - r.offset;
-    tc->format = format;
-    tc->width = (int)header.width;
-    tc->height = (int)header.height;
-    tc->depth = ddsktx__max(1, (int)header.depth);
-    tc->num_layers = ddsktx__max(1, (int)array_size);
-    tc->num_mips = (header.caps1 & DDSKTX__DDSCAPS_MIPMAP) ? (int)header.mip_count : 1;
-    tc->bpp = k__block_info[format].bpp;
-    if (has_alpha || k__formats_info[format].has_alpha)
-        tc->flags |= DDSKTX_TEXTURE_FLAG_ALPHA;
-    if (cubemap)
-        tc->flags |= DDSKTX_TEXTURE_FLAG_CUBEMAP;
-    if (volume)
-        tc->flags |= DDSKTX_TEXTURE_FLAG_VOLUME;
-    if (srgb) 
-        tc->flags |= DDSKTX_TEXTURE_FLAG_SRGB;
-    tc->flags |= DDSKTX_TEXTURE_FLAG_DDS;
+    uint32_t kv_size;
+    ddsktx_memcpy(&kv_size, iter->ptr, sizeof(kv_size));
+    const uint8_t* key = iter->ptr + sizeof(uint32_t);
+    if (kv_size > (uint64_t)(iter->end - key)) {
+        iter->ptr = iter->end;
+        return false;
+    }
 
+    const uint8_t* key_end = key;
+    while (key_end < key + kv_size && *key_end != 0) {
+        ++key_end;
+    }
+    if (key_end == key + kv_size) {
+        iter->ptr = iter->end;
+        return false;
+    }
+
+    kv->key = (const char*)key;
+    kv->value = key_end + 1;
+    kv->value_size = (int)(kv_size - (uint32_t)(key_end + 1 - key));
+
+    int64_t next = ddsktx__align_mask((int64_t)sizeof(uint32_t) + kv_size, 3);
+    iter->ptr = next < iter->end - iter->ptr ? iter->ptr + next : iter->end;
     return true;
-}   
+}
 
-void ddsktx_get_sub(const ddsktx_texture_info* tc, ddsktx_sub_data* sub_data, 
-                 const void* file_data, int size,
-                 int array_idx, int slice_face_idx, int mip_idx)
+bool ddsktx_metadata_find(const ddsktx_texture_info* tc, const void* file_data, size_t size,
+                          const char* key, ddsktx_metadata* kv)
 {
-    ddsktx_assert(tc);
-    ddsktx_assert(sub_data);
-    ddsktx_assert(file_data);
-    ddsktx_assert(size > 0);
-    ddsktx_assert(array_idx < tc->num_layers);
-    ddsktx_assert(!((tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= DDSKTX_CUBE_FACE_COUNT)) && "invalid cube-face index");
-    ddsktx_assert(!(!(tc->flags&DDSKTX_TEXTURE_FLAG_CUBEMAP) && (slice_face_idx >= tc->depth)) && "invalid depth-slice index");
-    ddsktx_assert(mip_idx < tc->num_mips);
+    ddsktx_assert(key);
 
-    ddsktx__mem_reader r = { (uint8_t*)file_data, size, tc->data_offset };
-    ddsktx_format format = tc->format;
+    ddsktx_metadata_iter iter;
+    ddsktx_metadata_begin(tc, file_data, size, &iter);
+    while (ddsktx_metadata_next(&iter, kv)) {
+        const char* a = kv->key;
+        const char* b = key;
+        while (*a && *a == *b) {
+            ++a;
+            ++b;
+        }
+        if (*a == *b) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    ddsktx_assert(format < _DDSKTX_FORMAT_COUNT && format != _DDSKTX_FORMAT_COMPRESSED);
-    const ddsktx__block_info* binfo = &k__block_info[format];
-    const int bpp          = binfo->bpp;
-    const int block_size   = binfo->block_size;
-    const int min_block_x  = binfo->min_block_x;
-    const int min_block_y  = binfo->min_block_y;
+#ifndef DDSKTX_WRITE_BATCH
+#   define DDSKTX_WRITE_BATCH 32
+#endif
 
-    int num_faces;
+// collects the output buffers and passes them to the user callback in batches
+typedef struct ddsktx__writer
+{
+    ddsktx_write_cb*    write_cb;
+    void*               user;
+    ddsktx_write_buffer buffs[DDSKTX_WRITE_BATCH];
+    uint32_t            values[DDSKTX_WRITE_BATCH];     // storage for imageSize fields of KTX
+    int                 num_buffs;
+    int                 num_values;
+    bool                failed;
+} ddsktx__writer;
 
-    ddsktx_assert(!((tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) && tc->depth > 1) && "textures must be either Cube or 3D");
-    int slice_idx, face_idx, num_slices;
-    if (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) {
-        slice_idx = 0;
-        face_idx = slice_face_idx;
-        num_faces = DDSKTX_CUBE_FACE_COUNT;
-        num_slices = 1;
-    } else {
-        slice_idx = slice_face_idx;
-        face_idx = 0;
-        num_faces = 1;
-        num_slices = tc->depth;
-    }    
+static const uint8_t k__zeros[4] = { 0, 0, 0, 0 };
 
-    if (tc->flags & DDSKTX_TEXTURE_FLAG_DDS) {
-        for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
-            for (int face = 0; face < num_faces; face++) {
-                int width = tc->width;
-                int height = tc->height;
+static void ddsktx__write_flush(ddsktx__writer* w)
+{
+    if (w->num_buffs > 0 && !w->failed) {
+        w->failed = !w->write_cb(w->buffs, w->num_buffs, w->user);
+    }
+    w->num_buffs = 0;
+    w->num_values = 0;
+}
 
-                for (int mip = 0, mip_count = tc->num_mips; mip < mip_count; mip++) {
-                    int row_bytes, mip_size;
-                    
-                    if (format < _DDSKTX_FORMAT_COMPRESSED) {
-                        int num_blocks_wide = width > 0 ? ddsktx__max(1, (width + 3)/4) : 0;
-                        num_blocks_wide = ddsktx__max(min_block_x, num_blocks_wide);
-
-                        int num_blocks_high = height > 0 ? ddsktx__max(1, (height + 3)/4) : 0;
-                        num_blocks_high = ddsktx__max(min_block_y, num_blocks_high);
-
-                        row_bytes = num_blocks_wide * block_size;
-                        mip_size = row_bytes * num_blocks_high;
-                    } else {
-                        row_bytes = (width*bpp + 7)/8;  // round to nearest byte
-                        mip_size = row_bytes * height;
-                    }
-                   
-                    for (int slice = 0; slice < num_slices; slice++) {
-                        if (layer == array_idx && mip == mip_idx && 
-                            slice == slice_idx && face_idx == face) 
-                        {
-                            sub_data->buff = r.buff + r.offset;
-                            sub_data->width = width;
-                            sub_data->height = height;
-                            sub_data->size_bytes = mip_size;
-                            sub_data->row_pitch_bytes = row_bytes;
-                            return;
-                        }
+// 'data' must stay valid until the next flush
+static inline void ddsktx__write(ddsktx__writer* w, const void* data, int64_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    if (w->num_buffs == DDSKTX_WRITE_BATCH) {
+        ddsktx__write_flush(w);
+    }
+    w->buffs[w->num_buffs].data = data;
+    w->buffs[w->num_buffs].size = size;
+    ++w->num_buffs;
+}
 
-                        r.offset += mip_size;
-                        ddsktx_assert(r.offset <= r.total && "texture buffer overflow");
-                    } // foreach slice
+static inline void ddsktx__write_u32(ddsktx__writer* w, uint32_t value)
+{
+    if (w->num_values == DDSKTX_WRITE_BATCH || w->num_buffs == DDSKTX_WRITE_BATCH) {
+        ddsktx__write_flush(w);
+    }
+    uint32_t* v = &w->values[w->num_values++];
+    *v = value;
+    ddsktx__write(w, v, sizeof(uint32_t));
+}
 
-                    width >>= 1;
-                    height >>= 1;
+static bool ddsktx__write_validate(const ddsktx_texture_info* tc, const void* const* subs, ddsktx_error* err)
+{
+    ddsktx_assert(tc);
+    ddsktx_assert(subs);
 
-                    if (width == 0) {
-                        width = 1;
-                    }
-                    if (height == 0) {
-                        height = 1;
-                    }
-                }   // foreach mip
-            }   // foreach face
-        } // foreach array-item
-    } else if (tc->flags & DDSKTX_TEXTURE_FLAG_KTX) {
-        int width = tc->width;
-        int height = tc->height;
+    if (tc->format >= _DDSKTX_FORMAT_COUNT || tc->format == _DDSKTX_FORMAT_COMPRESSED) {
+        ddsktx__err(err, "write: invalid format");
+    }
+    if (tc->width <= 0 || tc->height <= 0 || tc->depth <= 0 || tc->num_layers <= 0 || tc->num_mips <= 0) {
+        ddsktx__err(err, "write: invalid dimensions");
+    }
+    if ((tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) && tc->depth > 1) {
+        ddsktx__err(err, "write: textures must be either Cube or 3D");
+    }
+    for (int i = 0, c = ddsktx_num_subresources(tc); i < c; i++) {
+        if (!subs[i]) {
+            ddsktx__err(err, "write: missing sub-image data");
+        }
+    }
+    return true;
+}
 
-        for (int mip = 0, c = tc->num_mips; mip < c; mip++) {
-            int row_bytes, mip_size;
+bool ddsktx_write_dds(const ddsktx_texture_info* tc, const void* const* subs, 
+                      ddsktx_write_cb* write_cb, void* user, ddsktx_error* err)
+{
+    ddsktx_assert(write_cb);
+
+    if (!ddsktx__write_validate(tc, subs, err)) {
+        return false;
+    }
+
+    ddsktx_format format = tc->format;
+    bool srgb = (tc->flags & DDSKTX_TEXTURE_FLAG_SRGB) != 0;
+    bool cubemap = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0;
+    bool volume = tc->depth > 1;
+
+    // prefer DX10 header, if the format doesn't have a DXGI code, fallback to FourCC or pixel masks
+    uint32_t dxgi_format = 0;
+    int count = sizeof(k__translate_dxgi)/sizeof(ddsktx__dds_translate_fourcc_format);
+    for (int i = 0; i < count; i++) {
+        if (k__translate_dxgi[i].format == format && k__translate_dxgi[i].srgb == srgb) {
+            dxgi_format = k__translate_dxgi[i].dds_format;
+            break;
+        }
+    }
+
+    if (srgb && dxgi_format == 0) {
+        ddsktx__err(err, "dds: format does not have an sRGB variant");
+    }
+    if (format == DDSKTX_FORMAT_BC6H && !(tc->flags & DDSKTX_TEXTURE_FLAG_SIGNED)) {
+        dxgi_format = DDSKTX__DDS_FORMAT_BC6H_UF16;
+    }
 
-            if (format < _DDSKTX_FORMAT_COMPRESSED) {
-                int num_blocks_wide = width > 0 ? ddsktx__max(1, (width + 3)/4) : 0;
-                num_blocks_wide = ddsktx__max(min_block_x, num_blocks_wide);
+    ddsktx__dds_header header;
+    ddsktx_memset(&header, 0x0, sizeof(header));
+    header.pixel_format.size = sizeof(ddsktx__dds_pixel_format);
 
-                int num_blocks_high = height > 0 ? ddsktx__max(1, (height + 3)/4) : 0;
-                num_blocks_high = ddsktx__max(min_block_y, num_blocks_high);
+    if (dxgi_format != 0) {
+        header.pixel_format.flags = DDSKTX__DDPF_FOURCC;
+        header.pixel_format.fourcc = DDSKTX__DDS_DX10;
+    } else {
+        if (tc->num_layers > 1) {
+            ddsktx__err(err, "dds: format cannot be written as texture array");
+        }
 
-                row_bytes = num_blocks_wide * block_size;
-                mip_size = row_bytes * num_blocks_high;
+        if (format < _DDSKTX_FORMAT_COMPRESSED) {
+            // legacy table also contains uncompressed D3DFORMAT codes, only look for compressed ones
+            count = sizeof(k__translate_dds_fourcc)/sizeof(ddsktx__dds_translate_fourcc_format);
+            for (int i = 0; i < count; i++) {
+                if (k__translate_dds_fourcc[i].format == format) {
+                    header.pixel_format.flags = DDSKTX__DDPF_FOURCC;
+                    header.pixel_format.fourcc = k__translate_dds_fourcc[i].dds_format;
+                    break;
+                }
             }
-            else {
-                row_bytes = (width*bpp + 7)/8;  // round to nearest byte
-                mip_size = row_bytes * height;
+        } else {
+            // sub-images are in RGBA order, so pick the masks that start with red
+            count = sizeof(k__translate_dds_pixel)/sizeof(ddsktx__dds_translate_pixel_format);
+            for (int i = 0; i < count; i++) {
+                const ddsktx__dds_translate_pixel_format* f = &k__translate_dds_pixel[i];
+                if (f->format == format && (f->bit_mask[0] & 0x1)) {
+                    header.pixel_format.flags = f->flags;
+                    header.pixel_format.rgb_bit_count = f->bit_count;
+                    ddsktx_memcpy(header.pixel_format.bit_mask, f->bit_mask, sizeof(f->bit_mask));
+                    break;
+                }
             }
+        }
 
-            int image_size;
-            ddsktx__read(&r, &image_size, sizeof(image_size)); 
-            ddsktx_assert(image_size == (mip_size*num_faces*num_slices) && "image size mismatch");
+        if (header.pixel_format.flags == 0) {
+            ddsktx__err(err, "dds: format is not supported by the writer");
+        }
+    }
 
-            for (int layer = 0, num_layers = tc->num_layers; layer < num_layers; layer++) {
-                for (int face = 0; face < num_faces; face++) {
-                    for (int slice = 0; slice < num_slices; slice++) {
-                        if (layer == array_idx && mip == mip_idx &&
-                            slice == slice_idx && face_idx == face) 
-                        {
-                            sub_data->buff = r.buff + r.offset;
-                            sub_data->width = width;
-                            sub_data->height = height;
-                            sub_data->size_bytes = mip_size;
-                            sub_data->row_pitch_bytes = row_bytes;
-                            return;
-                        }
+    int row_bytes;
+    int64_t mip_size;
+    ddsktx__calc_mip(format, tc->width, tc->height, &row_bytes, &mip_size);
 
-                        r.offset += mip_size;
-                        ddsktx_assert(r.offset <= r.total && "texture buffer overflow");
-                    }   // foreach slice
+    header.size = DDSKTX__DDS_HEADER_SIZE;
+    header.flags = DDSKTX__DDSD_CAPS | DDSKTX__DDSD_HEIGHT | DDSKTX__DDSD_WIDTH | DDSKTX__DDSD_PIXELFORMAT;
+    header.flags |= tc->num_mips > 1 ? DDSKTX__DDSD_MIPMAPCOUNT : 0;
+    header.flags |= volume ? DDSKTX__DDSD_DEPTH : 0;
+    header.flags |= ddsktx_format_compressed(format) ? DDSKTX__DDSD_LINEARSIZE : DDSKTX__DDSD_PITCH;
+    header.width = (uint32_t)tc->width;
+    header.height = (uint32_t)tc->height;
+    header.pitch_lin_size = ddsktx_format_compressed(format) ? (uint32_t)mip_size : (uint32_t)row_bytes;
+    header.depth = volume ? (uint32_t)tc->depth : 0;
+    header.mip_count = (uint32_t)tc->num_mips;
+    header.caps1 = DDSKTX__DDSCAPS_TEXTURE;
+    header.caps1 |= tc->num_mips > 1 ? (DDSKTX__DDSCAPS_MIPMAP | DDSKTX__DDSCAPS_COMPLEX) : 0;
+    header.caps1 |= (cubemap || volume || tc->num_layers > 1) ? DDSKTX__DDSCAPS_COMPLEX : 0;
+    header.caps2 = cubemap ? (DDSKTX__DDSCAPS2_CUBEMAP | DDSKTX__DDSCAPS2_CUBEMAP_ALLSIDES) : 0;
+    header.caps2 |= volume ? DDSKTX__DDSCAPS2_VOLUME : 0;
 
-                    
-                    r.offset = ddsktx__align_mask(r.offset, 3); // cube-padding
-                }   // foreach face
-            }   // foreach array-item
+    ddsktx__dds_header_dxgi dxgi_header;
+    ddsktx_memset(&dxgi_header, 0x0, sizeof(dxgi_header));
+    dxgi_header.dxgi_format = dxgi_format;
+    dxgi_header.dimension = volume ? DDSKTX__DDS_DX10_DIMENSION_TEXTURE3D : DDSKTX__DDS_DX10_DIMENSION_TEXTURE2D;
+    dxgi_header.misc_flags = cubemap ? DDSKTX__DDS_DX10_MISC_TEXTURECUBE : 0;
+    dxgi_header.array_size = (uint32_t)tc->num_layers;
 
-            width >>= 1;
-            height >>= 1;
+    static const uint32_t dds_magic = DDSKTX__DDS_MAGIC;
+    ddsktx__writer w;
+    ddsktx_memset(&w, 0x0, sizeof(w));
+    w.write_cb = write_cb;
+    w.user = user;
+    ddsktx__write(&w, &dds_magic, sizeof(dds_magic));
+    ddsktx__write(&w, &header, sizeof(header));
+    if (dxgi_format != 0) {
+        ddsktx__write(&w, &dxgi_header, sizeof(dxgi_header));
+    }
 
-            if (width == 0) {
-                width = 1;
-            }
-            if (height == 0) {
-                height = 1;
+    // DDS order is the same as subresource order: layer -> face -> mip -> slice
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    const void* const* sub = subs;
+    for (int layer = 0; layer < tc->num_layers; layer++) {
+        for (int face = 0; face < num_faces; face++) {
+            int width = tc->width;
+            int height = tc->height;
+
+            for (int mip = 0; mip < tc->num_mips; mip++) {
+                ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+                for (int slice = 0; slice < num_slices; slice++) {
+                    ddsktx__write(&w, *sub++, mip_size);
+                }
+
+                width = ddsktx__max(1, width >> 1);
+                height = ddsktx__max(1, height >> 1);
             }
-            
-            r.offset = ddsktx__align_mask(r.offset, 3); // mip-padding
-        }   // foreach mip     
-    } else {
-        ddsktx_assert(0 && "invalid file format");
+        }
+    }
+    ddsktx__write_flush(&w);
+
+    if (w.failed) {
+        ddsktx__err(err, "dds: write failed");
     }
+    return true;
 }
 
-bool ddsktx_parse(ddsktx_texture_info* tc, const void* file_data, int size, ddsktx_error* err)
+bool ddsktx_write_ktx(const ddsktx_texture_info* tc, const void* const* subs, 
+                      ddsktx_write_cb* write_cb, void* user, ddsktx_error* err)
 {
-    ddsktx_assert(tc);
-    ddsktx_assert(file_data);
-    ddsktx_assert(size > 0);
+    static const uint8_t ktx__id[] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
 
-    ddsktx__mem_reader r = {(const uint8_t*)file_data, size, 0};
-    
-    // Read file flag and determine the file type
-    uint32_t file_flag = 0;
-    if (ddsktx__read(&r, &file_flag, sizeof(file_flag)) != sizeof(file_flag)) {
-        ddsktx__err(err, "invalid texture file");
+    ddsktx_assert(write_cb);
+
+    if (!ddsktx__write_validate(tc, subs, err)) {
+        return false;
     }
 
-    switch (file_flag) {
-    case DDSKTX__DDS_MAGIC:
-        return ddsktx__parse_dds(tc, file_data, size, err);
-    case DDSKTX__KTX_MAGIC:
-        return ddsktx__parse_ktx(tc, file_data, size, err);
+    ddsktx_format format = tc->format;
+    const ddsktx__ktx_format_info* ktx_fmt = &k__translate_ktx_fmt[format];
+    bool srgb = (tc->flags & DDSKTX_TEXTURE_FLAG_SRGB) != 0;
+    bool compressed = ddsktx_format_compressed(format);
+    bool cubemap = (tc->flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0;
+
+    if (ktx_fmt->internal_fmt == DDSKTX__KTX_ZERO) {
+        ddsktx__err(err, "ktx: format is not supported by the writer");
+    }
+    uint32_t internal_fmt_srgb = ddsktx__ktx_srgb_internal_fmt(format);
+    if (srgb && internal_fmt_srgb == DDSKTX__KTX_ZERO) {
+        ddsktx__err(err, "ktx: format does not have an sRGB variant");
+    }
+
+    uint32_t type_size = 1;
+    switch (ktx_fmt->type) {
+    case DDSKTX__KTX_SHORT:
+    case DDSKTX__KTX_UNSIGNED_SHORT:
+    case DDSKTX__KTX_HALF_FLOAT:
+        type_size = 2;
+        break;
+    case DDSKTX__KTX_INT:
+    case DDSKTX__KTX_UNSIGNED_INT:
+    case DDSKTX__KTX_FLOAT:
+    case DDSKTX__KTX_UNSIGNED_INT_2_10_10_10_REV:
+    case DDSKTX__KTX_UNSIGNED_INT_10F_11F_11F_REV:
+        type_size = 4;
+        break;
     default:
-        ddsktx__err(err, "unknown texture format");
+        break;
     }
+
+    ddsktx__ktx_header header;
+    ddsktx_memcpy(header.id, ktx__id + 4, sizeof(header.id));
+    header.endianess = 0x04030201;
+    header.type = compressed ? 0 : ktx_fmt->type;
+    header.type_size = type_size;
+    header.format = compressed ? 0 : ktx_fmt->fmt;
+    header.internal_format = srgb ? internal_fmt_srgb : ktx_fmt->internal_fmt;
+    if (format == DDSKTX_FORMAT_BC6H && !(tc->flags & DDSKTX_TEXTURE_FLAG_SIGNED)) {
+        header.internal_format = DDSKTX__KTX_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB;
+    }
+    header.base_internal_format = compressed ? 
+        (k__formats_info[format].has_alpha ? DDSKTX__KTX_RGBA : DDSKTX__KTX_RGB) : ktx_fmt->fmt;
+    header.width = (uint32_t)tc->width;
+    header.height = (uint32_t)tc->height;
+    header.depth = tc->depth > 1 ? (uint32_t)tc->depth : 0;
+    header.array_count = tc->num_layers > 1 ? (uint32_t)tc->num_layers : 0;
+    header.face_count = cubemap ? DDSKTX_CUBE_FACE_COUNT : 1;
+    header.mip_count = (uint32_t)tc->num_mips;
+    header.metadata_size = 0;
+
+    ddsktx__writer w;
+    ddsktx_memset(&w, 0x0, sizeof(w));
+    w.write_cb = write_cb;
+    w.user = user;
+    ddsktx__write(&w, ktx__id, 4);
+    ddsktx__write(&w, &header, sizeof(header));
+
+    // KTX order: mip -> layer -> face -> slice, each mip starts with imageSize
+    int num_faces, num_slices;
+    ddsktx__faces_slices(tc, &num_faces, &num_slices);
+    const int num_mips = tc->num_mips;
+    int64_t offset = (int64_t)sizeof(uint32_t) + DDSKTX__KTX_HEADER_SIZE;    // magic + header written above
+    int width = tc->width;
+    int height = tc->height;
+    for (int mip = 0; mip < num_mips; mip++) {
+        int row_bytes;
+        int64_t mip_size;
+        ddsktx__calc_mip(format, width, height, &row_bytes, &mip_size);
+
+        int64_t image_size = (num_faces > 1 && tc->num_layers == 1) ? mip_size :
+                             (mip_size * tc->num_layers * num_faces * num_slices);
+        if (image_size > UINT32_MAX) {
+            ddsktx__err(err, "ktx: mip size is too large");
+        }
+        ddsktx__write_u32(&w, (uint32_t)image_size);
+        offset += (int64_t)sizeof(uint32_t);
+
+        for (int layer = 0; layer < tc->num_layers; layer++) {
+            for (int face = 0; face < num_faces; face++) {
+                const void* const* sub = &subs[((layer*num_faces + face)*num_mips + mip)*num_slices];
+                for (int slice = 0; slice < num_slices; slice++) {
+                    ddsktx__write(&w, sub[slice], mip_size);
+                    offset += mip_size;
+                }
+
+                int64_t aligned = ddsktx__align_mask(offset, 3);  // cube-padding
+                ddsktx__write(&w, k__zeros, aligned - offset);
+                offset = aligned;
+            }
+        }
+
+        int64_t aligned = ddsktx__align_mask(offset, 3);  // mip-padding
+        ddsktx__write(&w, k__zeros, aligned - offset);
+        offset = aligned;
+
+        width = ddsktx__max(1, width >> 1);
+        height = ddsktx__max(1, height >> 1);
+    }
+    ddsktx__write_flush(&w);
+
+    if (w.failed) {
+        ddsktx__err(err, "ktx: write failed");
+    }
+    return true;
+}
+
+const char* ddsktx_error_str(ddsktx_result result)
+{
+    static const char* k__result_str[] = {
+        "ok",
+        "file is truncated",
+        "unknown texture file, must be dds, ktx or ktx2",
+        "invalid file header",
+        "unsupported format",
+        "unsupported feature (big-endian, BasisLZ or unknown supercompression)",
+        "invalid cubemap (incomplete, or also a 3D texture)",
+        "invalid metadata size",
+        "invalid texture layout (ktx2 level index or ktx image size)"
+    };
+    ddsktx_assert(sizeof(k__result_str)/sizeof(const char*) == _DDSKTX_RESULT_COUNT);
+    return result >= DDSKTX_OK && result < _DDSKTX_RESULT_COUNT ? k__result_str[result] : "unknown error";
 }
 
 const char* ddsktx_format_str(ddsktx_format format)
@@ -1267,5 +5821,31 @@ bool ddsktx_format_compressed(ddsktx_format format)
     return format < _DDSKTX_FORMAT_COMPRESSED;
 }
 
+int64_t ddsktx_calc_mip_size(ddsktx_format format, int width, int height, int mip_idx, int* row_bytes)
+{
+    ddsktx_assert(format >= 0 && format < _DDSKTX_FORMAT_COUNT);
+    ddsktx_assert(mip_idx >= 0 && mip_idx < 32);
+
+    int mip_row_bytes;
+    int64_t mip_size;
+    ddsktx__calc_mip(format, ddsktx__max(1, width >> mip_idx), ddsktx__max(1, height >> mip_idx), 
+                     &mip_row_bytes, &mip_size);
+    if (row_bytes) {
+        *row_bytes = mip_row_bytes;
+    }
+    return mip_size;
+}
+
+#ifdef DDSKTX_PROFILE_COUNTERS
+ddsktx_profile_counters ddsktx_get_profile_counters(bool reset)
+{
+    ddsktx_profile_counters counters = ddsktx__counters;
+    if (reset) {
+        ddsktx_memset(&ddsktx__counters, 0x0, sizeof(ddsktx__counters));
+    }
+    return counters;
+}
+#endif
+
 #endif  // DDSKTX_IMPLEMENT
 
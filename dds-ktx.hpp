@@ -0,0 +1,363 @@
+//
+// Copyright 2018 Sepehr Taghdisian (septag@github). All rights reserved.
+// License: https://github.com/septag/dds-ktx#license-bsd-2-clause
+//
+// dds-ktx.hpp - Optional C++17 wrapper for dds-ktx.h
+//      Header only, the C functions still need DDSKTX_IMPLEMENT in one source file
+//      Failures are returned as bool/ddsktx_error like the C API, parse() reports a failed table
+//      allocation the same way. Copying a texture_view copies its table and can throw std::bad_alloc
+//
+//      ddsktx::span<T>
+//          std::span in C++20, a minimal replacement (data, size, begin/end, operator[]) in C++17
+//
+//      ddsktx::texture_view
+//          Non-owning view of a parsed texture file: binds the file data once, so the calls don't take
+//          file_data/size again, and keeps the subresource table (ddsktx_build_subresource_table), so every
+//          sub-image lookup is O(1) instead of walking the file
+//
+//          bool parse(const void* file_data, size_t size, ddsktx_error* err = nullptr);
+//              Parses with ddsktx_parse_strict and builds the subresource table (the only allocation)
+//              file_data must stay valid while the view is used
+//
+//          void bind(const ddsktx_texture_info& info, const void* file_data, size_t size, const ddsktx_sub_entry* table);
+//              Uses an existing table instead (for example ddsktx_pack_sub_table), nothing is parsed or allocated
+//              info must be validated (ddsktx_parse_strict or ddsktx_pack_texture_info)
+//
+//          subresource sub(int array_idx, int slice_face_idx, int mip_idx) const;
+//              Same as ddsktx_get_sub, the indices are the same too
+//
+//          subresource_range subresources() const;
+//              All sub-images for range-based for, in table order: for each layer, face, mip, slice
+//
+//          info(), format(), width(), height(), depth(), num_layers(), num_mips(), num_faces(), cubemap(), data()
+//
+//      ddsktx::subresource
+//          One sub-image: indices, dimensions, row pitch, file offset and 'data' as span<const std::byte>
+//          'data' is empty for supercompressed KTX2 files, the offset is relative to the decoded level then
+//          (see ddsktx_decode_level). sub_data() converts it back to ddsktx_sub_data for the C functions
+//
+//      ddsktx::format_traits<F>
+//          Compile-time traits of format F, from the same tables as the C++11 constexpr API in dds-ktx.h:
+//          bpp, block_width, block_height, block_size, min_blocks_x, min_blocks_y, r_bits, g_bits, b_bits, a_bits,
+//          has_alpha, compressed, is_float, name. It's also std::integral_constant<ddsktx_format, F>
+//
+//      decltype(auto) ddsktx::visit_format(ddsktx_format format, Fn&& fn);
+//          Calls fn(format_traits<F>{}) for the runtime format through a jump table, so format branches inside fn
+//          are resolved at compile time (if constexpr), for every format that the function is instantiated with
+//
+//      Example:
+//          #include "dds-ktx.hpp"
+//
+//          ddsktx::texture_view tex;
+//          if (tex.parse(file.data, file.size)) {
+//              for (const ddsktx::subresource& sub : tex.subresources()) {
+//                  upload(sub.layer, sub.face, sub.mip, sub.slice, sub.data.data(), sub.data.size(), sub.row_pitch_bytes);
+//              }
+//              int64_t bytes = ddsktx::visit_format(tex.format(), [&](auto fmt) -> int64_t {
+//                  using traits = decltype(fmt);
+//                  if constexpr (traits::compressed) {
+//                      return (int64_t)((tex.width() + traits::block_width - 1) / traits::block_width) * traits::block_size;
+//                  } else {
+//                      return (int64_t)tex.width() * traits::bpp / 8;
+//                  }
+//              });
+//          }
+//
+#pragma once
+
+#if !(__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#   error "dds-ktx.hpp requires C++17"
+#else
+
+#include "dds-ktx.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+#   if __has_include(<version>)
+#       include <version>
+#   endif
+#endif
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+#   include <span>
+#endif
+
+namespace ddsktx {
+
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+    template <typename T> using span = std::span<T>;
+#else
+    template <typename T>
+    class span
+    {
+    public:
+        constexpr span() = default;
+        constexpr span(T* data, size_t size) : m_data(data), m_size(size) {}
+
+        constexpr T*     data() const               { return m_data; }
+        constexpr size_t size() const               { return m_size; }
+        constexpr size_t size_bytes() const         { return m_size * sizeof(T); }
+        constexpr bool   empty() const              { return m_size == 0; }
+        constexpr T*     begin() const              { return m_data; }
+        constexpr T*     end() const                { return m_data + m_size; }
+        constexpr T&     operator[](size_t i) const { return m_data[i]; }
+
+    private:
+        T*     m_data = nullptr;
+        size_t m_size = 0;
+    };
+#endif
+
+    template <ddsktx_format F>
+    struct format_traits : std::integral_constant<ddsktx_format, F>
+    {
+        static_assert(F < _DDSKTX_FORMAT_COUNT, "invalid format");
+
+        static constexpr int  bpp           = k__block_info[F].bpp;
+        static constexpr int  block_width   = k__block_info[F].block_width;
+        static constexpr int  block_height  = k__block_info[F].block_height;
+        static constexpr int  block_size    = k__block_info[F].block_size;
+        static constexpr int  min_blocks_x  = k__block_info[F].min_block_x;
+        static constexpr int  min_blocks_y  = k__block_info[F].min_block_y;
+        static constexpr int  r_bits        = k__block_info[F].r_bits;
+        static constexpr int  g_bits        = k__block_info[F].g_bits;
+        static constexpr int  b_bits        = k__block_info[F].b_bits;
+        static constexpr int  a_bits        = k__block_info[F].a_bits;
+        static constexpr bool has_alpha     = k__formats_info[F].has_alpha;
+        static constexpr bool compressed    = F < _DDSKTX_FORMAT_COMPRESSED;
+        static constexpr bool is_float      = k__block_info[F].encoding == DDSKTX__ENCODE_FLOAT;
+        static constexpr const char* name   = k__formats_info[F].name;
+    };
+
+    namespace detail {
+        template <typename Fn, int... I>
+        decltype(auto) visit_format(ddsktx_format format, Fn& fn, std::integer_sequence<int, I...>)
+        {
+            using result = decltype(fn(format_traits<(ddsktx_format)0>{}));
+            using thunk = result (*)(Fn&);
+            static constexpr thunk k_table[] = {
+                [](Fn& f) -> result { return f(format_traits<(ddsktx_format)I>{}); }...
+            };
+            return k_table[format](fn);
+        }
+    }
+
+    template <typename Fn>
+    decltype(auto) visit_format(ddsktx_format format, Fn&& fn)
+    {
+        assert(format >= 0 && format < _DDSKTX_FORMAT_COUNT);
+        return detail::visit_format(format, fn, std::make_integer_sequence<int, _DDSKTX_FORMAT_COUNT>{});
+    }
+
+    struct subresource
+    {
+        int                     layer;
+        int                     face;       // cube-face, 0 if the texture is not a cubemap
+        int                     mip;
+        int                     slice;      // depth slice, 0 if the texture is not 3D
+        int                     width;
+        int                     height;
+        int                     row_pitch_bytes;
+        int64_t                 offset;     // from the start of the file data (decoded level for supercompressed)
+        span<const std::byte>   data;
+
+        ddsktx_sub_data sub_data() const
+        {
+            ddsktx_sub_data sub;
+            sub.buff = data.data();
+            sub.width = width;
+            sub.height = height;
+            sub.size_bytes = (int64_t)data.size();
+            sub.row_pitch_bytes = row_pitch_bytes;
+            return sub;
+        }
+    };
+
+    class texture_view;
+
+    // iterates the subresource table in order, the indices are decomposed from the table index
+    class subresource_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = subresource;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const subresource*;
+        using reference         = subresource;
+
+        subresource_iterator() = default;
+        subresource_iterator(const texture_view* view, int index) : m_view(view), m_index(index) {}
+
+        inline subresource operator*() const;
+        subresource_iterator& operator++()                      { ++m_index; return *this; }
+        subresource_iterator  operator++(int)                   { subresource_iterator it = *this; ++m_index; return it; }
+        bool operator==(const subresource_iterator& it) const   { return m_index == it.m_index; }
+        bool operator!=(const subresource_iterator& it) const   { return m_index != it.m_index; }
+
+    private:
+        const texture_view* m_view = nullptr;
+        int                 m_index = 0;
+    };
+
+    class subresource_range
+    {
+    public:
+        subresource_range(const texture_view* view, int count) : m_view(view), m_count(count) {}
+
+        subresource_iterator begin() const  { return subresource_iterator(m_view, 0); }
+        subresource_iterator end() const    { return subresource_iterator(m_view, m_count); }
+        int  size() const                   { return m_count; }
+        bool empty() const                  { return m_count == 0; }
+
+    private:
+        const texture_view* m_view;
+        int                 m_count;
+    };
+
+    class texture_view
+    {
+    public:
+        texture_view() = default;
+
+        // the table can point to m_own_table, copies have to point to their own
+        texture_view(const texture_view& other)             { *this = other; }
+        texture_view(texture_view&& other) noexcept         { *this = std::move(other); }
+        texture_view& operator=(const texture_view& other)
+        {
+            if (this != &other) {
+                m_info = other.m_info;
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_own_table = other.m_own_table;
+                m_table = other.m_table == other.m_own_table.data() ? m_own_table.data() : other.m_table;
+            }
+            return *this;
+        }
+        texture_view& operator=(texture_view&& other) noexcept
+        {
+            if (this != &other) {
+                bool own = other.m_table == other.m_own_table.data();
+                m_info = other.m_info;
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_own_table = std::move(other.m_own_table);
+                m_table = own ? m_own_table.data() : other.m_table;
+                other.m_table = nullptr;
+            }
+            return *this;
+        }
+
+        bool parse(const void* file_data, size_t size, ddsktx_error* err = nullptr)
+        {
+            m_table = nullptr;
+            if (!ddsktx_parse_strict(&m_info, file_data, size, err)) {
+                return false;
+            }
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            try {
+                m_own_table.resize((size_t)ddsktx_num_subresources(&m_info));
+            } catch (const std::bad_alloc&) {
+                if (err) {
+                    std::snprintf(err->msg, sizeof(err->msg), "out of memory");
+                }
+                return false;
+            }
+#else
+            m_own_table.resize((size_t)ddsktx_num_subresources(&m_info));
+#endif
+            if (!ddsktx_build_subresource_table(&m_info, m_own_table.data(), (int)m_own_table.size())) {
+                if (err) {
+                    std::snprintf(err->msg, sizeof(err->msg), "%s", ddsktx_error_str(DDSKTX_ERROR_INVALID_LAYOUT));
+                }
+                return false;
+            }
+            m_data = (const std::byte*)file_data;
+            m_size = size;
+            m_table = m_own_table.data();
+            return true;
+        }
+
+        void bind(const ddsktx_texture_info& info, const void* file_data, size_t size, const ddsktx_sub_entry* table)
+        {
+            assert(table);
+            assert(info.flags & DDSKTX_TEXTURE_FLAG_VALIDATED);
+            m_info = info;
+            m_data = (const std::byte*)file_data;
+            m_size = size;
+            m_own_table.clear();
+            m_table = table;
+        }
+
+        bool valid() const { return m_table != nullptr; }
+
+        subresource sub(int array_idx, int slice_face_idx, int mip_idx) const
+        {
+            assert(valid());
+            return make_sub(ddsktx_sub_index(&m_info, array_idx, slice_face_idx, mip_idx));
+        }
+
+        subresource_range subresources() const
+        {
+            return subresource_range(this, valid() ? ddsktx_num_subresources(&m_info) : 0);
+        }
+
+        const ddsktx_texture_info& info() const { return m_info; }
+        ddsktx_format format() const            { return m_info.format; }
+        int  width() const                      { return m_info.width; }
+        int  height() const                     { return m_info.height; }
+        int  depth() const                      { return m_info.depth; }
+        int  num_layers() const                 { return m_info.num_layers; }
+        int  num_mips() const                   { return m_info.num_mips; }
+        bool cubemap() const                    { return (m_info.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0; }
+        int  num_faces() const                  { return cubemap() ? DDSKTX_CUBE_FACE_COUNT : 1; }
+        span<const std::byte> data() const      { return span<const std::byte>(m_data, m_size); }
+        const ddsktx_sub_entry* table() const   { return m_table; }
+
+    private:
+        friend class subresource_iterator;
+
+        subresource make_sub(int index) const
+        {
+            // table order: ((layer*num_faces + face)*num_mips + mip)*num_slices + slice
+            const ddsktx_sub_entry& e = m_table[index];
+            const int num_slices = cubemap() ? 1 : m_info.depth;
+            subresource sub;
+            sub.slice = index % num_slices;
+            index /= num_slices;
+            sub.mip = index % m_info.num_mips;
+            index /= m_info.num_mips;
+            sub.face = index % num_faces();
+            sub.layer = index / num_faces();
+            sub.width = e.width;
+            sub.height = e.height;
+            sub.row_pitch_bytes = e.row_pitch_bytes;
+            sub.offset = e.offset;
+            if (m_info.supercompression == DDSKTX_SUPERCOMPRESSION_NONE) {
+                sub.data = span<const std::byte>(m_data + e.offset, (size_t)e.size_bytes);
+            }
+            return sub;
+        }
+
+        ddsktx_texture_info             m_info = {};
+        const std::byte*                m_data = nullptr;
+        size_t                          m_size = 0;
+        const ddsktx_sub_entry*         m_table = nullptr;
+        std::vector<ddsktx_sub_entry>   m_own_table;
+    };
+
+    inline subresource subresource_iterator::operator*() const
+    {
+        return m_view->make_sub(m_index);
+    }
+
+} // namespace ddsktx
+
+#endif // C++17